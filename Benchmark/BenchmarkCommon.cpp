@@ -0,0 +1,34 @@
+#include "BenchmarkCommon.h"
+
+namespace Bench
+{
+	Math::Camera MakeCamera()
+	{
+		Math::Camera camera;
+		camera.SetTransform({ 0.26f, 0.0f, 0.0f }, { 0.0f, 1.9f, -6.49f });
+		camera.SetPerspective(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f);
+		camera.SetViewport(0.0f, 0.0f, 1280.0f, 720.0f);
+		return camera;
+	}
+
+	HeadlessDrawScope::HeadlessDrawScope()
+		: previousBackend_(Math::DebugDraw::GetBackend())
+	{
+		// 前のスコープで溜まった線が混ざらないように先に流しておく
+		Math::DebugDraw::Flush();
+		Math::DebugDraw::SetBackend(&backend_);
+	}
+
+	HeadlessDrawScope::~HeadlessDrawScope()
+	{
+		Math::DebugDraw::Flush();
+		Math::DebugDraw::SetBackend(previousBackend_);
+	}
+
+	size_t HeadlessDrawScope::Flush()
+	{
+		size_t vertexCount = Math::DebugDraw::GetLineCount() * 2;
+		Math::DebugDraw::Flush();
+		return vertexCount;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Camera.h"
+#include "DebugDraw.h"
+
+namespace Bench
+{
+	// main.cppと同じ画面サイズ(1280x720)で、原点付近を斜め上から見るカメラを作る
+	Math::Camera MakeCamera();
+
+	/// <summary>
+	/// 生きている間だけDebugDrawの描画先を記録用のバックエンドに差し替える
+	/// Draw*関数をウィンドウなしで計測するために使う
+	/// </summary>
+	class HeadlessDrawScope final
+	{
+	public:
+		HeadlessDrawScope();
+		~HeadlessDrawScope();
+
+		HeadlessDrawScope(const HeadlessDrawScope&) = delete;
+		HeadlessDrawScope& operator=(const HeadlessDrawScope&) = delete;
+
+		// 溜まった線を流し、流した頂点の数を返す(1フレーム分の終わりに呼ぶ)
+		size_t Flush();
+
+	private:
+		Math::HeadlessDebugDrawBackend backend_;
+		Math::DebugDrawBackend* previousBackend_;
+	};
+}
@@ -0,0 +1,410 @@
+#include "BenchmarkHarness.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <thread>
+#include <utility>
+
+namespace Bench
+{
+	namespace
+	{
+		constexpr double kDefaultMinTime = 0.5;		// 1つの計測で回す最低の秒数
+		constexpr int64_t kMaxIterations = 1000000000;
+
+		struct RunResult final
+		{
+			std::string name;
+			int64_t iterations;
+			double realNanoseconds;	// 1回あたり
+			double cpuNanoseconds;	// 1回あたり
+			double itemsPerSecond;	// SetItemsProcessedを呼んでいなければ0
+			std::vector<State::Counter> counters;	// isRateのものは1秒あたりに直してある
+		};
+
+		std::vector<std::unique_ptr<Benchmark>>& GetRegistry()
+		{
+			static std::vector<std::unique_ptr<Benchmark>> registry;
+			return registry;
+		}
+
+		std::vector<std::pair<std::string, std::string>>& GetCustomContext()
+		{
+			static std::vector<std::pair<std::string, std::string>> context;
+			return context;
+		}
+
+		// 引数を名前に付ける。Google Benchmarkと同じく "名前/引数" の形にする
+		std::string MakeRunName(const std::string& name, const std::vector<int64_t>& args, size_t argIndex)
+		{
+			if (args.empty()) {
+				return name;
+			}
+			return name + "/" + std::to_string(args[argIndex]);
+		}
+
+		RunResult Run(const Benchmark& benchmark, const std::string& runName, int64_t arg, double minTime)
+		{
+			// 回数を増やしながら、minTimeを超えるまで計測し直す
+			int64_t iterations = 1;
+			for (;;) {
+				State state(iterations, arg);
+				benchmark.GetFunction()(state);
+
+				double seconds = state.GetRealSeconds();
+				if (seconds >= minTime || iterations >= kMaxIterations) {
+					RunResult result{};
+					result.name = runName;
+					result.iterations = iterations;
+					result.realNanoseconds = seconds * 1e9 / static_cast<double>(iterations);
+					result.cpuNanoseconds = state.GetCpuSeconds() * 1e9 / static_cast<double>(iterations);
+					// スレッドを使うベンチマークもあるので、1秒あたりの数は経過時間で割る
+					double rateSeconds = (std::max)(seconds, 1e-12);
+					result.itemsPerSecond = static_cast<double>(state.GetItemsProcessed()) / rateSeconds;
+					for (State::Counter counter : state.GetCounters()) {
+						if (counter.isRate) {
+							counter.value /= rateSeconds;
+						}
+						result.counters.push_back(counter);
+					}
+					return result;
+				}
+
+				// 次に必要な回数を見積もる。見積もりが外れても増えすぎないように10倍までにする
+				double multiplier = minTime * 1.4 / (std::max)(seconds, 1e-9);
+				multiplier = (std::min)(multiplier, 10.0);
+				int64_t next = static_cast<int64_t>(static_cast<double>(iterations) * multiplier);
+				iterations = (std::min)((std::max)(next, iterations + 1), kMaxIterations);
+			}
+		}
+
+		std::string EscapeJson(const std::string& text)
+		{
+			std::string result;
+			for (char c : text) {
+				switch (c) {
+				case '"': result += "\\\""; break;
+				case '\\': result += "\\\\"; break;
+				case '\n': result += "\\n"; break;
+				case '\t': result += "\\t"; break;
+				default: result += c; break;
+				}
+			}
+			return result;
+		}
+
+		std::string FormatDouble(double value)
+		{
+			char buffer[64];
+			std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+			return buffer;
+		}
+
+		std::string GetDate()
+		{
+			std::time_t now = std::time(nullptr);
+			std::tm local{};
+#ifdef _WIN32
+			localtime_s(&local, &now);
+#else
+			localtime_r(&now, &local);
+#endif
+			char buffer[64];
+			std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S%z", &local);
+			return buffer;
+		}
+
+		void WriteJson(std::ostream& out, const std::string& executable, const std::vector<RunResult>& results)
+		{
+			out << "{\n";
+			out << "  \"context\": {\n";
+			out << "    \"date\": \"" << GetDate() << "\",\n";
+			out << "    \"executable\": \"" << EscapeJson(executable) << "\",\n";
+			out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+			for (const auto& [key, value] : GetCustomContext()) {
+				out << "    \"" << EscapeJson(key) << "\": \"" << EscapeJson(value) << "\",\n";
+			}
+#ifdef NDEBUG
+			out << "    \"library_build_type\": \"release\"\n";
+#else
+			out << "    \"library_build_type\": \"debug\"\n";
+#endif
+			out << "  },\n";
+			out << "  \"benchmarks\": [\n";
+			for (size_t i = 0; i < results.size(); ++i) {
+				const RunResult& result = results[i];
+				out << "    {\n";
+				out << "      \"name\": \"" << EscapeJson(result.name) << "\",\n";
+				out << "      \"run_name\": \"" << EscapeJson(result.name) << "\",\n";
+				out << "      \"run_type\": \"iteration\",\n";
+				out << "      \"repetitions\": 1,\n";
+				out << "      \"repetition_index\": 0,\n";
+				out << "      \"threads\": 1,\n";
+				out << "      \"iterations\": " << result.iterations << ",\n";
+				out << "      \"real_time\": " << FormatDouble(result.realNanoseconds) << ",\n";
+				out << "      \"cpu_time\": " << FormatDouble(result.cpuNanoseconds) << ",\n";
+				out << "      \"time_unit\": \"ns\"";
+				if (result.itemsPerSecond > 0.0) {
+					out << ",\n      \"items_per_second\": " << FormatDouble(result.itemsPerSecond);
+				}
+				for (const State::Counter& counter : result.counters) {
+					out << ",\n      \"" << EscapeJson(counter.name) << "\": " << FormatDouble(counter.value);
+				}
+				out << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+			}
+			out << "  ]\n";
+			out << "}\n";
+		}
+
+		// 大きな数を読みやすくする (例: 1.25M/s)
+		std::string FormatRate(double value)
+		{
+			const char* units[] = { "", "k", "M", "G", "T" };
+			int unit = 0;
+			while (value >= 1000.0 && unit < 4) {
+				value /= 1000.0;
+				++unit;
+			}
+			char buffer[64];
+			std::snprintf(buffer, sizeof(buffer), "%.4g%s/s", value, units[unit]);
+			return buffer;
+		}
+
+		void PrintConsoleHeader(size_t nameWidth)
+		{
+			std::printf("%-*s %15s %15s %12s\n", static_cast<int>(nameWidth), "Benchmark", "Time", "CPU", "Iterations");
+			std::printf("%s\n", std::string(nameWidth + 45, '-').c_str());
+		}
+
+		void PrintConsoleResult(const RunResult& result, size_t nameWidth)
+		{
+			std::printf("%-*s %12.1f ns %12.1f ns %12lld", static_cast<int>(nameWidth), result.name.c_str(),
+				result.realNanoseconds, result.cpuNanoseconds, static_cast<long long>(result.iterations));
+			if (result.itemsPerSecond > 0.0) {
+				std::printf(" items_per_second=%s", FormatRate(result.itemsPerSecond).c_str());
+			}
+			for (const State::Counter& counter : result.counters) {
+				if (counter.isRate) {
+					std::printf(" %s=%s", counter.name.c_str(), FormatRate(counter.value).c_str());
+				} else {
+					std::printf(" %s=%g", counter.name.c_str(), counter.value);
+				}
+			}
+			std::printf("\n");
+			std::fflush(stdout);
+		}
+
+		// "--name=value" の形ならvalueを返す
+		bool ParseFlag(const char* argument, const char* name, std::string& value)
+		{
+			size_t length = std::strlen(name);
+			if (std::strncmp(argument, name, length) != 0 || argument[length] != '=') {
+				return false;
+			}
+			value = argument + length + 1;
+			return true;
+		}
+	}
+
+	/*----------State----------*/
+
+	State::State(int64_t iterations, int64_t arg)
+		: iterations_(iterations), remaining_(iterations), arg_(arg)
+	{
+	}
+
+	bool State::KeepRunning()
+	{
+		if (!isStarted_) {
+			isStarted_ = true;
+			StartTimer();
+		}
+		if (remaining_ > 0) {
+			--remaining_;
+			return true;
+		}
+		if (isRunning_) {
+			StopTimer();
+		}
+		return false;
+	}
+
+	void State::PauseTiming()
+	{
+		if (isRunning_) {
+			StopTimer();
+		}
+	}
+
+	void State::ResumeTiming()
+	{
+		if (!isRunning_) {
+			StartTimer();
+		}
+	}
+
+	void State::SetCounter(const std::string& name, double value, bool isRate)
+	{
+		for (Counter& counter : counters_) {
+			if (counter.name == name) {
+				counter.value = value;
+				counter.isRate = isRate;
+				return;
+			}
+		}
+		counters_.push_back({ name, value, isRate });
+	}
+
+	void State::StartTimer()
+	{
+		isRunning_ = true;
+		cpuStart_ = std::clock();
+		realStart_ = std::chrono::steady_clock::now();
+	}
+
+	void State::StopTimer()
+	{
+		auto realEnd = std::chrono::steady_clock::now();
+		std::clock_t cpuEnd = std::clock();
+		isRunning_ = false;
+		realSeconds_ += std::chrono::duration<double>(realEnd - realStart_).count();
+		cpuSeconds_ += static_cast<double>(cpuEnd - cpuStart_) / CLOCKS_PER_SEC;
+	}
+
+	/*----------Benchmark----------*/
+
+	Benchmark::Benchmark(std::string name, Function function)
+		: name_(std::move(name)), function_(std::move(function))
+	{
+	}
+
+	Benchmark* Benchmark::Arg(int64_t arg)
+	{
+		args_.push_back(arg);
+		return this;
+	}
+
+	Benchmark* Benchmark::MinTime(double seconds)
+	{
+		minTime_ = seconds;
+		return this;
+	}
+
+	/*----------登録と実行----------*/
+
+	Benchmark* RegisterBenchmark(const std::string& name, Function function)
+	{
+		auto& registry = GetRegistry();
+		registry.push_back(std::make_unique<Benchmark>(name, std::move(function)));
+		return registry.back().get();
+	}
+
+	void AddCustomContext(const std::string& key, const std::string& value)
+	{
+		GetCustomContext().emplace_back(key, value);
+	}
+
+	int RunSpecifiedBenchmarks(int argc, char** argv)
+	{
+		std::string filter = ".";
+		std::string format = "console";
+		std::string outPath;
+		double minTime = kDefaultMinTime;
+
+		for (int i = 1; i < argc; ++i) {
+			std::string value;
+			if (ParseFlag(argv[i], "--benchmark_filter", value)) {
+				filter = value;
+			} else if (ParseFlag(argv[i], "--benchmark_format", value)) {
+				format = value;
+			} else if (ParseFlag(argv[i], "--benchmark_out", value)) {
+				outPath = value;
+			} else if (ParseFlag(argv[i], "--benchmark_min_time", value)) {
+				// Google Benchmarkと同じく末尾の "s" は省略できる
+				if (!value.empty() && value.back() == 's') {
+					value.pop_back();
+				}
+				minTime = std::stod(value);
+			} else if (std::strcmp(argv[i], "--benchmark_list_tests") == 0) {
+				for (const auto& benchmark : GetRegistry()) {
+					for (size_t a = 0; a < (std::max)(benchmark->GetArgs().size(), size_t(1)); ++a) {
+						std::printf("%s\n", MakeRunName(benchmark->GetName(), benchmark->GetArgs(), a).c_str());
+					}
+				}
+				return 0;
+			} else {
+				std::fprintf(stderr, "unknown argument: %s\n", argv[i]);
+				std::fprintf(stderr, "usage: %s [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>] "
+					"[--benchmark_format=<console|json>] [--benchmark_out=<file>] [--benchmark_list_tests]\n", argv[0]);
+				return 1;
+			}
+		}
+
+		if (format != "console" && format != "json") {
+			std::fprintf(stderr, "unknown format: %s\n", format.c_str());
+			return 1;
+		}
+
+		std::regex filterRegex;
+		try {
+			filterRegex = std::regex(filter);
+		} catch (const std::regex_error&) {
+			std::fprintf(stderr, "invalid filter: %s\n", filter.c_str());
+			return 1;
+		}
+
+		// 実行するものを先に決めて、表の幅をそろえる
+		struct Entry final
+		{
+			const Benchmark* benchmark;
+			std::string name;
+			int64_t arg;
+		};
+		std::vector<Entry> entries;
+		size_t nameWidth = 10;
+		for (const auto& benchmark : GetRegistry()) {
+			const std::vector<int64_t>& args = benchmark->GetArgs();
+			for (size_t a = 0; a < (std::max)(args.size(), size_t(1)); ++a) {
+				std::string name = MakeRunName(benchmark->GetName(), args, a);
+				if (!std::regex_search(name, filterRegex)) {
+					continue;
+				}
+				nameWidth = (std::max)(nameWidth, name.size());
+				entries.push_back({ benchmark.get(), name, args.empty() ? 0 : args[a] });
+			}
+		}
+
+		bool isConsole = format == "console";
+		if (isConsole) {
+			PrintConsoleHeader(nameWidth);
+		}
+
+		std::vector<RunResult> results;
+		results.reserve(entries.size());
+		for (const Entry& entry : entries) {
+			double entryMinTime = entry.benchmark->GetMinTime() > 0.0 ? entry.benchmark->GetMinTime() : minTime;
+			results.push_back(Run(*entry.benchmark, entry.name, entry.arg, entryMinTime));
+			if (isConsole) {
+				PrintConsoleResult(results.back(), nameWidth);
+			}
+		}
+
+		std::string executable = argc > 0 ? argv[0] : "";
+		if (!isConsole) {
+			WriteJson(std::cout, executable, results);
+		}
+		if (!outPath.empty()) {
+			std::ofstream file(outPath);
+			if (!file) {
+				std::fprintf(stderr, "failed to open %s\n", outPath.c_str());
+				return 1;
+			}
+			WriteJson(file, executable, results);
+		}
+		return 0;
+	}
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Google Benchmarkと同じ書き方で使える小さな計測ハーネス
+// 外部ライブラリなしでビルドでき、出力するJSONもGoogle Benchmarkと同じ形式にしてある
+// (compare.pyなどの既存のツールで前回の結果と比べられる)
+namespace Bench
+{
+	/// <summary>
+	/// 1つのベンチマークの実行状態
+	/// while (state.KeepRunning()) { ... } の中身の時間を測る
+	/// </summary>
+	class State final
+	{
+	public:
+		State(int64_t iterations, int64_t arg);
+
+		// 計測するループの条件。最初の呼び出しで計測を始め、回数を使い切ったら止める
+		bool KeepRunning();
+
+		// ループの中で準備の時間を計測から外す
+		void PauseTiming();
+		void ResumeTiming();
+
+		// BENCHMARK(...)->Arg(n) で渡した値
+		int64_t GetArg() const { return arg_; }
+		int64_t GetIterations() const { return iterations_; }
+
+		// 処理した要素数。1秒あたりの数(items_per_second)として出力する
+		void SetItemsProcessed(int64_t items) { itemsProcessed_ = items; }
+
+		// 任意の値を出力に加える。isRateなら1秒あたりの数にして出力する
+		void SetCounter(const std::string& name, double value, bool isRate = false);
+
+		double GetRealSeconds() const { return realSeconds_; }
+		double GetCpuSeconds() const { return cpuSeconds_; }
+		int64_t GetItemsProcessed() const { return itemsProcessed_; }
+
+		struct Counter final
+		{
+			std::string name;
+			double value;
+			bool isRate;
+		};
+		const std::vector<Counter>& GetCounters() const { return counters_; }
+
+	private:
+		void StartTimer();
+		void StopTimer();
+
+		int64_t iterations_;
+		int64_t remaining_;
+		int64_t arg_;
+		int64_t itemsProcessed_ = 0;
+		bool isStarted_ = false;
+		bool isRunning_ = false;
+
+		std::chrono::steady_clock::time_point realStart_;
+		std::clock_t cpuStart_ = 0;
+		double realSeconds_ = 0.0;
+		double cpuSeconds_ = 0.0;
+
+		std::vector<Counter> counters_;
+	};
+
+	using Function = std::function<void(State&)>;
+
+	/// <summary>
+	/// 登録されたベンチマーク。Argを呼ぶたびに引数違いの計測が増える
+	/// </summary>
+	class Benchmark final
+	{
+	public:
+		Benchmark(std::string name, Function function);
+
+		Benchmark* Arg(int64_t arg);
+
+		// 各引数で、最低でもこの秒数だけ回す(コマンドラインの指定より優先)
+		Benchmark* MinTime(double seconds);
+
+		const std::string& GetName() const { return name_; }
+		const Function& GetFunction() const { return function_; }
+		const std::vector<int64_t>& GetArgs() const { return args_; }
+		double GetMinTime() const { return minTime_; }
+
+	private:
+		std::string name_;
+		Function function_;
+		std::vector<int64_t> args_;
+		double minTime_ = 0.0;
+	};
+
+	// ベンチマークを登録する。戻り値はプログラムの終了まで有効
+	Benchmark* RegisterBenchmark(const std::string& name, Function function);
+
+	// コマンドライン引数を解釈して、登録されたベンチマークをすべて実行する
+	// --benchmark_filter=<正規表現> --benchmark_min_time=<秒>
+	// --benchmark_format=<console|json> --benchmark_out=<ファイル名>
+	int RunSpecifiedBenchmarks(int argc, char** argv);
+
+	// JSON出力のcontextに項目を加える(ビルド設定など、結果を比べるときに必要な情報)
+	void AddCustomContext(const std::string& key, const std::string& value);
+
+	// 値を使ったことにして、計算が最適化で消されないようにする
+	template <class T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static const volatile void* sink;
+		sink = &value;
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+	}
+
+	// それまでのメモリへの書き込みが最適化で消されないようにする
+	inline void ClobberMemory()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : : "memory");
+#else
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+	}
+}
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+
+// 関数をベンチマークとして登録する。BENCHMARK(Vector3_Add)->Arg(1024); のように続けて書ける
+#define BENCHMARK(function) \
+	[[maybe_unused]] static ::Bench::Benchmark* BENCHMARK_CONCAT(benchmarkRegistration_, __LINE__) = \
+		::Bench::RegisterBenchmark(#function, function)
@@ -0,0 +1,281 @@
+#include "BenchmarkCommon.h"
+#include "BenchmarkHarness.h"
+#include "Curve.h"
+#include "DrawFunction.h"
+#include "Frustum.h"
+#include "MathFunction.h"
+#include "Quaternion.h"
+#include "RandomPrimitives.h"
+#include <array>
+
+// MathFunction.hの関数を1つずつ計測する
+// 入力は用意した配列から順に取り出し、定数に畳み込まれたり分岐予測が当たり続けたりしないようにする
+
+using namespace Math;
+
+namespace
+{
+	constexpr uint32_t kInputCount = 1024;	// 2の累乗にする
+	constexpr uint32_t kInputMask = kInputCount - 1;
+
+	/// <summary>
+	/// 計測に使う入力。衝突判定の半分くらいが当たるように狭い範囲に置く
+	/// </summary>
+	struct Inputs final
+	{
+		std::array<Vector3, kInputCount> points;
+		std::array<Vector3, kInputCount> otherPoints;
+		std::array<Vector3, kInputCount> directions;
+		std::array<Vector4, kInputCount> points4;
+		std::array<float, kInputCount> scalars;
+		std::array<Matrix4x4, kInputCount> matrices;
+		std::array<Matrix4x4, kInputCount> otherMatrices;
+		std::array<Sphere, kInputCount> spheres;
+		std::array<Sphere, kInputCount> otherSpheres;
+		std::array<Plane, kInputCount> planes;
+		std::array<Segment, kInputCount> segments;
+		std::array<Triangle, kInputCount> triangles;
+		std::array<AABB, kInputCount> aabbs;
+		std::array<AABB, kInputCount> otherAABBs;
+		std::array<OBB, kInputCount> obbs;
+		std::array<OBB, kInputCount> otherOBBs;
+		std::array<CachedOBB, kInputCount> cachedOBBs;
+		std::array<CachedOBB, kInputCount> otherCachedOBBs;
+		std::array<Quaternion, kInputCount> quaternions;
+		std::array<Quaternion, kInputCount> otherQuaternions;
+		std::array<CubicBezier, kInputCount> curves;
+		Curve path;	// pointsを順に通るCatmull-Rom曲線
+		Matrix4x4 viewProjectionMatrix;
+		Matrix4x4 viewportMatrix;
+		Frustum frustum;
+	};
+
+	void MakeInputs(Inputs& inputs)
+	{
+		Bench::RandomPrimitives random(1, 3.0f);
+		for (uint32_t i = 0; i < kInputCount; ++i) {
+			inputs.points[i] = random.Point();
+			inputs.otherPoints[i] = random.Point();
+			inputs.directions[i] = random.Direction();
+			inputs.points4[i] = { inputs.points[i].x, inputs.points[i].y, inputs.points[i].z, 1.0f };
+			inputs.scalars[i] = random.Range(0.0f, 1.0f);
+			inputs.matrices[i] = random.MakeAffineMatrix();
+			inputs.otherMatrices[i] = random.MakeAffineMatrix();
+			inputs.spheres[i] = random.MakeSphere();
+			inputs.otherSpheres[i] = random.MakeSphere();
+			inputs.planes[i] = random.MakePlane();
+			inputs.segments[i] = random.MakeSegment();
+			inputs.triangles[i] = random.MakeTriangle();
+			inputs.aabbs[i] = random.MakeAABB();
+			inputs.otherAABBs[i] = random.MakeAABB();
+			inputs.obbs[i] = random.MakeOBB();
+			inputs.otherOBBs[i] = random.MakeOBB();
+			inputs.cachedOBBs[i] = MakeCachedOBB(inputs.obbs[i]);
+			inputs.otherCachedOBBs[i] = MakeCachedOBB(inputs.otherOBBs[i]);
+			inputs.quaternions[i] = MakeRotateEulerQuaternion(random.Rotation());
+			inputs.otherQuaternions[i] = MakeRotateEulerQuaternion(random.Rotation());
+		}
+		for (uint32_t i = 0; i < kInputCount; ++i) {
+			inputs.curves[i] = { { inputs.points[i], inputs.otherPoints[i], inputs.directions[i], inputs.points[(i + 1) & kInputMask] } };
+		}
+		inputs.path.SetCatmullRom(inputs.points);
+		inputs.path.GetLength();
+		Camera camera = Bench::MakeCamera();
+		inputs.viewProjectionMatrix = camera.GetViewProjectionMatrix();
+		inputs.viewportMatrix = camera.GetViewportMatrix();
+		inputs.frustum = camera.GetFrustum();
+	}
+
+	const Inputs& GetInputs()
+	{
+		static Inputs inputs;
+		static bool isInitialized = false;
+		if (!isInitialized) {
+			MakeInputs(inputs);
+			isInitialized = true;
+		}
+		return inputs;
+	}
+
+	// func(inputs, i)の戻り値を捨てずに回し続ける。1回の呼び出しを1要素と数える
+	template <class Func>
+	void RegisterMicro(const char* name, Func func)
+	{
+		Bench::RegisterBenchmark(name, [func](Bench::State& state) {
+			const Inputs& inputs = GetInputs();
+			uint32_t i = 0;
+			while (state.KeepRunning()) {
+				Bench::DoNotOptimize(func(inputs, i));
+				i = (i + 1) & kInputMask;
+			}
+			state.SetItemsProcessed(state.GetIterations());
+		});
+	}
+
+	// Draw*関数を記録用のバックエンドに向けて回す。kInputCount回ごとに1フレーム分として流す
+	template <class Func>
+	void RegisterDraw(const char* name, Func func)
+	{
+		Bench::RegisterBenchmark(name, [func](Bench::State& state) {
+			const Inputs& inputs = GetInputs();
+			Camera camera = Bench::MakeCamera();
+			Bench::HeadlessDrawScope scope;
+			size_t vertexCount = 0;
+			uint32_t i = 0;
+			while (state.KeepRunning()) {
+				func(inputs, camera, i);
+				i = (i + 1) & kInputMask;
+				if (i == 0) {
+					vertexCount += scope.Flush();
+				}
+			}
+			vertexCount += scope.Flush();
+			state.SetItemsProcessed(state.GetIterations());
+			state.SetCounter("vertices_per_second", static_cast<double>(vertexCount), true);
+		});
+	}
+
+	// 接触情報を求めるIsCollisionを回す
+	template <class Func>
+	void RegisterContact(const char* name, Func func)
+	{
+		RegisterMicro(name, [func](const Inputs& inputs, uint32_t i) {
+			ContactManifold manifold;
+			bool isHit = func(inputs, i, manifold);
+			Bench::DoNotOptimize(manifold);
+			return isHit;
+		});
+	}
+
+	[[maybe_unused]] const bool kIsRegistered = [] {
+		/*----------Vector4型の関数----------*/
+		RegisterMicro("Vector4_Multiply", [](const Inputs& in, uint32_t i) { return Multiply(in.points4[i], in.matrices[i]); });
+
+		/*----------Vector3型の関数----------*/
+		RegisterMicro("Vector3_Add", [](const Inputs& in, uint32_t i) { return Add(in.points[i], in.otherPoints[i]); });
+		RegisterMicro("Vector3_Subtract", [](const Inputs& in, uint32_t i) { return Subtract(in.points[i], in.otherPoints[i]); });
+		RegisterMicro("Vector3_Multiply", [](const Inputs& in, uint32_t i) { return Multiply(in.scalars[i], in.points[i]); });
+		RegisterMicro("Vector3_Dot", [](const Inputs& in, uint32_t i) { return Dot(in.points[i], in.otherPoints[i]); });
+		RegisterMicro("Vector3_Length", [](const Inputs& in, uint32_t i) { return Length(in.points[i]); });
+		RegisterMicro("Vector3_Normalize", [](const Inputs& in, uint32_t i) { return Normalize(in.points[i]); });
+		RegisterMicro("Vector3_Transform", [](const Inputs& in, uint32_t i) { return Transform(in.points[i], in.matrices[i]); });
+		RegisterMicro("Vector3_Cross", [](const Inputs& in, uint32_t i) { return Cross(in.points[i], in.otherPoints[i]); });
+		RegisterMicro("Vector3_Project", [](const Inputs& in, uint32_t i) { return Project(in.points[i], in.directions[i]); });
+		RegisterMicro("Vector3_ClosestPoint", [](const Inputs& in, uint32_t i) { return ClosestPoint(in.points[i], in.segments[i]); });
+		RegisterMicro("Vector3_Perpendicular", [](const Inputs& in, uint32_t i) { return Perpendicular(in.directions[i]); });
+		RegisterMicro("Vector3_Lerp", [](const Inputs& in, uint32_t i) { return Lerp(in.points[i], in.otherPoints[i], in.scalars[i]); });
+		RegisterMicro("Vector3_ProjectToScreen", [](const Inputs& in, uint32_t i) { return ProjectToScreen(in.points[i], in.viewProjectionMatrix, in.viewportMatrix); });
+		RegisterMicro("Vector3_Reflect", [](const Inputs& in, uint32_t i) { return Reflect(in.points[i], in.directions[i]); });
+
+		/*----------Matrix型の関数----------*/
+		RegisterMicro("Matrix_Add", [](const Inputs& in, uint32_t i) { return Add(in.matrices[i], in.otherMatrices[i]); });
+		RegisterMicro("Matrix_Subtract", [](const Inputs& in, uint32_t i) { return Subtract(in.matrices[i], in.otherMatrices[i]); });
+		RegisterMicro("Matrix_Multiply", [](const Inputs& in, uint32_t i) { return Multiply(in.matrices[i], in.otherMatrices[i]); });
+		RegisterMicro("Matrix_Inverse", [](const Inputs& in, uint32_t i) { return Inverse(in.matrices[i]); });
+		RegisterMicro("Matrix_InverseAffine", [](const Inputs& in, uint32_t i) { return InverseAffine(in.matrices[i]); });
+		RegisterMicro("Matrix_Transpose", [](const Inputs& in, uint32_t i) { return Transpose(in.matrices[i]); });
+		RegisterMicro("Matrix_MakeIdentity", [](const Inputs&, uint32_t) { return MakeIdentity(); });
+		RegisterMicro("Matrix_MakeScaleMatrix", [](const Inputs& in, uint32_t i) { return MakeScaleMatrix(in.points[i]); });
+		RegisterMicro("Matrix_MakeRotateXMatrix", [](const Inputs& in, uint32_t i) { return MakeRotateXMatrix(in.scalars[i]); });
+		RegisterMicro("Matrix_MakeRotateYMatrix", [](const Inputs& in, uint32_t i) { return MakeRotateYMatrix(in.scalars[i]); });
+		RegisterMicro("Matrix_MakeRotateZMatrix", [](const Inputs& in, uint32_t i) { return MakeRotateZMatrix(in.scalars[i]); });
+		RegisterMicro("Matrix_MakeTranslateMatrix", [](const Inputs& in, uint32_t i) { return MakeTranslateMatrix(in.points[i]); });
+		RegisterMicro("Matrix_MakeAffineMatrix", [](const Inputs& in, uint32_t i) { return MakeAffineMatrix(in.otherPoints[i], in.directions[i], in.points[i]); });
+		RegisterMicro("Matrix_MakePerspectiveFovMatrix", [](const Inputs& in, uint32_t i) { return MakePerspectiveFovMatrix(0.2f + in.scalars[i], 16.0f / 9.0f, 0.1f, 100.0f); });
+		RegisterMicro("Matrix_MakeOrthographicMatrix", [](const Inputs& in, uint32_t i) { return MakeOrthographicMatrix(-in.scalars[i], 1.0f, 1.0f, -1.0f, 0.1f, 100.0f); });
+		RegisterMicro("Matrix_MakeViewportMatrix", [](const Inputs& in, uint32_t i) { return MakeViewportMatrix(0.0f, 0.0f, 1280.0f * in.scalars[i], 720.0f, 0.0f, 1.0f); });
+
+		/*----------Quaternion型の関数----------*/
+		RegisterMicro("Quaternion_Multiply", [](const Inputs& in, uint32_t i) { return Multiply(in.quaternions[i], in.otherQuaternions[i]); });
+		RegisterMicro("Quaternion_Normalize", [](const Inputs& in, uint32_t i) { return Normalize(in.quaternions[i]); });
+		RegisterMicro("Quaternion_Inverse", [](const Inputs& in, uint32_t i) { return Inverse(in.quaternions[i]); });
+		RegisterMicro("Quaternion_MakeRotateAxisAngleQuaternion", [](const Inputs& in, uint32_t i) { return MakeRotateAxisAngleQuaternion(in.directions[i], in.scalars[i]); });
+		RegisterMicro("Quaternion_MakeRotateEulerQuaternion", [](const Inputs& in, uint32_t i) { return MakeRotateEulerQuaternion(in.directions[i]); });
+		RegisterMicro("Quaternion_RotateVector", [](const Inputs& in, uint32_t i) { return RotateVector(in.points[i], in.quaternions[i]); });
+		RegisterMicro("Quaternion_Slerp", [](const Inputs& in, uint32_t i) { return Slerp(in.quaternions[i], in.otherQuaternions[i], in.scalars[i]); });
+		RegisterMicro("Quaternion_MakeRotateMatrix", [](const Inputs& in, uint32_t i) { return MakeRotateMatrix(in.quaternions[i]); });
+		RegisterMicro("Quaternion_MakeAffineMatrix", [](const Inputs& in, uint32_t i) { return MakeAffineMatrix(in.otherPoints[i], in.quaternions[i], in.points[i]); });
+
+		/*----------曲線----------*/
+		RegisterMicro("Curve_Evaluate", [](const Inputs& in, uint32_t i) { return Evaluate(in.curves[i], in.scalars[i]); });
+		RegisterMicro("Curve_EvaluateUniform16", [](const Inputs& in, uint32_t i) {
+			Vector3 points[17];
+			EvaluateUniform(in.curves[i], points);
+			Bench::DoNotOptimize(points);
+			return points[8];
+		});
+		RegisterMicro("Curve_TessellateAdaptive", [](const Inputs& in, uint32_t i) {
+			static std::vector<Vector3> lineVertices;
+			lineVertices.clear();
+			return TessellateAdaptive(in.curves[i], in.viewProjectionMatrix, in.viewportMatrix, 0.5f, lineVertices);
+		});
+		RegisterMicro("Curve_EvaluateAtDistance", [](const Inputs& in, uint32_t i) { return in.path.EvaluateAtDistance(in.scalars[i] * in.path.GetLength()); });
+
+		/*----------立体を描画する関数----------*/
+		RegisterDraw("Draw_Grid", [](const Inputs&, const Camera& camera, uint32_t) { DrawGrid(camera); });
+		RegisterDraw("Draw_Sphere", [](const Inputs& in, const Camera& camera, uint32_t i) { DrawSphere(in.spheres[i], camera, 0xFFFFFFFF); });
+		RegisterDraw("Draw_SphereMatrix", [](const Inputs& in, const Camera&, uint32_t i) { DrawSphere(in.spheres[i], in.viewProjectionMatrix, in.viewportMatrix, 0xFFFFFFFF); });
+		RegisterDraw("Draw_Plane", [](const Inputs& in, const Camera& camera, uint32_t i) { DrawPlane(in.planes[i], camera, 0xFFFFFFFF); });
+		RegisterDraw("Draw_Triangle", [](const Inputs& in, const Camera& camera, uint32_t i) { DrawTriangle(in.triangles[i], camera, 0xFFFFFFFF); });
+		RegisterDraw("Draw_AABB", [](const Inputs& in, const Camera& camera, uint32_t i) { DrawAABB(in.aabbs[i], camera, 0xFFFFFFFF); });
+		RegisterDraw("Draw_Bezier", [](const Inputs& in, const Camera& camera, uint32_t i) { DrawBezier(in.points[i], in.otherPoints[i], in.directions[i], camera, 0xFFFFFFFF); });
+		RegisterDraw("Draw_CubicBezier", [](const Inputs& in, const Camera& camera, uint32_t i) {
+			Curve curve;
+			curve.SetCubicBezier(in.curves[i]);
+			DrawCurve(curve, camera, 0xFFFFFFFF);
+		});
+		RegisterDraw("Draw_ControlPoint", [](const Inputs& in, const Camera& camera, uint32_t i) { DrawControlPoint(in.points[i], camera); });
+		RegisterDraw("Draw_OBB", [](const Inputs& in, const Camera& camera, uint32_t i) { DrawOBB(in.obbs[i], camera, 0xFFFFFFFF); });
+
+		/*----------衝突判定を取る関数----------*/
+		RegisterMicro("IsCollision_SphereSphere", [](const Inputs& in, uint32_t i) { return IsCollision(in.spheres[i], in.otherSpheres[i]); });
+		RegisterMicro("IsCollision_SpherePlane", [](const Inputs& in, uint32_t i) { return IsCollision(in.spheres[i], in.planes[i]); });
+		RegisterMicro("IsCollision_SegmentPlane", [](const Inputs& in, uint32_t i) { return IsCollision(in.segments[i], in.planes[i]); });
+		RegisterMicro("IsCollision_TriangleSegment", [](const Inputs& in, uint32_t i) { return IsCollision(in.triangles[i], in.segments[i]); });
+		RegisterMicro("IsCollision_AABBAABB", [](const Inputs& in, uint32_t i) { return IsCollision(in.aabbs[i], in.otherAABBs[i]); });
+		RegisterMicro("IsCollision_AABBSphere", [](const Inputs& in, uint32_t i) { return IsCollision(in.aabbs[i], in.spheres[i]); });
+		RegisterMicro("IsCollision_AABBSegment", [](const Inputs& in, uint32_t i) { return IsCollision(in.aabbs[i], in.segments[i]); });
+		RegisterMicro("IsCollision_OBBSphere", [](const Inputs& in, uint32_t i) { return IsCollision(in.obbs[i], in.spheres[i]); });
+		RegisterMicro("IsCollision_OBBSegment", [](const Inputs& in, uint32_t i) { return IsCollision(in.obbs[i], in.segments[i]); });
+		RegisterMicro("IsCollision_OBBOBB", [](const Inputs& in, uint32_t i) { return IsCollision(in.obbs[i], in.otherOBBs[i]); });
+		RegisterMicro("IsCollision_CachedOBBSphere", [](const Inputs& in, uint32_t i) { return IsCollision(in.cachedOBBs[i], in.spheres[i]); });
+		RegisterMicro("IsCollision_CachedOBBSegment", [](const Inputs& in, uint32_t i) { return IsCollision(in.cachedOBBs[i], in.segments[i]); });
+		RegisterMicro("IsCollision_CachedOBBCachedOBB", [](const Inputs& in, uint32_t i) { return IsCollision(in.cachedOBBs[i], in.otherCachedOBBs[i]); });
+		RegisterMicro("IsCollision_CachedOBBPenetration", [](const Inputs& in, uint32_t i) {
+			OBBPenetration penetration;
+			bool isHit = IsCollision(in.cachedOBBs[i], in.otherCachedOBBs[i], penetration);
+			Bench::DoNotOptimize(penetration);
+			return isHit;
+		});
+
+		/*----------視錐台との判定----------*/
+		RegisterMicro("Frustum_MakeFrustum", [](const Inputs& in, uint32_t i) { return MakeFrustum(in.matrices[i]); });
+		RegisterMicro("Frustum_Sphere", [](const Inputs& in, uint32_t i) { return IsCollision(in.frustum, in.spheres[i]); });
+		RegisterMicro("Frustum_AABB", [](const Inputs& in, uint32_t i) { return IsCollision(in.frustum, in.aabbs[i]); });
+		RegisterMicro("Frustum_OBB", [](const Inputs& in, uint32_t i) { return IsCollision(in.frustum, in.obbs[i]); });
+
+		/*----------接触情報を求める衝突判定----------*/
+		RegisterContact("Contact_SphereSphere", [](const Inputs& in, uint32_t i, ContactManifold& m) { return IsCollision(in.spheres[i], in.otherSpheres[i], m); });
+		RegisterContact("Contact_SpherePlane", [](const Inputs& in, uint32_t i, ContactManifold& m) { return IsCollision(in.spheres[i], in.planes[i], m); });
+		RegisterContact("Contact_AABBSphere", [](const Inputs& in, uint32_t i, ContactManifold& m) { return IsCollision(in.aabbs[i], in.spheres[i], m); });
+		RegisterContact("Contact_AABBAABB", [](const Inputs& in, uint32_t i, ContactManifold& m) { return IsCollision(in.aabbs[i], in.otherAABBs[i], m); });
+		RegisterContact("Contact_CachedOBBSphere", [](const Inputs& in, uint32_t i, ContactManifold& m) { return IsCollision(in.cachedOBBs[i], in.spheres[i], m); });
+		RegisterContact("Contact_CachedOBBCachedOBB", [](const Inputs& in, uint32_t i, ContactManifold& m) { return IsCollision(in.cachedOBBs[i], in.otherCachedOBBs[i], m); });
+		RegisterContact("Contact_OBBSphere", [](const Inputs& in, uint32_t i, ContactManifold& m) { return IsCollision(in.obbs[i], in.spheres[i], m); });
+		RegisterContact("Contact_OBBOBB", [](const Inputs& in, uint32_t i, ContactManifold& m) { return IsCollision(in.obbs[i], in.otherOBBs[i], m); });
+
+		/*----------OBBの前計算----------*/
+		RegisterMicro("OBB_MakeCachedOBB", [](const Inputs& in, uint32_t i) { return MakeCachedOBB(in.obbs[i]); });
+		RegisterMicro("OBB_TransformToLocal", [](const Inputs& in, uint32_t i) { return TransformToLocal(in.cachedOBBs[i], in.points[i]); });
+
+		/*----------AABBを求める関数----------*/
+		RegisterMicro("AABB_MakeAABBSphere", [](const Inputs& in, uint32_t i) { return MakeAABB(in.spheres[i]); });
+		RegisterMicro("AABB_MakeAABBOBB", [](const Inputs& in, uint32_t i) { return MakeAABB(in.obbs[i]); });
+		RegisterMicro("AABB_MakeAABBTriangle", [](const Inputs& in, uint32_t i) { return MakeAABB(in.triangles[i]); });
+		RegisterMicro("AABB_MakeAABBSegment", [](const Inputs& in, uint32_t i) { return MakeAABB(in.segments[i]); });
+		RegisterMicro("AABB_Union", [](const Inputs& in, uint32_t i) { return Union(in.aabbs[i], in.otherAABBs[i]); });
+		RegisterMicro("AABB_Contains", [](const Inputs& in, uint32_t i) { return Contains(in.aabbs[i], in.otherAABBs[i]); });
+		RegisterMicro("AABB_SurfaceArea", [](const Inputs& in, uint32_t i) { return SurfaceArea(in.aabbs[i]); });
+		return true;
+	}();
+}
@@ -0,0 +1,91 @@
+#include "RandomPrimitives.h"
+#include "MathFunction.h"
+
+namespace Bench
+{
+	RandomPrimitives::RandomPrimitives(uint32_t seed, float worldHalfWidth)
+		: engine_(seed), worldHalfWidth_(worldHalfWidth)
+	{
+	}
+
+	float RandomPrimitives::Range(float min, float max)
+	{
+		return std::uniform_real_distribution<float>(min, max)(engine_);
+	}
+
+	Vector3 RandomPrimitives::Point()
+	{
+		return { Range(-worldHalfWidth_, worldHalfWidth_), Range(-worldHalfWidth_, worldHalfWidth_), Range(-worldHalfWidth_, worldHalfWidth_) };
+	}
+
+	Vector3 RandomPrimitives::Direction()
+	{
+		// 球の中から取り直して、向きが偏らないようにする
+		for (;;) {
+			Vector3 v = { Range(-1.0f, 1.0f), Range(-1.0f, 1.0f), Range(-1.0f, 1.0f) };
+			float lengthSquared = Math::Dot(v, v);
+			if (lengthSquared > 1e-4f && lengthSquared <= 1.0f) {
+				return v / std::sqrt(lengthSquared);
+			}
+		}
+	}
+
+	Vector3 RandomPrimitives::Rotation()
+	{
+		const float kPi = static_cast<float>(M_PI);
+		return { Range(-kPi, kPi), Range(-kPi, kPi), Range(-kPi, kPi) };
+	}
+
+	Sphere RandomPrimitives::MakeSphere(float minRadius, float maxRadius)
+	{
+		return { Point(), Range(minRadius, maxRadius) };
+	}
+
+	Plane RandomPrimitives::MakePlane()
+	{
+		return { Direction(), Range(-worldHalfWidth_, worldHalfWidth_) };
+	}
+
+	Segment RandomPrimitives::MakeSegment(float maxLength)
+	{
+		return { Point(), Direction() * Range(0.1f, maxLength) };
+	}
+
+	Ray RandomPrimitives::MakeRay(float length)
+	{
+		return { Point(), Direction() * length };
+	}
+
+	Triangle RandomPrimitives::MakeTriangle(float maxEdge)
+	{
+		Vector3 v0 = Point();
+		return { { v0, v0 + Direction() * Range(0.1f, maxEdge), v0 + Direction() * Range(0.1f, maxEdge) } };
+	}
+
+	AABB RandomPrimitives::MakeAABB(float minHalfSize, float maxHalfSize)
+	{
+		Vector3 center = Point();
+		Vector3 halfSize = { Range(minHalfSize, maxHalfSize), Range(minHalfSize, maxHalfSize), Range(minHalfSize, maxHalfSize) };
+		return { center - halfSize, center + halfSize };
+	}
+
+	OBB RandomPrimitives::MakeOBB(float minHalfSize, float maxHalfSize)
+	{
+		Vector3 rotate = Rotation();
+		Matrix4x4 rotateMatrix = Math::Multiply(Math::MakeRotateXMatrix(rotate.x), Math::Multiply(Math::MakeRotateYMatrix(rotate.y), Math::MakeRotateZMatrix(rotate.z)));
+
+		OBB obb{};
+		obb.center = Point();
+		for (int i = 0; i < 3; ++i) {
+			obb.orientations[i] = { rotateMatrix.m[i][0], rotateMatrix.m[i][1], rotateMatrix.m[i][2] };
+		}
+		obb.size = { Range(minHalfSize, maxHalfSize), Range(minHalfSize, maxHalfSize), Range(minHalfSize, maxHalfSize) };
+		return obb;
+	}
+
+	Matrix4x4 RandomPrimitives::MakeAffineMatrix()
+	{
+		Vector3 scale = { Range(0.5f, 2.0f), Range(0.5f, 2.0f), Range(0.5f, 2.0f) };
+		return Math::MakeAffineMatrix(scale, Rotation(), Point());
+	}
+}
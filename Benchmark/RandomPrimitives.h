@@ -0,0 +1,44 @@
+#pragma once
+#include "AABB.h"
+#include "Matrix4x4.h"
+#include "OBB.h"
+#include "Plane.h"
+#include "Ray.h"
+#include "Segment.h"
+#include "Sphereh.h"
+#include "Triangle.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <random>
+
+namespace Bench
+{
+	/// <summary>
+	/// ベンチマーク用のランダムな形状を作る
+	/// 同じシードなら毎回同じ形状になるので、実行ごとの結果を比べられる
+	/// </summary>
+	class RandomPrimitives final
+	{
+	public:
+		// 形状は中心が[-worldHalfWidth, worldHalfWidth]の立方体に入るように作る
+		explicit RandomPrimitives(uint32_t seed = 12345, float worldHalfWidth = 50.0f);
+
+		float Range(float min, float max);
+		Vector3 Point();
+		Vector3 Direction();
+		Vector3 Rotation();
+
+		Sphere MakeSphere(float minRadius = 0.5f, float maxRadius = 2.0f);
+		Plane MakePlane();
+		Segment MakeSegment(float maxLength = 5.0f);
+		Ray MakeRay(float length = 100.0f);
+		Triangle MakeTriangle(float maxEdge = 2.0f);
+		AABB MakeAABB(float minHalfSize = 0.5f, float maxHalfSize = 2.0f);
+		OBB MakeOBB(float minHalfSize = 0.5f, float maxHalfSize = 2.0f);
+		Matrix4x4 MakeAffineMatrix();
+
+	private:
+		std::mt19937 engine_;
+		float worldHalfWidth_;
+	};
+}
@@ -0,0 +1,641 @@
+#include "AABBTree.h"
+#include "BallWorld.h"
+#include "BenchmarkCommon.h"
+#include "BenchmarkHarness.h"
+#include "CollisionBatch.h"
+#include "Curve.h"
+#include "DrawFunction.h"
+#include "MathFunction.h"
+#include "ObjLoader.h"
+#include "RandomPrimitives.h"
+#include "SceneCache.h"
+#include "SpatialHashGrid.h"
+#include "SweptCollision.h"
+#include "ThreadPool.h"
+#include "TransformBatch.h"
+#include "TransformHierarchy.h"
+#include "TriangleBVH.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+// シーン全体を想定した計測
+// 引数は形状の数。数を増やしても密度が変わらないように、置く範囲の広さを数に合わせる
+// 1ペアあたり・1頂点あたりの処理量(pairs_per_second, vertices_per_second)で前回と比べる
+
+using namespace Math;
+
+namespace
+{
+	constexpr uint32_t kSeed = 2024;
+
+	// 1辺4くらいの立方体に1つの形状が入る密度にする
+	float WorldHalfWidth(int64_t count)
+	{
+		return 2.0f * std::cbrt(static_cast<float>(count));
+	}
+
+	template <class T, class Make>
+	std::vector<T> MakeMany(int64_t count, uint32_t seed, Make make)
+	{
+		Bench::RandomPrimitives random(seed, WorldHalfWidth(count));
+		std::vector<T> result;
+		result.reserve(static_cast<size_t>(count));
+		for (int64_t i = 0; i < count; ++i) {
+			result.push_back(make(random));
+		}
+		return result;
+	}
+
+	std::vector<Sphere> MakeSpheres(int64_t count, uint32_t seed = kSeed)
+	{
+		return MakeMany<Sphere>(count, seed, [](Bench::RandomPrimitives& random) { return random.MakeSphere(); });
+	}
+
+	std::vector<AABB> MakeAABBs(int64_t count, uint32_t seed = kSeed)
+	{
+		return MakeMany<AABB>(count, seed, [](Bench::RandomPrimitives& random) { return random.MakeAABB(); });
+	}
+
+	std::vector<OBB> MakeOBBs(int64_t count, uint32_t seed = kSeed)
+	{
+		return MakeMany<OBB>(count, seed, [](Bench::RandomPrimitives& random) { return random.MakeOBB(); });
+	}
+
+	int64_t PairCount(int64_t count)
+	{
+		return count * (count - 1) / 2;
+	}
+
+	ThreadPool& GetThreadPool()
+	{
+		static ThreadPool threadPool;
+		return threadPool;
+	}
+
+	/*----------総当たりの衝突判定----------*/
+
+	void Scene_SpherePairsBruteForce(Bench::State& state)
+	{
+		std::vector<Sphere> spheres = MakeSpheres(state.GetArg());
+		int64_t hitCount = 0;
+		while (state.KeepRunning()) {
+			hitCount = 0;
+			for (size_t i = 0; i < spheres.size(); ++i) {
+				for (size_t j = i + 1; j < spheres.size(); ++j) {
+					hitCount += IsCollision(spheres[i], spheres[j]) ? 1 : 0;
+				}
+			}
+			Bench::DoNotOptimize(hitCount);
+		}
+		state.SetItemsProcessed(state.GetIterations() * PairCount(state.GetArg()));
+		state.SetCounter("hits", static_cast<double>(hitCount));
+	}
+	BENCHMARK(Scene_SpherePairsBruteForce)->Arg(256)->Arg(1024)->Arg(4096);
+
+	void Scene_SpherePairsBatch(Bench::State& state)
+	{
+		std::vector<Sphere> spheres = MakeSpheres(state.GetArg());
+		SphereBuffer buffer;
+		buffer.Assign(spheres);
+		SphereSoA view = buffer.View();
+		std::vector<uint32_t> hitMask(HitMaskWordCount(spheres.size()));
+		while (state.KeepRunning()) {
+			for (const Sphere& sphere : spheres) {
+				IsCollisionBatch(sphere, view, hitMask);
+				Bench::ClobberMemory();
+			}
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg() * state.GetArg());
+	}
+	BENCHMARK(Scene_SpherePairsBatch)->Arg(256)->Arg(1024)->Arg(4096);
+
+	void Scene_AABBPairsBruteForce(Bench::State& state)
+	{
+		std::vector<AABB> aabbs = MakeAABBs(state.GetArg());
+		int64_t hitCount = 0;
+		while (state.KeepRunning()) {
+			hitCount = 0;
+			for (size_t i = 0; i < aabbs.size(); ++i) {
+				for (size_t j = i + 1; j < aabbs.size(); ++j) {
+					hitCount += IsCollision(aabbs[i], aabbs[j]) ? 1 : 0;
+				}
+			}
+			Bench::DoNotOptimize(hitCount);
+		}
+		state.SetItemsProcessed(state.GetIterations() * PairCount(state.GetArg()));
+		state.SetCounter("hits", static_cast<double>(hitCount));
+	}
+	BENCHMARK(Scene_AABBPairsBruteForce)->Arg(256)->Arg(1024)->Arg(4096);
+
+	void Scene_OBBPairsBruteForce(Bench::State& state)
+	{
+		std::vector<OBB> obbs = MakeOBBs(state.GetArg());
+		int64_t hitCount = 0;
+		while (state.KeepRunning()) {
+			hitCount = 0;
+			for (size_t i = 0; i < obbs.size(); ++i) {
+				for (size_t j = i + 1; j < obbs.size(); ++j) {
+					hitCount += IsCollision(obbs[i], obbs[j]) ? 1 : 0;
+				}
+			}
+			Bench::DoNotOptimize(hitCount);
+		}
+		state.SetItemsProcessed(state.GetIterations() * PairCount(state.GetArg()));
+		state.SetCounter("hits", static_cast<double>(hitCount));
+	}
+	BENCHMARK(Scene_OBBPairsBruteForce)->Arg(256)->Arg(1024);
+
+	void Scene_CachedOBBPairsBruteForce(Bench::State& state)
+	{
+		std::vector<OBB> obbs = MakeOBBs(state.GetArg());
+		std::vector<CachedOBB> cachedOBBs;
+		int64_t hitCount = 0;
+		while (state.KeepRunning()) {
+			// 前計算もフレームごとに行う想定で計測に含める
+			cachedOBBs.clear();
+			for (const OBB& obb : obbs) {
+				cachedOBBs.push_back(MakeCachedOBB(obb));
+			}
+			hitCount = 0;
+			for (size_t i = 0; i < cachedOBBs.size(); ++i) {
+				for (size_t j = i + 1; j < cachedOBBs.size(); ++j) {
+					hitCount += IsCollision(cachedOBBs[i], cachedOBBs[j]) ? 1 : 0;
+				}
+			}
+			Bench::DoNotOptimize(hitCount);
+		}
+		state.SetItemsProcessed(state.GetIterations() * PairCount(state.GetArg()));
+		state.SetCounter("hits", static_cast<double>(hitCount));
+	}
+	BENCHMARK(Scene_CachedOBBPairsBruteForce)->Arg(256)->Arg(1024);
+
+	void Scene_OBBPairsBatch(Bench::State& state)
+	{
+		std::vector<OBB> obbs = MakeOBBs(state.GetArg());
+		OBBBuffer buffer;
+		buffer.Assign(obbs);
+		OBBSoA view = buffer.View();
+		std::vector<uint32_t> hitMask(HitMaskWordCount(obbs.size()));
+		while (state.KeepRunning()) {
+			for (const OBB& obb : obbs) {
+				IsCollisionBatch(obb, view, hitMask);
+				Bench::ClobberMemory();
+			}
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg() * state.GetArg());
+	}
+	BENCHMARK(Scene_OBBPairsBatch)->Arg(256)->Arg(1024);
+
+	/*----------広域判定 + 詳細判定----------*/
+
+	void Scene_AABBTreeOBBContacts(Bench::State& state)
+	{
+		std::vector<OBB> obbs = MakeOBBs(state.GetArg());
+		std::vector<CachedOBB> cachedOBBs;
+		std::vector<std::pair<int32_t, int32_t>> pairs;
+		int64_t pairCount = 0;
+		int64_t contactCount = 0;
+		while (state.KeepRunning()) {
+			AABBTree tree;
+			cachedOBBs.clear();
+			for (uint32_t i = 0; i < obbs.size(); ++i) {
+				cachedOBBs.push_back(MakeCachedOBB(obbs[i]));
+				tree.CreateProxy(MakeAABB(obbs[i]), i);
+			}
+			pairs.clear();
+			tree.QueryPairs(pairs);
+			for (const auto& [proxyA, proxyB] : pairs) {
+				ContactManifold manifold;
+				if (IsCollision(cachedOBBs[tree.GetUserData(proxyA)], cachedOBBs[tree.GetUserData(proxyB)], manifold)) {
+					++contactCount;
+					Bench::DoNotOptimize(manifold);
+				}
+			}
+			pairCount += static_cast<int64_t>(pairs.size());
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+		state.SetCounter("pairs_per_second", static_cast<double>(pairCount), true);
+		state.SetCounter("contacts_per_second", static_cast<double>(contactCount), true);
+	}
+	BENCHMARK(Scene_AABBTreeOBBContacts)->Arg(256)->Arg(1024)->Arg(4096);
+
+	void Scene_SpatialHashGridSpheres(Bench::State& state)
+	{
+		std::vector<Sphere> spheres = MakeSpheres(state.GetArg());
+		std::vector<float> positionX, positionY, positionZ, radius;
+		for (const Sphere& sphere : spheres) {
+			positionX.push_back(sphere.center.x);
+			positionY.push_back(sphere.center.y);
+			positionZ.push_back(sphere.center.z);
+			radius.push_back(sphere.radius);
+		}
+		SpatialHashGrid grid;
+		std::vector<std::pair<uint32_t, uint32_t>> pairs;
+		int64_t pairCount = 0;
+		int64_t hitCount = 0;
+		while (state.KeepRunning()) {
+			// 毎フレーム少しずつ動かして、セルの振り分け直しも計測に含める
+			for (float& x : positionX) {
+				x += 0.01f;
+			}
+			grid.Update(positionX, positionY, positionZ, radius);
+			pairs.clear();
+			grid.FindPairs(pairs);
+			for (const auto& [a, b] : pairs) {
+				Sphere sphereA = { { positionX[a], positionY[a], positionZ[a] }, radius[a] };
+				Sphere sphereB = { { positionX[b], positionY[b], positionZ[b] }, radius[b] };
+				hitCount += IsCollision(sphereA, sphereB) ? 1 : 0;
+			}
+			pairCount += static_cast<int64_t>(pairs.size());
+		}
+		Bench::DoNotOptimize(hitCount);
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+		state.SetCounter("pairs_per_second", static_cast<double>(pairCount), true);
+	}
+	BENCHMARK(Scene_SpatialHashGridSpheres)->Arg(1024)->Arg(4096)->Arg(16384);
+
+	/*----------物理----------*/
+
+	void Scene_BallWorldStep(Bench::State& state)
+	{
+		float halfWidth = WorldHalfWidth(state.GetArg());
+		Bench::RandomPrimitives random(kSeed, halfWidth);
+		BallWorld world(1.0f / 60.0f, &GetThreadPool());
+		world.AddPlane({ { 0.0f, 1.0f, 0.0f }, -halfWidth });
+		for (int32_t i = 0; i < 16; ++i) {
+			world.AddBox(random.MakeOBB(1.0f, 4.0f));
+		}
+		for (int64_t i = 0; i < state.GetArg(); ++i) {
+			Ball ball{};
+			ball.position = random.Point();
+			ball.velocity = random.Direction() * random.Range(0.0f, 10.0f);
+			ball.mass = 1.0f;
+			ball.radius = random.Range(0.2f, 0.5f);
+			ball.color = 0xFFFFFFFF;
+			world.AddBall(ball);
+		}
+		while (state.KeepRunning()) {
+			world.Step();
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+	}
+	BENCHMARK(Scene_BallWorldStep)->Arg(1024)->Arg(4096)->Arg(16384);
+
+	void Scene_SweepSphereBoxes(Bench::State& state)
+	{
+		float halfWidth = WorldHalfWidth(state.GetArg());
+		Bench::RandomPrimitives random(kSeed, halfWidth);
+		std::vector<Sphere> spheres;
+		std::vector<Vector3> motions;
+		for (int64_t i = 0; i < state.GetArg(); ++i) {
+			spheres.push_back(random.MakeSphere(0.2f, 0.5f));
+			motions.push_back(random.Direction() * random.Range(0.0f, 4.0f));
+		}
+		std::vector<CachedOBB> boxes;
+		for (int32_t i = 0; i < 16; ++i) {
+			boxes.push_back(MakeCachedOBB(random.MakeOBB(1.0f, 4.0f)));
+		}
+		int64_t hitCount = 0;
+		while (state.KeepRunning()) {
+			for (size_t i = 0; i < spheres.size(); ++i) {
+				for (const CachedOBB& box : boxes) {
+					SweepHit hit;
+					if (SweepSphere(spheres[i], motions[i], box, hit)) {
+						++hitCount;
+						Bench::DoNotOptimize(hit);
+					}
+				}
+			}
+		}
+		Bench::DoNotOptimize(hitCount);
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg() * static_cast<int64_t>(boxes.size()));
+	}
+	BENCHMARK(Scene_SweepSphereBoxes)->Arg(1024)->Arg(4096);
+
+	/*----------階層----------*/
+
+	// 64本の木に分かれたランダムな階層を作る。親は前に追加したノードから選ぶ
+	void BuildHierarchy(TransformHierarchy& hierarchy, int64_t count)
+	{
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		hierarchy.Reserve(static_cast<size_t>(count));
+		for (int64_t i = 0; i < count; ++i) {
+			uint32_t parent = TransformHierarchy::kNoParent;
+			if (i >= 64) {
+				parent = std::min(static_cast<uint32_t>(random.Range(0.0f, static_cast<float>(i))), static_cast<uint32_t>(i - 1));
+			}
+			Vector3 scale = { random.Range(0.9f, 1.1f), random.Range(0.9f, 1.1f), random.Range(0.9f, 1.1f) };
+			hierarchy.AddNode(parent, scale, MakeRotateEulerQuaternion(random.Rotation()), random.Point());
+		}
+		hierarchy.Update();
+	}
+
+	// 根がすべて動き、全ノードを計算し直すシーン
+	void Scene_TransformHierarchyAllDirty(Bench::State& state)
+	{
+		TransformHierarchy hierarchy(&GetThreadPool());
+		BuildHierarchy(hierarchy, state.GetArg());
+		while (state.KeepRunning()) {
+			for (uint32_t i = 0; i < 64; ++i) {
+				hierarchy.SetLocalTranslate(i, hierarchy.GetLocalTranslate(i));
+			}
+			hierarchy.Update();
+			Bench::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+	}
+	BENCHMARK(Scene_TransformHierarchyAllDirty)->Arg(1024)->Arg(16384)->Arg(65536);
+
+	// ほとんどが静止していて、最後に追加した1%のノード(葉に近い)だけが動くシーン
+	void Scene_TransformHierarchyFewDirty(Bench::State& state)
+	{
+		TransformHierarchy hierarchy(&GetThreadPool());
+		BuildHierarchy(hierarchy, state.GetArg());
+		uint32_t count = hierarchy.GetNodeCount();
+		while (state.KeepRunning()) {
+			for (uint32_t i = count - count / 100; i < count; ++i) {
+				hierarchy.SetLocalTranslate(i, hierarchy.GetLocalTranslate(i));
+			}
+			hierarchy.Update();
+			Bench::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+	}
+	BENCHMARK(Scene_TransformHierarchyFewDirty)->Arg(1024)->Arg(16384)->Arg(65536);
+
+	/*----------レイキャスト----------*/
+
+	std::vector<Triangle> MakeTriangles(int64_t count)
+	{
+		return MakeMany<Triangle>(count, kSeed, [](Bench::RandomPrimitives& random) { return random.MakeTriangle(3.0f); });
+	}
+
+	void Scene_TriangleBVHBuild(Bench::State& state)
+	{
+		std::vector<Triangle> triangles = MakeTriangles(state.GetArg());
+		TriangleBVH bvh;
+		while (state.KeepRunning()) {
+			bvh.Build(triangles);
+			Bench::DoNotOptimize(bvh.GetNodeCount());
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+	}
+	BENCHMARK(Scene_TriangleBVHBuild)->Arg(1024)->Arg(16384)->Arg(131072);
+
+	void Scene_TriangleBVHRayCast(Bench::State& state)
+	{
+		constexpr size_t kRayCount = 4096;
+		std::vector<Triangle> triangles = MakeTriangles(state.GetArg());
+		TriangleBVH bvh;
+		bvh.Build(triangles);
+
+		Bench::RandomPrimitives random(kSeed + 1, WorldHalfWidth(state.GetArg()));
+		std::vector<Ray> rays;
+		for (size_t i = 0; i < kRayCount; ++i) {
+			rays.push_back(random.MakeRay(4.0f * WorldHalfWidth(state.GetArg())));
+		}
+		std::vector<RayHit> hits(kRayCount);
+		while (state.KeepRunning()) {
+			bvh.RayCastBatch(rays, hits);
+			Bench::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.GetIterations() * static_cast<int64_t>(kRayCount));
+	}
+	BENCHMARK(Scene_TriangleBVHRayCast)->Arg(1024)->Arg(16384)->Arg(131072);
+
+	/*----------OBJの読み込み----------*/
+
+	// 1辺gridSize個の正方形を2つずつの三角形に分けた地形をOBJの文字列にする
+	// 面はBlenderの出力と同じく"v/vt/vn"の形で書く
+	std::string MakeGridObj(int64_t gridSize)
+	{
+		std::string text;
+		char line[128];
+		Bench::RandomPrimitives random(kSeed, 1.0f);
+		for (int64_t z = 0; z <= gridSize; ++z) {
+			for (int64_t x = 0; x <= gridSize; ++x) {
+				int length = std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", static_cast<double>(x), static_cast<double>(random.Range(-1.0f, 1.0f)), static_cast<double>(z));
+				text.append(line, static_cast<size_t>(length));
+			}
+		}
+		for (int64_t z = 0; z < gridSize; ++z) {
+			for (int64_t x = 0; x < gridSize; ++x) {
+				int64_t v0 = z * (gridSize + 1) + x + 1;
+				int64_t v1 = v0 + 1;
+				int64_t v2 = v0 + gridSize + 1;
+				int64_t v3 = v2 + 1;
+				int length = std::snprintf(line, sizeof(line), "f %lld/%lld/1 %lld/%lld/1 %lld/%lld/1\nf %lld/%lld/1 %lld/%lld/1 %lld/%lld/1\n",
+					static_cast<long long>(v0), static_cast<long long>(v0), static_cast<long long>(v2), static_cast<long long>(v2), static_cast<long long>(v1), static_cast<long long>(v1),
+					static_cast<long long>(v1), static_cast<long long>(v1), static_cast<long long>(v2), static_cast<long long>(v2), static_cast<long long>(v3), static_cast<long long>(v3));
+				text.append(line, static_cast<size_t>(length));
+			}
+		}
+		return text;
+	}
+
+	// 引数は三角形の数
+	void ParseObjBenchmark(Bench::State& state, ThreadPool* threadPool)
+	{
+		int64_t gridSize = static_cast<int64_t>(std::sqrt(static_cast<double>(state.GetArg() / 2)));
+		std::string text = MakeGridObj(gridSize);
+		ObjMesh mesh;
+		while (state.KeepRunning()) {
+			ParseObj(text, mesh, threadPool);
+			Bench::DoNotOptimize(mesh.indices.data());
+		}
+		state.SetItemsProcessed(state.GetIterations() * static_cast<int64_t>(mesh.GetTriangleCount()));
+		state.SetCounter("bytes_per_second", static_cast<double>(state.GetIterations()) * static_cast<double>(text.size()), true);
+	}
+
+	void Scene_ParseObj(Bench::State& state)
+	{
+		ParseObjBenchmark(state, nullptr);
+	}
+	BENCHMARK(Scene_ParseObj)->Arg(131072)->Arg(1048576);
+
+	void Scene_ParseObjThreaded(Bench::State& state)
+	{
+		ParseObjBenchmark(state, &GetThreadPool());
+	}
+	BENCHMARK(Scene_ParseObjThreaded)->Arg(131072)->Arg(1048576);
+
+	/*----------シーンキャッシュ----------*/
+
+	// 引数は形状の数。球、AABB、OBBを同じ数ずつ置き、AABBはブロードフェーズの木にも入れる
+	struct CachedScene final
+	{
+		std::vector<Sphere> spheres;
+		std::vector<AABB> aabbs;
+		std::vector<OBB> obbs;
+	};
+
+	CachedScene MakeCachedScene(int64_t count)
+	{
+		int64_t countPerType = count / 3;
+		return { MakeSpheres(countPerType), MakeAABBs(countPerType), MakeOBBs(countPerType) };
+	}
+
+	// 元の配列からSoAの配列と木を作る(キャッシュがないときの読み込み)
+	void BuildScene(const CachedScene& scene, SphereBuffer& spheres, AABBBuffer& aabbs, OBBBuffer& obbs, AABBTree& tree)
+	{
+		spheres.Assign(scene.spheres);
+		aabbs.Assign(scene.aabbs);
+		obbs.Assign(scene.obbs);
+		tree.Clear();
+		for (uint32_t i = 0; i < scene.aabbs.size(); ++i) {
+			tree.CreateProxy(scene.aabbs[i], i);
+		}
+	}
+
+	void Scene_BuildSceneFromPrimitives(Bench::State& state)
+	{
+		CachedScene scene = MakeCachedScene(state.GetArg());
+		SphereBuffer spheres;
+		AABBBuffer aabbs;
+		OBBBuffer obbs;
+		AABBTree tree;
+		while (state.KeepRunning()) {
+			BuildScene(scene, spheres, aabbs, obbs, tree);
+			Bench::DoNotOptimize(tree.GetHeight());
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+	}
+	BENCHMARK(Scene_BuildSceneFromPrimitives)->Arg(65536)->Arg(262144);
+
+	// 書き出したファイルを開いて木を取り出すまで。ファイルは計測前に一度書くので、OSのキャッシュに載った状態になる
+	void Scene_LoadSceneCache(Bench::State& state)
+	{
+		std::filesystem::path path = std::filesystem::temp_directory_path() / "MathBenchmark_SceneCache.bin";
+		{
+			CachedScene scene = MakeCachedScene(state.GetArg());
+			SphereBuffer spheres;
+			AABBBuffer aabbs;
+			OBBBuffer obbs;
+			AABBTree tree;
+			BuildScene(scene, spheres, aabbs, obbs, tree);
+			SceneCacheData data{ spheres.View(), aabbs.View(), obbs.View(), {}, {}, &tree };
+			WriteSceneCache(path, data);
+		}
+
+		SceneCache cache;
+		AABBTree tree;
+		while (state.KeepRunning()) {
+			cache.Open(path);
+			cache.LoadAABBTree(tree);
+			Bench::DoNotOptimize(cache.GetSpheres().Count() + cache.GetAABBs().Count() + cache.GetOBBs().Count());
+			Bench::DoNotOptimize(tree.GetHeight());
+		}
+		cache.Close();
+		std::filesystem::remove(path);
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+	}
+	BENCHMARK(Scene_LoadSceneCache)->Arg(65536)->Arg(262144)->Arg(1048576);
+
+	/*----------描画----------*/
+
+	void Scene_TransformPoints(Bench::State& state)
+	{
+		std::vector<Vector3> points = MakeMany<Vector3>(state.GetArg(), kSeed, [](Bench::RandomPrimitives& random) { return random.Point(); });
+		std::vector<Vector3> result(points.size());
+		Camera camera = Bench::MakeCamera();
+		while (state.KeepRunning()) {
+			TransformPoints(points, camera.GetViewProjectionViewportMatrix(), result);
+			Bench::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+		state.SetCounter("vertices_per_second", static_cast<double>(state.GetIterations() * state.GetArg()), true);
+	}
+	BENCHMARK(Scene_TransformPoints)->Arg(1024)->Arg(65536);
+
+	// 球・AABB・OBB・三角形を同じ数ずつ混ぜたシーンを1フレーム分描画する
+	void Scene_DrawPrimitives(Bench::State& state)
+	{
+		int64_t countPerShape = state.GetArg() / 4;
+		Bench::RandomPrimitives random(kSeed, 3.0f);
+		std::vector<Sphere> spheres;
+		std::vector<AABB> aabbs;
+		std::vector<OBB> obbs;
+		std::vector<Triangle> triangles;
+		for (int64_t i = 0; i < countPerShape; ++i) {
+			spheres.push_back(random.MakeSphere(0.1f, 0.5f));
+			aabbs.push_back(random.MakeAABB(0.1f, 0.5f));
+			obbs.push_back(random.MakeOBB(0.1f, 0.5f));
+			triangles.push_back(random.MakeTriangle(1.0f));
+		}
+
+		Camera camera = Bench::MakeCamera();
+		Bench::HeadlessDrawScope scope;
+		size_t vertexCount = 0;
+		while (state.KeepRunning()) {
+			DrawGrid(camera);
+			for (int64_t i = 0; i < countPerShape; ++i) {
+				DrawSphere(spheres[i], camera, 0xFFFFFFFF);
+				DrawAABB(aabbs[i], camera, 0xFFFFFFFF);
+				DrawOBB(obbs[i], camera, 0xFFFFFFFF);
+				DrawTriangle(triangles[i], camera, 0xFFFFFFFF);
+			}
+			vertexCount += scope.Flush();
+		}
+		state.SetItemsProcessed(state.GetIterations() * countPerShape * 4);
+		state.SetCounter("vertices_per_second", static_cast<double>(vertexCount), true);
+	}
+	BENCHMARK(Scene_DrawPrimitives)->Arg(256)->Arg(4096);
+
+	// 広い範囲に置いてほとんどが画面外になるシーン。1つずつ描画する場合とまとめてカリングする場合を比べる
+	void Scene_DrawSpheresMostlyOffscreen(Bench::State& state)
+	{
+		std::vector<Sphere> spheres = MakeSpheres(state.GetArg());
+		Camera camera = Bench::MakeCamera();
+		Bench::HeadlessDrawScope scope;
+		size_t vertexCount = 0;
+		while (state.KeepRunning()) {
+			for (const Sphere& sphere : spheres) {
+				DrawSphere(sphere, camera, 0xFFFFFFFF);
+			}
+			vertexCount += scope.Flush();
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+		state.SetCounter("vertices_per_second", static_cast<double>(vertexCount), true);
+	}
+	BENCHMARK(Scene_DrawSpheresMostlyOffscreen)->Arg(4096)->Arg(65536);
+
+	void Scene_DrawSpheresMostlyOffscreenBatch(Bench::State& state)
+	{
+		SphereBuffer spheres;
+		spheres.Assign(MakeSpheres(state.GetArg()));
+		Camera camera = Bench::MakeCamera();
+		Bench::HeadlessDrawScope scope;
+		size_t vertexCount = 0;
+		while (state.KeepRunning()) {
+			DrawSpheres(spheres.View(), camera, 0xFFFFFFFF);
+			vertexCount += scope.Flush();
+		}
+		state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+		state.SetCounter("vertices_per_second", static_cast<double>(vertexCount), true);
+	}
+	BENCHMARK(Scene_DrawSpheresMostlyOffscreenBatch)->Arg(4096)->Arg(65536);
+
+	// シーン中のランダムな点を順に通るCatmull-Rom曲線を描画する。画面外の区間は分割する前に捨てられる
+	void Scene_DrawCatmullRomPath(Bench::State& state)
+	{
+		std::vector<Vector3> points = MakeMany<Vector3>(state.GetArg(), kSeed, [](Bench::RandomPrimitives& random) { return random.Point(); });
+		Curve path;
+		path.SetCatmullRom(points);
+
+		Camera camera = Bench::MakeCamera();
+		Bench::HeadlessDrawScope scope;
+		size_t vertexCount = 0;
+		while (state.KeepRunning()) {
+			DrawCurve(path, camera, 0xFFFFFFFF);
+			vertexCount += scope.Flush();
+		}
+		state.SetItemsProcessed(state.GetIterations() * static_cast<int64_t>(path.GetSegments().size()));
+		state.SetCounter("vertices_per_second", static_cast<double>(vertexCount), true);
+	}
+	BENCHMARK(Scene_DrawCatmullRomPath)->Arg(256)->Arg(4096);
+}
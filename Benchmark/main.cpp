@@ -0,0 +1,19 @@
+#include "BenchmarkHarness.h"
+#include "Simd.h"
+
+// Mathライブラリのベンチマーク
+// 使い方の例:
+//   MathBenchmark --benchmark_filter=IsCollision --benchmark_out=result.json
+int main(int argc, char** argv)
+{
+	// どの命令セットでビルドしたかを結果に残す
+#if defined(MATH_SIMD_AVX2)
+	Bench::AddCustomContext("math_simd", "avx2");
+#elif defined(MATH_SIMD_SSE2)
+	Bench::AddCustomContext("math_simd", "sse2");
+#else
+	Bench::AddCustomContext("math_simd", "scalar");
+#endif
+
+	return Bench::RunSpecifiedBenchmarks(argc, argv);
+}
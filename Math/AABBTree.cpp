@@ -0,0 +1,556 @@
+#include "AABBTree.h"
+#include "MathFunction.h"
+#include <algorithm>
+
+namespace Math
+{
+	namespace
+	{
+		// 移動量の何倍だけ移動方向へAABBを伸ばしておくか
+		const float kDisplacementMultiplier = 2.0f;
+
+		AABB Fatten(const AABB& aabb, float margin)
+		{
+			Vector3 r = { margin, margin, margin };
+			return { aabb.min - r, aabb.max + r };
+		}
+
+		/// <summary>
+		/// 探索用のスタック。普段は固定長の配列を使い、あふれたときだけヒープに積む
+		/// (Restoreで読み込んだ木のように、高さがkStackSizeに収まると限らない木でも範囲外に書かない)
+		/// </summary>
+		class NodeStack final
+		{
+		public:
+			bool IsEmpty() const { return count_ == 0 && overflow_.empty(); }
+
+			void Push(int32_t nodeId)
+			{
+				if (count_ < AABBTree::kStackSize && overflow_.empty())
+				{
+					stack_[count_++] = nodeId;
+				}
+				else
+				{
+					overflow_.push_back(nodeId);
+				}
+			}
+
+			// あふれた分はあとから積んだものなので、先に取り出す
+			int32_t Pop()
+			{
+				if (!overflow_.empty())
+				{
+					int32_t nodeId = overflow_.back();
+					overflow_.pop_back();
+					return nodeId;
+				}
+				return stack_[--count_];
+			}
+
+		private:
+			int32_t stack_[AABBTree::kStackSize];
+			int32_t count_ = 0;
+			std::vector<int32_t> overflow_;
+		};
+	}
+
+	AABBTree::AABBTree(float margin) : margin_(margin)
+	{
+	}
+
+	int32_t AABBTree::CreateProxy(const AABB& aabb, uint32_t userData)
+	{
+		int32_t proxyId = AllocateNode();
+		nodes_[proxyId].aabb = Fatten(aabb, margin_);
+		nodes_[proxyId].userData = userData;
+		nodes_[proxyId].height = 0;
+		InsertLeaf(proxyId);
+		++proxyCount_;
+		return proxyId;
+	}
+
+	void AABBTree::DestroyProxy(int32_t proxyId)
+	{
+		assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+		assert(nodes_[proxyId].IsLeaf());
+		RemoveLeaf(proxyId);
+		FreeNode(proxyId);
+		--proxyCount_;
+	}
+
+	bool AABBTree::MoveProxy(int32_t proxyId, const AABB& aabb, const Vector3& displacement)
+	{
+		assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+		assert(nodes_[proxyId].IsLeaf());
+
+		// 太らせたうえで移動方向に伸ばす
+		AABB fatAABB = Fatten(aabb, margin_);
+		Vector3 d = displacement * kDisplacementMultiplier;
+		(d.x < 0.0f ? fatAABB.min.x : fatAABB.max.x) += d.x;
+		(d.y < 0.0f ? fatAABB.min.y : fatAABB.max.y) += d.y;
+		(d.z < 0.0f ? fatAABB.min.z : fatAABB.max.z) += d.z;
+
+		const AABB& treeAABB = nodes_[proxyId].aabb;
+		if (Contains(treeAABB, aabb))
+		{
+			// 今のAABBに収まっていて、大きすぎもしなければ組み替えない
+			AABB hugeAABB = Fatten(fatAABB, 4.0f * margin_);
+			if (Contains(hugeAABB, treeAABB))
+			{
+				return false;
+			}
+		}
+
+		RemoveLeaf(proxyId);
+		nodes_[proxyId].aabb = fatAABB;
+		InsertLeaf(proxyId);
+		return true;
+	}
+
+	void AABBTree::Query(const AABB& aabb, std::vector<int32_t>& result) const
+	{
+		if (root_ == kNullNode)
+		{
+			return;
+		}
+
+		NodeStack stack;
+		stack.Push(root_);
+
+		while (!stack.IsEmpty())
+		{
+			const Node& node = nodes_[stack.Pop()];
+			if (!IsCollision(node.aabb, aabb))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				result.push_back(static_cast<int32_t>(&node - nodes_.data()));
+			}
+			else
+			{
+				stack.Push(node.child1);
+				stack.Push(node.child2);
+			}
+		}
+	}
+
+	void AABBTree::QueryPairs(std::vector<std::pair<int32_t, int32_t>>& pairs) const
+	{
+		if (root_ == kNullNode)
+		{
+			return;
+		}
+
+		// 葉ごとに木をたどり、IDの小さい方から見た組だけを残して重複を除く
+		NodeStack stack;
+		for (int32_t leaf = 0; leaf < static_cast<int32_t>(nodes_.size()); ++leaf)
+		{
+			if (nodes_[leaf].height != 0)
+			{
+				continue;
+			}
+
+			const AABB& leafAABB = nodes_[leaf].aabb;
+			stack.Push(root_);
+			while (!stack.IsEmpty())
+			{
+				int32_t nodeId = stack.Pop();
+				const Node& node = nodes_[nodeId];
+				if (!IsCollision(node.aabb, leafAABB))
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					if (leaf < nodeId)
+					{
+						pairs.emplace_back(leaf, nodeId);
+					}
+				}
+				else
+				{
+					stack.Push(node.child1);
+					stack.Push(node.child2);
+				}
+			}
+		}
+	}
+
+	void AABBTree::Clear()
+	{
+		nodes_.clear();
+		root_ = kNullNode;
+		freeList_ = kNullNode;
+		proxyCount_ = 0;
+	}
+
+	bool AABBTree::Restore(std::span<const Node> nodes, int32_t root, int32_t freeList, int32_t proxyCount, float margin)
+	{
+		// ファイルから読んだ木でも、範囲外を読んだり探索が終わらなくなったりしないように形をすべて確かめる
+		if (nodes.size() > static_cast<size_t>(INT32_MAX))
+		{
+			return false;
+		}
+		int32_t nodeCount = static_cast<int32_t>(nodes.size());
+		auto isValidId = [nodeCount](int32_t id) { return 0 <= id && id < nodeCount; };
+		if (root != kNullNode && (!isValidId(root) || nodes[root].parent != kNullNode))
+		{
+			return false;
+		}
+
+		// 根からたどり、どのノードにも1回ずつ着くこと(循環や共有がない)、親子のリンクが両方向で合うこと、
+		// 葉の高さが0で、内部ノードの高さが子の高さの大きい方 + 1であることを確かめる
+		std::vector<uint8_t> isReached(nodes.size(), 0);
+		int32_t reachedCount = 0;
+		int32_t leafCount = 0;
+		std::vector<int32_t> stack;
+		if (root != kNullNode)
+		{
+			stack.push_back(root);
+		}
+		while (!stack.empty())
+		{
+			int32_t nodeId = stack.back();
+			stack.pop_back();
+			if (isReached[nodeId])
+			{
+				return false;
+			}
+			isReached[nodeId] = 1;
+			++reachedCount;
+
+			const Node& node = nodes[nodeId];
+			if (node.IsLeaf())
+			{
+				if (node.child2 != kNullNode || node.height != 0)
+				{
+					return false;
+				}
+				++leafCount;
+				continue;
+			}
+			if (!isValidId(node.child1) || !isValidId(node.child2))
+			{
+				return false;
+			}
+			const Node& child1 = nodes[node.child1];
+			const Node& child2 = nodes[node.child2];
+			if (child1.parent != nodeId || child2.parent != nodeId || node.height != 1 + std::max(child1.height, child2.height))
+			{
+				return false;
+			}
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+
+		// 空きリストは木にないノードだけを1回ずつたどって終わること
+		for (int32_t nodeId = freeList; nodeId != kNullNode; nodeId = nodes[nodeId].parent)
+		{
+			if (!isValidId(nodeId) || isReached[nodeId] || nodes[nodeId].height != -1)
+			{
+				return false;
+			}
+			isReached[nodeId] = 1;
+			++reachedCount;
+		}
+
+		// どちらにもないノードがあると、QueryPairsが高さを見て葉として扱ってしまう
+		if (reachedCount != nodeCount || leafCount != proxyCount)
+		{
+			return false;
+		}
+
+		nodes_.assign(nodes.begin(), nodes.end());
+		root_ = root;
+		freeList_ = freeList;
+		proxyCount_ = proxyCount;
+		margin_ = margin;
+		return true;
+	}
+
+	const AABB& AABBTree::GetFatAABB(int32_t proxyId) const
+	{
+		assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+		return nodes_[proxyId].aabb;
+	}
+
+	uint32_t AABBTree::GetUserData(int32_t proxyId) const
+	{
+		assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+		return nodes_[proxyId].userData;
+	}
+
+	int32_t AABBTree::GetHeight() const
+	{
+		return root_ == kNullNode ? 0 : nodes_[root_].height;
+	}
+
+	int32_t AABBTree::AllocateNode()
+	{
+		int32_t nodeId;
+		if (freeList_ == kNullNode)
+		{
+			nodeId = static_cast<int32_t>(nodes_.size());
+			nodes_.emplace_back();
+		}
+		else
+		{
+			nodeId = freeList_;
+			freeList_ = nodes_[nodeId].parent;
+		}
+
+		Node& node = nodes_[nodeId];
+		node.parent = kNullNode;
+		node.child1 = kNullNode;
+		node.child2 = kNullNode;
+		node.height = 0;
+		node.userData = 0;
+		return nodeId;
+	}
+
+	void AABBTree::FreeNode(int32_t nodeId)
+	{
+		nodes_[nodeId].parent = freeList_;
+		nodes_[nodeId].height = -1;
+		freeList_ = nodeId;
+	}
+
+	void AABBTree::InsertLeaf(int32_t leaf)
+	{
+		if (root_ == kNullNode)
+		{
+			root_ = leaf;
+			nodes_[root_].parent = kNullNode;
+			return;
+		}
+
+		// 表面積の増え方が最も小さくなる兄弟ノードを探す
+		AABB leafAABB = nodes_[leaf].aabb;
+		int32_t index = root_;
+		while (!nodes_[index].IsLeaf())
+		{
+			int32_t child1 = nodes_[index].child1;
+			int32_t child2 = nodes_[index].child2;
+
+			float area = SurfaceArea(nodes_[index].aabb);
+			float combinedArea = SurfaceArea(Union(nodes_[index].aabb, leafAABB));
+
+			// ここに新しい親を作るコスト
+			float cost = 2.0f * combinedArea;
+
+			// 子へ降りる場合に祖先が大きくなる分のコスト
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto descendCost = [&](int32_t child)
+			{
+				float newArea = SurfaceArea(Union(leafAABB, nodes_[child].aabb));
+				if (nodes_[child].IsLeaf())
+				{
+					return newArea + inheritanceCost;
+				}
+				return (newArea - SurfaceArea(nodes_[child].aabb)) + inheritanceCost;
+			};
+			float cost1 = descendCost(child1);
+			float cost2 = descendCost(child2);
+
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+			index = cost1 < cost2 ? child1 : child2;
+		}
+		int32_t sibling = index;
+
+		// 新しい親を作って兄弟と葉をぶら下げる
+		int32_t oldParent = nodes_[sibling].parent;
+		int32_t newParent = AllocateNode();
+		nodes_[newParent].parent = oldParent;
+		nodes_[newParent].aabb = Union(leafAABB, nodes_[sibling].aabb);
+		nodes_[newParent].height = nodes_[sibling].height + 1;
+		nodes_[newParent].child1 = sibling;
+		nodes_[newParent].child2 = leaf;
+		nodes_[sibling].parent = newParent;
+		nodes_[leaf].parent = newParent;
+
+		if (oldParent != kNullNode)
+		{
+			if (nodes_[oldParent].child1 == sibling)
+			{
+				nodes_[oldParent].child1 = newParent;
+			}
+			else
+			{
+				nodes_[oldParent].child2 = newParent;
+			}
+		}
+		else
+		{
+			root_ = newParent;
+		}
+
+		// 根までさかのぼってAABBと高さを直す
+		index = nodes_[leaf].parent;
+		while (index != kNullNode)
+		{
+			index = Balance(index);
+			Node& node = nodes_[index];
+			node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+			node.aabb = Union(nodes_[node.child1].aabb, nodes_[node.child2].aabb);
+			index = node.parent;
+		}
+	}
+
+	void AABBTree::RemoveLeaf(int32_t leaf)
+	{
+		if (leaf == root_)
+		{
+			root_ = kNullNode;
+			return;
+		}
+
+		int32_t parent = nodes_[leaf].parent;
+		int32_t grandParent = nodes_[parent].parent;
+		int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+		if (grandParent == kNullNode)
+		{
+			root_ = sibling;
+			nodes_[sibling].parent = kNullNode;
+			FreeNode(parent);
+			return;
+		}
+
+		// 親を消して兄弟を祖父につなぎ直す
+		if (nodes_[grandParent].child1 == parent)
+		{
+			nodes_[grandParent].child1 = sibling;
+		}
+		else
+		{
+			nodes_[grandParent].child2 = sibling;
+		}
+		nodes_[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		int32_t index = grandParent;
+		while (index != kNullNode)
+		{
+			index = Balance(index);
+			Node& node = nodes_[index];
+			node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+			node.aabb = Union(nodes_[node.child1].aabb, nodes_[node.child2].aabb);
+			index = node.parent;
+		}
+	}
+
+	int32_t AABBTree::Balance(int32_t iA)
+	{
+		// 左右の高さの差が2以上なら回転して持ち上げる。新しい部分木の根を返す
+		Node& A = nodes_[iA];
+		if (A.IsLeaf() || A.height < 2)
+		{
+			return iA;
+		}
+
+		int32_t iB = A.child1;
+		int32_t iC = A.child2;
+		Node& B = nodes_[iB];
+		Node& C = nodes_[iC];
+		int32_t balance = C.height - B.height;
+
+		// Cを持ち上げる
+		if (balance > 1)
+		{
+			int32_t iF = C.child1;
+			int32_t iG = C.child2;
+			Node& F = nodes_[iF];
+			Node& G = nodes_[iG];
+
+			C.child1 = iA;
+			C.parent = A.parent;
+			A.parent = iC;
+
+			if (C.parent != kNullNode)
+			{
+				(nodes_[C.parent].child1 == iA ? nodes_[C.parent].child1 : nodes_[C.parent].child2) = iC;
+			}
+			else
+			{
+				root_ = iC;
+			}
+
+			if (F.height > G.height)
+			{
+				C.child2 = iF;
+				A.child2 = iG;
+				G.parent = iA;
+				A.aabb = Union(B.aabb, G.aabb);
+				C.aabb = Union(A.aabb, F.aabb);
+				A.height = 1 + std::max(B.height, G.height);
+				C.height = 1 + std::max(A.height, F.height);
+			}
+			else
+			{
+				C.child2 = iG;
+				A.child2 = iF;
+				F.parent = iA;
+				A.aabb = Union(B.aabb, F.aabb);
+				C.aabb = Union(A.aabb, G.aabb);
+				A.height = 1 + std::max(B.height, F.height);
+				C.height = 1 + std::max(A.height, G.height);
+			}
+			return iC;
+		}
+
+		// Bを持ち上げる
+		if (balance < -1)
+		{
+			int32_t iD = B.child1;
+			int32_t iE = B.child2;
+			Node& D = nodes_[iD];
+			Node& E = nodes_[iE];
+
+			B.child1 = iA;
+			B.parent = A.parent;
+			A.parent = iB;
+
+			if (B.parent != kNullNode)
+			{
+				(nodes_[B.parent].child1 == iA ? nodes_[B.parent].child1 : nodes_[B.parent].child2) = iB;
+			}
+			else
+			{
+				root_ = iB;
+			}
+
+			if (D.height > E.height)
+			{
+				B.child2 = iD;
+				A.child1 = iE;
+				E.parent = iA;
+				A.aabb = Union(C.aabb, E.aabb);
+				B.aabb = Union(A.aabb, D.aabb);
+				A.height = 1 + std::max(C.height, E.height);
+				B.height = 1 + std::max(A.height, D.height);
+			}
+			else
+			{
+				B.child2 = iE;
+				A.child1 = iD;
+				D.parent = iA;
+				A.aabb = Union(C.aabb, D.aabb);
+				B.aabb = Union(A.aabb, E.aabb);
+				A.height = 1 + std::max(C.height, D.height);
+				B.height = 1 + std::max(A.height, E.height);
+			}
+			return iB;
+		}
+
+		return iA;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "AABB.h"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Math
+{
+	/// <summary>
+	/// AABBを葉に持つ動的なBVH(ブロードフェーズ用)
+	/// 葉には少し太らせたAABBを保存するので、小さな移動では木を組み替えない
+	/// 返ってきた候補に対してだけIsCollisionを呼ぶ想定
+	/// </summary>
+	class AABBTree final
+	{
+	public:
+		static constexpr int32_t kNullNode = -1;
+		static constexpr int32_t kStackSize = 256;	// 探索用スタックの固定部分の大きさ(木が高すぎるときはヒープを使う)
+
+		struct Node final
+		{
+			AABB aabb;
+			int32_t parent = kNullNode;		// 未使用のときは空きリストの次のノード
+			int32_t child1 = kNullNode;
+			int32_t child2 = kNullNode;
+			int32_t height = -1;			// 葉は0、未使用は-1
+			uint32_t userData = 0;
+
+			bool IsLeaf() const { return child1 == kNullNode; }
+		};
+
+		/// <param name="margin">葉のAABBを太らせる量</param>
+		explicit AABBTree(float margin = 0.1f);
+
+		// 葉を追加してIDを返す
+		int32_t CreateProxy(const AABB& aabb, uint32_t userData);
+
+		// 葉を削除する
+		void DestroyProxy(int32_t proxyId);
+
+		// 葉を移動する。太らせたAABBからはみ出したときだけ入れ直してtrueを返す
+		bool MoveProxy(int32_t proxyId, const AABB& aabb, const Vector3& displacement);
+
+		// 指定したAABBと重なる葉をすべて求める
+		void Query(const AABB& aabb, std::vector<int32_t>& result) const;
+
+		// 重なっている葉の組をすべて求める(first < second)
+		void QueryPairs(std::vector<std::pair<int32_t, int32_t>>& pairs) const;
+
+		void Clear();
+
+		const AABB& GetFatAABB(int32_t proxyId) const;
+		uint32_t GetUserData(int32_t proxyId) const;
+		int32_t GetHeight() const;
+		int32_t GetProxyCount() const { return proxyCount_; }
+
+		/*----------木をそのまま保存・復元する(SceneCache用)----------*/
+		std::span<const Node> GetNodes() const { return nodes_; }
+		int32_t GetRoot() const { return root_; }
+		int32_t GetFreeList() const { return freeList_; }
+		float GetMargin() const { return margin_; }
+		// GetNodesなどで取り出した木を組み直さずにそのまま使う。葉のIDも保存したときと同じになる
+		// 根からたどって木の形(親子のリンク、高さ、空きリスト、葉の数)を確かめ、壊れているときは何もせずにfalseを返す
+		bool Restore(std::span<const Node> nodes, int32_t root, int32_t freeList, int32_t proxyCount, float margin);
+
+	private:
+		int32_t AllocateNode();
+		void FreeNode(int32_t nodeId);
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+		int32_t Balance(int32_t iA);
+
+		std::vector<Node> nodes_;
+		int32_t root_ = kNullNode;
+		int32_t freeList_ = kNullNode;
+		int32_t proxyCount_ = 0;
+		float margin_;
+	};
+}
@@ -0,0 +1,330 @@
+#include "BallWorld.h"
+#include "MathFunction.h"
+#include "SweptCollision.h"
+#include "ThreadPool.h"
+
+namespace Math
+{
+	namespace
+	{
+		// 1回のUpdateで進める最大ステップ数。重いフレームが続いても処理が追いつかなくならないようにする
+		const int kMaxStepsPerUpdate = 8;
+
+		// ParallelForで1回に処理する数
+		const size_t kBallGrainSize = 1024;
+		const size_t kPairGrainSize = 512;
+	}
+
+	BallWorld::BallWorld(float fixedDeltaTime, ThreadPool* threadPool)
+		: fixedDeltaTime_(fixedDeltaTime), threadPool_(threadPool)
+	{
+	}
+
+	uint32_t BallWorld::AddBall(const Ball& ball)
+	{
+		uint32_t index = GetBallCount();
+		for (auto* component : { &position_, &previousPosition_, &velocity_, &acceleration_ })
+		{
+			for (auto& c : *component) { c.push_back(0.0f); }
+		}
+		inverseMass_.push_back(0.0f);
+		mass_.push_back(0.0f);
+		radius_.push_back(0.0f);
+		color_.push_back(0);
+		SetBall(index, ball);
+		return index;
+	}
+
+	void BallWorld::AddPlane(const Plane& plane)
+	{
+		planes_.push_back(plane);
+	}
+
+	void BallWorld::AddBox(const OBB& box)
+	{
+		boxes_.push_back(MakeCachedOBB(box));
+	}
+
+	void BallWorld::Clear()
+	{
+		for (auto* component : { &position_, &previousPosition_, &velocity_, &acceleration_ })
+		{
+			for (auto& c : *component) { c.clear(); }
+		}
+		inverseMass_.clear();
+		mass_.clear();
+		radius_.clear();
+		color_.clear();
+		planes_.clear();
+		boxes_.clear();
+		accumulator_ = 0.0f;
+	}
+
+	Ball BallWorld::GetBall(uint32_t index) const
+	{
+		Ball ball{};
+		ball.position = { position_[0][index], position_[1][index], position_[2][index] };
+		ball.velocity = { velocity_[0][index], velocity_[1][index], velocity_[2][index] };
+		ball.acceleration = { acceleration_[0][index], acceleration_[1][index], acceleration_[2][index] };
+		ball.mass = mass_[index];
+		ball.radius = radius_[index];
+		ball.color = color_[index];
+		return ball;
+	}
+
+	void BallWorld::SetBall(uint32_t index, const Ball& ball)
+	{
+		position_[0][index] = ball.position.x;
+		position_[1][index] = ball.position.y;
+		position_[2][index] = ball.position.z;
+		velocity_[0][index] = ball.velocity.x;
+		velocity_[1][index] = ball.velocity.y;
+		velocity_[2][index] = ball.velocity.z;
+		acceleration_[0][index] = ball.acceleration.x;
+		acceleration_[1][index] = ball.acceleration.y;
+		acceleration_[2][index] = ball.acceleration.z;
+		mass_[index] = ball.mass;
+		inverseMass_[index] = ball.mass > 0.0f ? 1.0f / ball.mass : 0.0f;
+		radius_[index] = ball.radius;
+		color_[index] = ball.color;
+	}
+
+	void BallWorld::Update(float deltaTime)
+	{
+		accumulator_ += deltaTime;
+
+		int steps = 0;
+		while (accumulator_ >= fixedDeltaTime_ && steps < kMaxStepsPerUpdate)
+		{
+			Step();
+			accumulator_ -= fixedDeltaTime_;
+			++steps;
+		}
+
+		// 追いつけなかった分は捨てる
+		if (steps == kMaxStepsPerUpdate)
+		{
+			accumulator_ = 0.0f;
+		}
+	}
+
+	void BallWorld::Step()
+	{
+		const size_t count = GetBallCount();
+
+		// 積分
+		ParallelFor(threadPool_, count, kBallGrainSize, [this](size_t begin, size_t end) { Integrate(begin, end); });
+
+		// ボール同士。グリッドの更新、組の検索、応答は並列に求め、書き込みだけ1スレッドで行う
+		grid_.Update(position_[0], position_[1], position_[2], radius_, threadPool_);
+		grid_.FindPairs(pairs_, threadPool_);
+		contacts_.resize(pairs_.size());
+		ParallelFor(threadPool_, pairs_.size(), kPairGrainSize, [this](size_t begin, size_t end) { SolveBallContacts(begin, end); });
+		ApplyBallContacts();
+
+		// 箱と平面。ボール同士の押し戻しでめり込まないように最後に行う
+		if (!boxes_.empty())
+		{
+			ParallelFor(threadPool_, count, kBallGrainSize, [this](size_t begin, size_t end) { ResolveBoxes(begin, end); });
+		}
+		ParallelFor(threadPool_, count, kBallGrainSize, [this](size_t begin, size_t end) { ResolvePlanes(begin, end); });
+	}
+
+	void BallWorld::Integrate(size_t begin, size_t end)
+	{
+		// 半陰的オイラー法: 先に速度を更新し、新しい速度で位置を進める
+		const float dt = fixedDeltaTime_;
+		const float gravity[3] = { gravity_.x, gravity_.y, gravity_.z };
+		for (int c = 0; c < 3; ++c)
+		{
+			float* position = position_[c].data();
+			float* previousPosition = previousPosition_[c].data();
+			float* velocity = velocity_[c].data();
+			const float* acceleration = acceleration_[c].data();
+			const float* inverseMass = inverseMass_.data();
+			for (size_t i = begin; i < end; ++i)
+			{
+				float move = inverseMass[i] > 0.0f ? 1.0f : 0.0f;
+				previousPosition[i] = position[i];
+				velocity[i] += (acceleration[i] + gravity[c]) * dt * move;
+				position[i] += velocity[i] * dt * move;
+			}
+		}
+	}
+
+	void BallWorld::ResolveBoxes(size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (inverseMass_[i] == 0.0f)
+			{
+				continue;
+			}
+
+			// ステップ開始時の位置から今の位置までの移動で、最初に当たる箱を探す
+			Vector3 previousPosition = { previousPosition_[0][i], previousPosition_[1][i], previousPosition_[2][i] };
+			Vector3 position = { position_[0][i], position_[1][i], position_[2][i] };
+			Vector3 velocity = { velocity_[0][i], velocity_[1][i], velocity_[2][i] };
+			Sphere sphere = { previousPosition, radius_[i] };
+			Vector3 motion = position - previousPosition;
+
+			SweepHit firstHit{};
+			firstHit.t = 2.0f;
+			for (const CachedOBB& box : boxes_)
+			{
+				SweepHit hit;
+				if (SweepSphere(sphere, motion, box, hit) && hit.t < firstHit.t)
+				{
+					firstHit = hit;
+				}
+			}
+			if (firstHit.t > 1.0f)
+			{
+				continue;
+			}
+
+			if (firstHit.t > 0.0f)
+			{
+				// 当たった位置で止める
+				position = previousPosition + motion * firstHit.t;
+			}
+			else
+			{
+				// 動き始めからめり込んでいれば表面まで押し戻す
+				ContactManifold manifold;
+				for (const CachedOBB& box : boxes_)
+				{
+					if (IsCollision(box, Sphere{ position, radius_[i] }, manifold))
+					{
+						position += manifold.normal * manifold.depth;
+					}
+				}
+			}
+
+			// 箱に向かっているなら反射させる
+			if (Dot(velocity, firstHit.normal) < 0.0f)
+			{
+				Vector3 reflected = Reflect(velocity, firstHit.normal);
+				velocity = reflected - firstHit.normal * ((1.0f - restitution_) * Dot(reflected, firstHit.normal));
+			}
+
+			position_[0][i] = position.x;
+			position_[1][i] = position.y;
+			position_[2][i] = position.z;
+			velocity_[0][i] = velocity.x;
+			velocity_[1][i] = velocity.y;
+			velocity_[2][i] = velocity.z;
+		}
+	}
+
+	void BallWorld::ResolvePlanes(size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (inverseMass_[i] == 0.0f)
+			{
+				continue;
+			}
+
+			Vector3 previousPosition = { previousPosition_[0][i], previousPosition_[1][i], previousPosition_[2][i] };
+			Vector3 position = { position_[0][i], position_[1][i], position_[2][i] };
+			Vector3 velocity = { velocity_[0][i], velocity_[1][i], velocity_[2][i] };
+			for (const Plane& plane : planes_)
+			{
+				// ステップ開始時に中心があった側を表とする(SweepSphereと同じ)
+				// 1ステップで平面を飛び越えても元の側に戻り、裏側にいるボールは裏側に留まる
+				float side = Dot(plane.normal, previousPosition) - plane.distance >= 0.0f ? 1.0f : -1.0f;
+				Vector3 normal = plane.normal * side;
+				float distance = (Dot(plane.normal, position) - plane.distance) * side;
+				if (distance >= radius_[i])
+				{
+					continue;
+				}
+
+				// 表側に押し戻し、平面に向かっているなら反射させる
+				position += normal * (radius_[i] - distance);
+				if (Dot(velocity, normal) < 0.0f)
+				{
+					Vector3 reflected = Reflect(velocity, normal);
+					velocity = reflected - normal * ((1.0f - restitution_) * Dot(reflected, normal));
+				}
+			}
+
+			position_[0][i] = position.x;
+			position_[1][i] = position.y;
+			position_[2][i] = position.z;
+			velocity_[0][i] = velocity.x;
+			velocity_[1][i] = velocity.y;
+			velocity_[2][i] = velocity.z;
+		}
+	}
+
+	void BallWorld::SolveBallContacts(size_t begin, size_t end)
+	{
+		for (size_t k = begin; k < end; ++k)
+		{
+			BallContact& contact = contacts_[k];
+			contact.hit = false;
+
+			const uint32_t a = pairs_[k].first;
+			const uint32_t b = pairs_[k].second;
+			const float inverseMassSum = inverseMass_[a] + inverseMass_[b];
+			if (inverseMassSum == 0.0f)
+			{
+				continue;
+			}
+
+			Sphere sphereA = { { position_[0][a], position_[1][a], position_[2][a] }, radius_[a] };
+			Sphere sphereB = { { position_[0][b], position_[1][b], position_[2][b] }, radius_[b] };
+			if (!IsCollision(sphereA, sphereB))
+			{
+				continue;
+			}
+
+			// aからbへの法線
+			Vector3 diff = Subtract(sphereB.center, sphereA.center);
+			float distance = Length(diff);
+			Vector3 normal = distance > 0.0f ? diff / distance : Vector3{ 0.0f, 1.0f, 0.0f };
+
+			contact.hit = true;
+			contact.correction = normal * ((sphereA.radius + sphereB.radius - distance) / inverseMassSum);
+			contact.impulse = {};
+
+			// 相対速度を法線で反射させ、反発係数の分だけ変化させる
+			Vector3 relativeVelocity = {
+				velocity_[0][b] - velocity_[0][a],
+				velocity_[1][b] - velocity_[1][a],
+				velocity_[2][b] - velocity_[2][a]
+			};
+			if (Dot(relativeVelocity, normal) < 0.0f)
+			{
+				Vector3 reflected = Reflect(relativeVelocity, normal);
+				contact.impulse = (reflected - relativeVelocity) * ((1.0f + restitution_) * 0.5f / inverseMassSum);
+			}
+		}
+	}
+
+	void BallWorld::ApplyBallContacts()
+	{
+		for (size_t k = 0; k < contacts_.size(); ++k)
+		{
+			const BallContact& contact = contacts_[k];
+			if (!contact.hit)
+			{
+				continue;
+			}
+
+			const uint32_t a = pairs_[k].first;
+			const uint32_t b = pairs_[k].second;
+			const float impulse[3] = { contact.impulse.x, contact.impulse.y, contact.impulse.z };
+			const float correction[3] = { contact.correction.x, contact.correction.y, contact.correction.z };
+			for (int c = 0; c < 3; ++c)
+			{
+				velocity_[c][a] -= impulse[c] * inverseMass_[a];
+				velocity_[c][b] += impulse[c] * inverseMass_[b];
+				position_[c][a] -= correction[c] * inverseMass_[a];
+				position_[c][b] += correction[c] * inverseMass_[b];
+			}
+		}
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "Ball.h"
+#include "CachedOBB.h"
+#include "OBB.h"
+#include "Plane.h"
+#include "SpatialHashGrid.h"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Math
+{
+	class ThreadPool;
+
+	/// <summary>
+	/// ボールの物理ワールド
+	/// ボールはSoA形式で持ち、固定時間刻みの半陰的オイラー法で積分する
+	/// </summary>
+	class BallWorld final
+	{
+	public:
+		/// <param name="fixedDeltaTime">1ステップの時間</param>
+		/// <param name="threadPool">並列化に使うスレッドプール。nullptrなら単一スレッド</param>
+		explicit BallWorld(float fixedDeltaTime = 1.0f / 60.0f, ThreadPool* threadPool = nullptr);
+
+		uint32_t AddBall(const Ball& ball);
+		// 平面は両面とも壁になる。ボールはステップ開始時に中心があった側に押し戻す
+		void AddPlane(const Plane& plane);
+		// 動かない箱を追加する。ボールは1ステップの移動全体で判定するので、速くてもすり抜けない
+		void AddBox(const OBB& box);
+		void Clear();
+
+		Ball GetBall(uint32_t index) const;
+		void SetBall(uint32_t index, const Ball& ball);
+		uint32_t GetBallCount() const { return static_cast<uint32_t>(radius_.size()); }
+
+		void SetGravity(const Vector3& gravity) { gravity_ = gravity; }
+		void SetRestitution(float restitution) { restitution_ = restitution; }
+
+		// 経過時間をためて、固定時間刻みで必要な回数だけStepを呼ぶ
+		void Update(float deltaTime);
+
+		// 1ステップ進める
+		void Step();
+
+		std::span<const float> GetPositionX() const { return position_[0]; }
+		std::span<const float> GetPositionY() const { return position_[1]; }
+		std::span<const float> GetPositionZ() const { return position_[2]; }
+		std::span<const float> GetRadius() const { return radius_; }
+
+	private:
+		// 1組のボールの衝突応答
+		// 2つ目には逆質量を掛けて足し、1つ目からは引く
+		struct BallContact final
+		{
+			Vector3 impulse;		// 力積
+			Vector3 correction;		// めり込みの押し戻し
+			bool hit;
+		};
+
+		void Integrate(size_t begin, size_t end);
+		void ResolveBoxes(size_t begin, size_t end);
+		void ResolvePlanes(size_t begin, size_t end);
+		void SolveBallContacts(size_t begin, size_t end);
+		void ApplyBallContacts();
+
+		float fixedDeltaTime_;
+		float accumulator_ = 0.0f;
+		float restitution_ = 0.8f;
+		Vector3 gravity_ = { 0.0f, -9.8f, 0.0f };
+		ThreadPool* threadPool_;
+
+		// SoA形式のボール
+		std::vector<float> position_[3];
+		std::vector<float> previousPosition_[3];	// ステップ開始時の位置(連続衝突判定用)
+		std::vector<float> velocity_[3];
+		std::vector<float> acceleration_[3];
+		std::vector<float> inverseMass_;	// 質量が0以下なら動かないボールとして0を入れる
+		std::vector<float> mass_;
+		std::vector<float> radius_;
+		std::vector<unsigned int> color_;
+
+		std::vector<Plane> planes_;
+		std::vector<CachedOBB> boxes_;
+
+		SpatialHashGrid grid_;
+		std::vector<std::pair<uint32_t, uint32_t>> pairs_;
+		std::vector<BallContact> contacts_;
+	};
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Vector3.h"
+
+//衝突判定用に前計算したOBB。OBBが動いたときにMakeCachedOBBで作り直す
+//向きは正規直交であること(ワールド -> ローカルの変換を回転の転置で作るため)
+struct CachedOBB final
+{
+	Vector3 center;			//!<中心点
+	Vector3 axes[3];		//!<座標軸(正規直交)
+	Vector3 halfExtents;	//!<各軸方向の半分の大きさ
+	Matrix4x4 worldToLocal;	//!<ワールド座標系からOBBのローカル座標系への変換行列
+};
+
+//OBB同士がめり込んでいる量
+struct OBBPenetration final
+{
+	Vector3 axis;	//!<めり込みが最小になる軸(正規化済み、1つ目のOBBから2つ目のOBBへ向かう向き)
+	float depth;	//!<その軸でのめり込みの深さ
+	int axisIndex;	//!<軸の種類。0-2: 1つ目の面の軸、3-5: 2つ目の面の軸、6-14: 辺同士の軸(6 + 1つ目の軸 * 3 + 2つ目の軸)
+};
@@ -0,0 +1,80 @@
+#include "Camera.h"
+#include "MathFunction.h"
+
+namespace Math
+{
+	Camera::Camera()
+		: viewMatrix_(MakeIdentity()), projectionMatrix_(MakeIdentity()), viewportMatrix_(MakeIdentity())
+	{
+	}
+
+	void Camera::SetTransform(const Vector3& rotate, const Vector3& translate)
+	{
+		SetViewMatrix(InverseAffine(MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotate, translate)));
+	}
+
+	void Camera::SetPerspective(float fovY, float aspectRatio, float nearClip, float farClip)
+	{
+		SetProjectionMatrix(MakePerspectiveFovMatrix(fovY, aspectRatio, nearClip, farClip));
+	}
+
+	void Camera::SetViewport(float left, float top, float width, float height, float minDepth, float maxDepth)
+	{
+		SetViewportMatrix(MakeViewportMatrix(left, top, width, height, minDepth, maxDepth));
+	}
+
+	void Camera::SetViewMatrix(const Matrix4x4& viewMatrix)
+	{
+		viewMatrix_ = viewMatrix;
+		isViewProjectionDirty_ = true;
+		isViewProjectionViewportDirty_ = true;
+		isFrustumDirty_ = true;
+		++version_;
+	}
+
+	void Camera::SetProjectionMatrix(const Matrix4x4& projectionMatrix)
+	{
+		projectionMatrix_ = projectionMatrix;
+		isViewProjectionDirty_ = true;
+		isViewProjectionViewportDirty_ = true;
+		isFrustumDirty_ = true;
+		++version_;
+	}
+
+	void Camera::SetViewportMatrix(const Matrix4x4& viewportMatrix)
+	{
+		viewportMatrix_ = viewportMatrix;
+		isViewProjectionViewportDirty_ = true;
+		++version_;
+	}
+
+	const Matrix4x4& Camera::GetViewProjectionMatrix() const
+	{
+		if (isViewProjectionDirty_)
+		{
+			viewProjectionMatrix_ = Multiply(viewMatrix_, projectionMatrix_);
+			isViewProjectionDirty_ = false;
+		}
+		return viewProjectionMatrix_;
+	}
+
+	const Matrix4x4& Camera::GetViewProjectionViewportMatrix() const
+	{
+		if (isViewProjectionViewportDirty_)
+		{
+			viewProjectionViewportMatrix_ = Multiply(GetViewProjectionMatrix(), viewportMatrix_);
+			isViewProjectionViewportDirty_ = false;
+		}
+		return viewProjectionViewportMatrix_;
+	}
+
+	const Frustum& Camera::GetFrustum() const
+	{
+		if (isFrustumDirty_)
+		{
+			frustum_ = MakeFrustum(GetViewProjectionMatrix());
+			isFrustumDirty_ = false;
+		}
+		return frustum_;
+	}
+}
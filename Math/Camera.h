@@ -0,0 +1,52 @@
+#pragma once
+#include "Frustum.h"
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <cstdint>
+
+namespace Math
+{
+	/// <summary>
+	/// ビュー・プロジェクション・ビューポート行列をまとめて持つカメラ
+	/// 合成した行列は入力が変わったときだけ作り直す
+	/// </summary>
+	class Camera final
+	{
+	public:
+		Camera();
+
+		// カメラの回転と位置からビュー行列を作る
+		void SetTransform(const Vector3& rotate, const Vector3& translate);
+		void SetPerspective(float fovY, float aspectRatio, float nearClip, float farClip);
+		void SetViewport(float left, float top, float width, float height, float minDepth = 0.0f, float maxDepth = 1.0f);
+
+		void SetViewMatrix(const Matrix4x4& viewMatrix);
+		void SetProjectionMatrix(const Matrix4x4& projectionMatrix);
+		void SetViewportMatrix(const Matrix4x4& viewportMatrix);
+
+		const Matrix4x4& GetViewMatrix() const { return viewMatrix_; }
+		const Matrix4x4& GetProjectionMatrix() const { return projectionMatrix_; }
+		const Matrix4x4& GetViewportMatrix() const { return viewportMatrix_; }
+		const Matrix4x4& GetViewProjectionMatrix() const;
+		const Matrix4x4& GetViewProjectionViewportMatrix() const;
+		// ビュー・プロジェクション行列から作った視錐台。カリングに使う
+		const Frustum& GetFrustum() const;
+
+		// 入力が変わるたびに増える値。キャッシュが古いかどうかの判定に使う
+		uint32_t GetVersion() const { return version_; }
+
+	private:
+		Matrix4x4 viewMatrix_;
+		Matrix4x4 projectionMatrix_;
+		Matrix4x4 viewportMatrix_;
+
+		mutable Matrix4x4 viewProjectionMatrix_;
+		mutable Matrix4x4 viewProjectionViewportMatrix_;
+		mutable Frustum frustum_;
+		mutable bool isViewProjectionDirty_ = true;
+		mutable bool isViewProjectionViewportDirty_ = true;
+		mutable bool isFrustumDirty_ = true;
+
+		uint32_t version_ = 0;
+	};
+}
@@ -0,0 +1,321 @@
+#include "ClipSpaceLines.h"
+#include "DebugDraw.h"
+#include "MathFunction.h"
+#include "Simd.h"
+#include <bit>
+#include <cassert>
+
+namespace Math
+{
+	namespace
+	{
+		static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3はfloat3つが並んでいる前提");
+
+		// 命令セットの最大の幅。1回分の結果を置く配列の大きさ
+		const size_t kMaxLaneCount = 8;
+
+		// 頂点をS::kWidth個ずつクリップ空間に変換し、wで割ったスクリーン座標をscreen[][i]からに書き込む
+		// 分岐をなくすため外側の頂点も割る(結果は使わない)。戻り値は面の外側にある頂点のビットマスク
+		// クリップ座標は切り取りが必要な線でしか使わないので、ここでは書き出さない
+		template <class S>
+		uint32_t ProjectVertexLanes(typename S::Float x, typename S::Float y, typename S::Float z, const Matrix4x4& m, const Matrix4x4& vp,
+			LineClipMode mode, float* const (&screen)[2], size_t i)
+		{
+			using Float = typename S::Float;
+			auto column = [&](const Matrix4x4& matrix, Float px, Float py, Float pz, int j)
+			{
+				return S::Add(S::Add(S::Add(S::Mul(px, S::Set(matrix.m[0][j])), S::Mul(py, S::Set(matrix.m[1][j]))), S::Mul(pz, S::Set(matrix.m[2][j]))), S::Set(matrix.m[3][j]));
+			};
+			Float c[4];
+			for (int j = 0; j < 4; ++j)
+			{
+				c[j] = column(m, x, y, z, j);
+			}
+
+			// 深度が0～1の射影なので、近平面は z >= 0
+			const Float zero = S::Set(0.0f);
+			typename S::Mask isOutside = S::CmpLt(c[2], zero);
+			if (mode == LineClipMode::Frustum)
+			{
+				isOutside = S::Or(isOutside, S::CmpLt(S::Sub(c[3], c[2]), zero));
+				isOutside = S::Or(isOutside, S::CmpLt(S::Add(c[3], c[0]), zero));
+				isOutside = S::Or(isOutside, S::CmpLt(S::Sub(c[3], c[0]), zero));
+				isOutside = S::Or(isOutside, S::CmpLt(S::Add(c[3], c[1]), zero));
+				isOutside = S::Or(isOutside, S::CmpLt(S::Sub(c[3], c[1]), zero));
+			}
+
+			Float inverseW = S::Div(S::Set(1.0f), c[3]);
+			Float ndc[3] = { S::Mul(c[0], inverseW), S::Mul(c[1], inverseW), S::Mul(c[2], inverseW) };
+			for (int axis = 0; axis < 2; ++axis)
+			{
+				S::Store(screen[axis] + i, column(vp, ndc[0], ndc[1], ndc[2], axis));
+			}
+			return S::MoveMask(isOutside);
+		}
+
+		// DrawClippedLinesの作業用の配列。DebugDrawと同じく1つのスレッドから使う前提で使い回す
+		struct ClipScratch final
+		{
+			std::vector<float> screen[2];	// 面の内側にある頂点のスクリーン座標
+			std::vector<uint8_t> outside;	// 頂点が面の外側にあれば1
+			ClipLineBuffer lines;			// 切り取りが必要な線
+		};
+
+		ClipScratch& GetScratch()
+		{
+			static ClipScratch scratch;
+			return scratch;
+		}
+
+		// 頂点をまとめて変換し、両端が内側の線はそのまま、それ以外はSubmitLinesで切り取る
+		// lineIndex(k)はk番目の端点の頂点番号を返す
+		template <class LineIndex>
+		size_t DrawClippedLinesImpl(std::span<const Vector3> vertices, size_t lineCount, const LineIndex& lineIndex,
+			const Matrix4x4& worldToClipMatrix, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode)
+		{
+			ClipScratch& scratch = GetScratch();
+			size_t vertexCount = vertices.size();
+			if (scratch.outside.size() < vertexCount)
+			{
+				for (auto& c : scratch.screen) { c.resize(vertexCount); }
+				scratch.outside.resize(vertexCount);
+			}
+
+			// 内側の頂点はここで1回だけwで割ってスクリーン座標にしておく
+			float* screen[2] = { scratch.screen[0].data(), scratch.screen[1].data() };
+			uint8_t* outside = scratch.outside.data();
+			uint32_t anyOutside = 0;
+			size_t i = 0;
+#if defined(MATH_SIMD_SSE2)
+			for (; i + 4 <= vertexCount; i += 4)
+			{
+				__m128 x, y, z;
+				Simd::LoadVector3x4(&vertices[i].x, x, y, z);
+				uint32_t mask = ProjectVertexLanes<Simd::Sse>(x, y, z, worldToClipMatrix, viewportMatrix, mode, screen, i);
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					outside[i + lane] = (mask >> lane) & 1u;
+				}
+				anyOutside |= mask;
+			}
+#endif
+			for (; i < vertexCount; ++i)
+			{
+				uint32_t mask = ProjectVertexLanes<Simd::Scalar>(vertices[i].x, vertices[i].y, vertices[i].z, worldToClipMatrix, viewportMatrix, mode, screen, i);
+				outside[i] = static_cast<uint8_t>(mask);
+				anyOutside |= mask;
+			}
+
+			std::span<DebugLineVertex> result = DebugDraw::AllocateLines(lineCount);
+			DebugLineVertex* out = result.data();
+			// すべての頂点が内側なら(画面に収まっている普通の場合)、切り取りを考えずに並べるだけ
+			if (anyOutside == 0)
+			{
+				for (size_t k = 0; k < lineCount * 2; ++k)
+				{
+					size_t index = lineIndex(k);
+					out[k] = { screen[0][index], screen[1][index], color };
+				}
+				return lineCount;
+			}
+
+			size_t written = 0;
+			scratch.lines.Clear();
+			for (size_t line = 0; line < lineCount; ++line)
+			{
+				size_t a = lineIndex(line * 2);
+				size_t b = lineIndex(line * 2 + 1);
+				if (!(outside[a] | outside[b]))
+				{
+					out[written++] = { screen[0][a], screen[1][a], color };
+					out[written++] = { screen[0][b], screen[1][b], color };
+					continue;
+				}
+				// 外側の頂点を含む線は少ないので、クリップ座標はここで計算し直す
+				float start[4];
+				float end[4];
+				TransformHomogeneous(vertices[a], worldToClipMatrix, start);
+				TransformHomogeneous(vertices[b], worldToClipMatrix, end);
+				scratch.lines.PushBack(start, end);
+			}
+			DebugDraw::ReleaseLines(lineCount - written / 2);
+
+			return written / 2 + SubmitLines(scratch.lines, viewportMatrix, color, mode);
+		}
+
+		// 線を切り取ったあとの端点のスクリーン座標 [始点x, 始点y, 終点x, 終点y][レーン]
+		using ScreenLanes = float[4][kMaxLaneCount];
+
+		// lines[i]からS::kWidth本の線を切り取ってスクリーン座標にする。戻り値は部分的にでも残った線のビットマスク
+		// 面の内側をd >= 0として、始点と終点のdから線分の残る範囲[t0, t1]を狭めていく(Liang-Barskyの方法)
+		template <class S>
+		uint32_t ClipLanes(const ClipLineBuffer& lines, size_t i, LineClipMode mode, const Matrix4x4& viewportMatrix, ScreenLanes& screen)
+		{
+			static_assert(S::kWidth <= kMaxLaneCount);
+			using Float = typename S::Float;
+			using Mask = typename S::Mask;
+
+			Float start[4];
+			Float end[4];
+			for (int c = 0; c < 4; ++c)
+			{
+				start[c] = S::Load(&lines.start[c][i]);
+				end[c] = S::Load(&lines.end[c][i]);
+			}
+
+			const Float zero = S::Set(0.0f);
+			Float t0 = zero;
+			Float t1 = S::Set(1.0f);
+			Mask rejected = S::CmpLt(zero, zero);
+			auto clip = [&](Float d0, Float d1)
+			{
+				Mask isStartOutside = S::CmpLt(d0, zero);
+				Mask isEndOutside = S::CmpLt(d1, zero);
+				rejected = S::Or(rejected, S::And(isStartOutside, isEndOutside));
+				// 片方だけが外側のときは分母が0にならない。両方外側のレーンは捨てるので値は使わない
+				Float t = S::Div(d0, S::Sub(d0, d1));
+				t0 = S::Select(isStartOutside, S::Max(t0, t), t0);
+				t1 = S::Select(isEndOutside, S::Min(t1, t), t1);
+			};
+
+			// 深度が0～1の射影なので、近平面は z >= 0
+			clip(start[2], end[2]);
+			if (mode == LineClipMode::Frustum)
+			{
+				clip(S::Sub(start[3], start[2]), S::Sub(end[3], end[2]));	// 遠: z <= w
+				clip(S::Add(start[3], start[0]), S::Add(end[3], end[0]));	// 左: -w <= x
+				clip(S::Sub(start[3], start[0]), S::Sub(end[3], end[0]));	// 右: x <= w
+				clip(S::Add(start[3], start[1]), S::Add(end[3], end[1]));	// 下: -w <= y
+				clip(S::Sub(start[3], start[1]), S::Sub(end[3], end[1]));	// 上: y <= w
+			}
+
+			const uint32_t kAllLanes = (1u << S::kWidth) - 1u;
+			uint32_t visible = ~S::MoveMask(rejected) & S::MoveMask(S::CmpLe(t0, t1)) & kAllLanes;
+			if (visible == 0)
+			{
+				return 0;
+			}
+
+			// 残った範囲の両端をwで割り、ビューポート変換する
+			// ビューポート行列の4列目は(0, 0, 0, 1)なので、wで割ったあとにかけても結果は変わらない
+			const Float one = S::Set(1.0f);
+			const Float t[2] = { t0, t1 };
+			for (int side = 0; side < 2; ++side)
+			{
+				Float point[4];
+				for (int c = 0; c < 4; ++c)
+				{
+					point[c] = S::Add(start[c], S::Mul(t[side], S::Sub(end[c], start[c])));
+				}
+				Float inverseW = S::Div(one, point[3]);
+				Float ndc[3] = { S::Mul(point[0], inverseW), S::Mul(point[1], inverseW), S::Mul(point[2], inverseW) };
+				for (int axis = 0; axis < 2; ++axis)
+				{
+					Float value = S::Add(S::Add(S::Add(
+						S::Mul(ndc[0], S::Set(viewportMatrix.m[0][axis])),
+						S::Mul(ndc[1], S::Set(viewportMatrix.m[1][axis]))),
+						S::Mul(ndc[2], S::Set(viewportMatrix.m[2][axis]))),
+						S::Set(viewportMatrix.m[3][axis]));
+					S::Store(screen[side * 2 + axis], value);
+				}
+			}
+			return visible;
+		}
+	}
+
+	void ClipLineBuffer::Clear()
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			start[c].clear();
+			end[c].clear();
+		}
+	}
+
+	void ClipLineBuffer::PushBack(const float startPoint[4], const float endPoint[4])
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			start[c].push_back(startPoint[c]);
+			end[c].push_back(endPoint[c]);
+		}
+	}
+
+	void AppendLines(std::span<const Vector3> lineVertices, const Matrix4x4& worldToClipMatrix, ClipLineBuffer& lines)
+	{
+		assert(lineVertices.size() % 2 == 0);
+		size_t offset = lines.Count();
+		size_t lineCount = lineVertices.size() / 2;
+		for (int c = 0; c < 4; ++c)
+		{
+			lines.start[c].resize(offset + lineCount);
+			lines.end[c].resize(offset + lineCount);
+		}
+		for (size_t i = 0; i < lineCount; ++i)
+		{
+			float start[4];
+			float end[4];
+			TransformHomogeneous(lineVertices[i * 2], worldToClipMatrix, start);
+			TransformHomogeneous(lineVertices[i * 2 + 1], worldToClipMatrix, end);
+			for (int c = 0; c < 4; ++c)
+			{
+				lines.start[c][offset + i] = start[c];
+				lines.end[c][offset + i] = end[c];
+			}
+		}
+	}
+
+	size_t SubmitLines(const ClipLineBuffer& lines, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode)
+	{
+		size_t count = lines.Count();
+		if (count == 0)
+		{
+			return 0;
+		}
+
+		// 最大の本数を確保しておき、切り取られて消えた分をあとで返す
+		std::span<DebugLineVertex> vertices = DebugDraw::AllocateLines(count);
+		size_t written = 0;
+		size_t i = 0;
+		auto run = [&]<class S>()
+		{
+			for (; i + S::kWidth <= count; i += S::kWidth)
+			{
+				ScreenLanes screen;
+				for (uint32_t visible = ClipLanes<S>(lines, i, mode, viewportMatrix, screen); visible != 0; visible &= visible - 1)
+				{
+					int lane = std::countr_zero(visible);
+					vertices[written++] = { screen[0][lane], screen[1][lane], color };
+					vertices[written++] = { screen[2][lane], screen[3][lane], color };
+				}
+			}
+		};
+#if defined(MATH_SIMD_AVX2)
+		run.template operator()<Simd::Avx2>();
+#endif
+#if defined(MATH_SIMD_SSE2)
+		run.template operator()<Simd::Sse>();
+#endif
+		run.template operator()<Simd::Scalar>();
+
+		size_t lineCount = written / 2;
+		DebugDraw::ReleaseLines(count - lineCount);
+		return lineCount;
+	}
+
+	size_t DrawClippedLines(std::span<const Vector3> vertices, std::span<const uint16_t> lineIndices,
+		const Matrix4x4& worldToClipMatrix, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode)
+	{
+		assert(lineIndices.size() % 2 == 0);
+		return DrawClippedLinesImpl(vertices, lineIndices.size() / 2, [&](size_t k) { return lineIndices[k]; },
+			worldToClipMatrix, viewportMatrix, color, mode);
+	}
+
+	size_t DrawClippedLines(std::span<const Vector3> lineVertices,
+		const Matrix4x4& worldToClipMatrix, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode)
+	{
+		assert(lineVertices.size() % 2 == 0);
+		return DrawClippedLinesImpl(lineVertices, lineVertices.size() / 2, [](size_t k) { return k; },
+			worldToClipMatrix, viewportMatrix, color, mode);
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Math
+{
+	/// <summary>
+	/// 線を切り取る面
+	/// </summary>
+	enum class LineClipMode
+	{
+		Near,		// 近平面だけ。カメラの後ろに回り込んだ部分を切り取る
+		Frustum,	// 視錐台の6枚すべて。画面外の部分もDebugDrawに渡さない
+	};
+
+	/// <summary>
+	/// クリップ空間(wで割る前)の線をSoA形式で保持する
+	/// i本目の線は(start[0][i], start[1][i], start[2][i], start[3][i])から(end[0][i], ...)まで
+	/// </summary>
+	struct ClipLineBuffer final
+	{
+		std::vector<float> start[4];	//!< 始点(x, y, z, w)
+		std::vector<float> end[4];		//!< 終点(x, y, z, w)
+
+		void Clear();
+		void PushBack(const float startPoint[4], const float endPoint[4]);
+		size_t Count() const { return start[0].size(); }
+	};
+
+	/*----------クリップ空間で線を切り取ってから描画する----------*/
+	// 始点と終点を2つずつ並べたワールド座標の線をクリップ空間に変換し、linesの後ろに追加する
+	void AppendLines(std::span<const Vector3> lineVertices, const Matrix4x4& worldToClipMatrix, ClipLineBuffer& lines);
+
+	// 線を切り取ってからwで割り、viewportMatrixでスクリーン座標にしてDebugDrawに追加する
+	// 残った部分のない線は追加しない。wが0以下の点で割ることはない
+	// viewportMatrixはMakeViewportMatrixで作ったアフィン変換であること。戻り値は追加した線の本数
+	size_t SubmitLines(const ClipLineBuffer& lines, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode = LineClipMode::Near);
+
+	// vertices[lineIndices[2 * i]]からvertices[lineIndices[2 * i + 1]]までを1本の線としてDebugDrawに追加する
+	// 頂点は1回ずつだけ変換し、両端が面の内側にある線はその結果をそのまま使う
+	// 外側の頂点を含む線だけをまとめてSubmitLinesで切り取る。戻り値は追加した線の本数
+	size_t DrawClippedLines(std::span<const Vector3> vertices, std::span<const uint16_t> lineIndices,
+		const Matrix4x4& worldToClipMatrix, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode = LineClipMode::Near);
+	// 始点と終点を2つずつ並べた線を描画する
+	size_t DrawClippedLines(std::span<const Vector3> lineVertices,
+		const Matrix4x4& worldToClipMatrix, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode = LineClipMode::Near);
+}
@@ -0,0 +1,560 @@
+#include "CollisionBatch.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Math
+{
+	namespace
+	{
+		// kernelを命令セットの幅ごとに呼び出し、結果をビットマスクに書き込む
+		// AVX2(8) -> SSE2(4) -> スカラー(1)の順に処理するので、1回分の結果が32ビットの境界をまたぐことはない
+		template <class Kernel>
+		void RunBatch(size_t count, std::span<uint32_t> hitMask, const Kernel& kernel)
+		{
+			assert(hitMask.size() >= HitMaskWordCount(count));
+			std::fill_n(hitMask.begin(), HitMaskWordCount(count), 0u);
+
+			size_t i = 0;
+#if defined(MATH_SIMD_AVX2)
+			for (; i + Simd::Avx2::kWidth <= count; i += Simd::Avx2::kWidth)
+			{
+				hitMask[i / 32] |= kernel.template operator()<Simd::Avx2>(i) << (i % 32);
+			}
+#endif
+#if defined(MATH_SIMD_SSE2)
+			for (; i + Simd::Sse::kWidth <= count; i += Simd::Sse::kWidth)
+			{
+				hitMask[i / 32] |= kernel.template operator()<Simd::Sse>(i) << (i % 32);
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				hitMask[i / 32] |= kernel.template operator()<Simd::Scalar>(i) << (i % 32);
+			}
+		}
+
+		// 点からAABBへの最近接点までの距離の2乗
+		template <class S>
+		typename S::Float ClosestPointDistanceSquared(const typename S::Float point[3], const typename S::Float min[3], const typename S::Float max[3])
+		{
+			typename S::Float distanceSquared = S::Set(0.0f);
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				typename S::Float closest = S::Min(S::Max(point[axis], min[axis]), max[axis]);
+				typename S::Float diff = S::Sub(closest, point[axis]);
+				distanceSquared = axis == 0 ? S::Mul(diff, diff) : S::Add(distanceSquared, S::Mul(diff, diff));
+			}
+			return distanceSquared;
+		}
+
+		// 球とAABBの判定 (IsCollision(const AABB&, const Sphere&)と同じ演算順)
+		template <class S>
+		typename S::Mask AABBSphere(const typename S::Float min[3], const typename S::Float max[3], const typename S::Float center[3], typename S::Float radius)
+		{
+			return S::CmpLe(ClosestPointDistanceSquared<S>(center, min, max), S::Mul(radius, radius));
+		}
+
+		// 3成分の内積 (Dotと同じ演算順)
+		template <class S>
+		typename S::Float Dot3(const typename S::Float a[3], const typename S::Float b[3])
+		{
+			return S::Add(S::Add(S::Mul(a[0], b[0]), S::Mul(a[1], b[1])), S::Mul(a[2], b[2]));
+		}
+
+		// 球とOBBの判定。球の中心をOBBのローカル空間に移す
+		// TransformToLocal(MakeCachedOBB(obb), center)と同じく、中心と球の中心をそれぞれ軸に射影してから引く
+		template <class S>
+		typename S::Mask OBBSphere(const typename S::Float obbCenter[3], const typename S::Float orientations[3][3], const typename S::Float size[3],
+			const typename S::Float sphereCenter[3], typename S::Float radius)
+		{
+			typename S::Float local[3];
+			typename S::Float halfMin[3];
+			typename S::Float halfMax[3];
+			const typename S::Float half = S::Set(0.5f);
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				// worldToLocalの平行移動は-Dot(center, axis)なので、足すのはこれを引くのと同じ結果になる
+				local[axis] = S::Sub(Dot3<S>(sphereCenter, orientations[axis]), Dot3<S>(obbCenter, orientations[axis]));
+				halfMax[axis] = S::Mul(size[axis], half);
+				halfMin[axis] = S::Sub(S::Set(0.0f), halfMax[axis]);
+			}
+
+			return S::CmpLe(ClosestPointDistanceSquared<S>(local, halfMin, halfMax), S::Mul(radius, radius));
+		}
+
+		// OBB同士の分離軸判定 (IsCollision(const CachedOBB&, const CachedOBB&)と同じ式)
+		// 1つ目のOBBはレーンに広げた値、2つ目はレーンごとに違う値を渡す
+		// すべてのレーンで分離軸が見つかった時点で抜ける
+		template <class S>
+		typename S::Mask OBBOBB(const typename S::Float center1[3], const typename S::Float axes1[3][3], const typename S::Float extent1[3],
+			const typename S::Float center2[3], const typename S::Float axes2[3][3], const typename S::Float extent2[3])
+		{
+			const uint32_t kAllLanes = (1u << S::kWidth) - 1u;
+			const typename S::Float epsilon = S::Set(1e-6f);
+
+			typename S::Float rotation[3][3];
+			typename S::Float absRotation[3][3];
+			for (int i = 0; i < 3; ++i)
+			{
+				for (int j = 0; j < 3; ++j)
+				{
+					rotation[i][j] = S::Add(S::Add(S::Mul(axes1[i][0], axes2[j][0]), S::Mul(axes1[i][1], axes2[j][1])), S::Mul(axes1[i][2], axes2[j][2]));
+					absRotation[i][j] = S::Add(S::Abs(rotation[i][j]), epsilon);
+				}
+			}
+
+			typename S::Float difference[3];
+			for (int c = 0; c < 3; ++c)
+			{
+				difference[c] = S::Sub(center2[c], center1[c]);
+			}
+			typename S::Float translation[3];
+			for (int i = 0; i < 3; ++i)
+			{
+				translation[i] = S::Add(S::Add(S::Mul(difference[0], axes1[i][0]), S::Mul(difference[1], axes1[i][1])), S::Mul(difference[2], axes1[i][2]));
+			}
+
+			typename S::Mask separated = S::CmpLt(epsilon, epsilon);
+
+			// 面の軸
+			for (int i = 0; i < 3; ++i)
+			{
+				// 足す順番はスカラー版(TestOBBSeparatingAxes)と同じ左から。接しているときの判定を一致させる
+				typename S::Float radius = S::Add(S::Add(S::Add(extent1[i], S::Mul(extent2[0], absRotation[i][0])), S::Mul(extent2[1], absRotation[i][1])), S::Mul(extent2[2], absRotation[i][2]));
+				separated = S::Or(separated, S::CmpLt(radius, S::Abs(translation[i])));
+			}
+			for (int j = 0; j < 3; ++j)
+			{
+				typename S::Float radius = S::Add(
+					S::Add(S::Add(S::Mul(extent1[0], absRotation[0][j]), S::Mul(extent1[1], absRotation[1][j])), S::Mul(extent1[2], absRotation[2][j])), extent2[j]);
+				typename S::Float distance = S::Add(S::Add(S::Mul(translation[0], rotation[0][j]), S::Mul(translation[1], rotation[1][j])), S::Mul(translation[2], rotation[2][j]));
+				separated = S::Or(separated, S::CmpLt(radius, S::Abs(distance)));
+			}
+			if (S::MoveMask(separated) == kAllLanes)
+			{
+				return separated;
+			}
+
+			// 辺同士の軸
+			for (int i = 0; i < 3; ++i)
+			{
+				int i1 = (i + 1) % 3;
+				int i2 = (i + 2) % 3;
+				for (int j = 0; j < 3; ++j)
+				{
+					int j1 = (j + 1) % 3;
+					int j2 = (j + 2) % 3;
+					typename S::Float radius = S::Add(S::Add(S::Add(
+						S::Mul(extent1[i1], absRotation[i2][j]), S::Mul(extent1[i2], absRotation[i1][j])),
+						S::Mul(extent2[j1], absRotation[i][j2])), S::Mul(extent2[j2], absRotation[i][j1]));
+					typename S::Float distance = S::Sub(S::Mul(translation[i2], rotation[i1][j]), S::Mul(translation[i1], rotation[i2][j]));
+					separated = S::Or(separated, S::CmpLt(radius, S::Abs(distance)));
+				}
+				if (S::MoveMask(separated) == kAllLanes)
+				{
+					return separated;
+				}
+			}
+			return separated;
+		}
+
+		// 視錐台の各平面について、中心の符号付き距離が-(法線方向への広がり)より小さければ外側
+		// projectedRadius(normal)は平面の法線を受け取り、形状の法線方向への広がりを返す
+		// 戻り値は外側にあるレーン
+		template <class S, class Radius>
+		typename S::Mask OutsideFrustum(const Frustum& frustum, const typename S::Float center[3], const Radius& projectedRadius)
+		{
+			const typename S::Float zero = S::Set(0.0f);
+			typename S::Mask outside = S::CmpLt(zero, zero);
+			for (const Plane& plane : frustum.planes)
+			{
+				typename S::Float distance = S::Sub(
+					S::Add(S::Add(S::Mul(S::Set(plane.normal.x), center[0]), S::Mul(S::Set(plane.normal.y), center[1])), S::Mul(S::Set(plane.normal.z), center[2])),
+					S::Set(plane.distance));
+				outside = S::Or(outside, S::CmpLt(distance, S::Sub(zero, projectedRadius(plane.normal))));
+			}
+			return outside;
+		}
+	}
+
+	void SphereBuffer::Clear()
+	{
+		for (auto& c : center) { c.clear(); }
+		radius.clear();
+	}
+
+	void SphereBuffer::PushBack(const Sphere& sphere)
+	{
+		center[0].push_back(sphere.center.x);
+		center[1].push_back(sphere.center.y);
+		center[2].push_back(sphere.center.z);
+		radius.push_back(sphere.radius);
+	}
+
+	void SphereBuffer::Assign(std::span<const Sphere> spheres)
+	{
+		Clear();
+		for (auto& c : center) { c.reserve(spheres.size()); }
+		radius.reserve(spheres.size());
+		for (const Sphere& sphere : spheres) { PushBack(sphere); }
+	}
+
+	SphereSoA SphereBuffer::View() const
+	{
+		return { { center[0], center[1], center[2] }, radius };
+	}
+
+	void AABBBuffer::Clear()
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			min[i].clear();
+			max[i].clear();
+		}
+	}
+
+	void AABBBuffer::PushBack(const AABB& aabb)
+	{
+		min[0].push_back(aabb.min.x);
+		min[1].push_back(aabb.min.y);
+		min[2].push_back(aabb.min.z);
+		max[0].push_back(aabb.max.x);
+		max[1].push_back(aabb.max.y);
+		max[2].push_back(aabb.max.z);
+	}
+
+	void AABBBuffer::Assign(std::span<const AABB> aabbs)
+	{
+		Clear();
+		for (int i = 0; i < 3; ++i)
+		{
+			min[i].reserve(aabbs.size());
+			max[i].reserve(aabbs.size());
+		}
+		for (const AABB& aabb : aabbs) { PushBack(aabb); }
+	}
+
+	AABBSoA AABBBuffer::View() const
+	{
+		return { { min[0], min[1], min[2] }, { max[0], max[1], max[2] } };
+	}
+
+	void OBBBuffer::Clear()
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			center[i].clear();
+			size[i].clear();
+			for (auto& o : orientations[i]) { o.clear(); }
+		}
+	}
+
+	void OBBBuffer::PushBack(const OBB& obb)
+	{
+		center[0].push_back(obb.center.x);
+		center[1].push_back(obb.center.y);
+		center[2].push_back(obb.center.z);
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			orientations[axis][0].push_back(obb.orientations[axis].x);
+			orientations[axis][1].push_back(obb.orientations[axis].y);
+			orientations[axis][2].push_back(obb.orientations[axis].z);
+		}
+		size[0].push_back(obb.size.x);
+		size[1].push_back(obb.size.y);
+		size[2].push_back(obb.size.z);
+	}
+
+	void OBBBuffer::Assign(std::span<const OBB> obbs)
+	{
+		Clear();
+		for (int i = 0; i < 3; ++i)
+		{
+			center[i].reserve(obbs.size());
+			size[i].reserve(obbs.size());
+			for (auto& o : orientations[i]) { o.reserve(obbs.size()); }
+		}
+		for (const OBB& obb : obbs) { PushBack(obb); }
+	}
+
+	OBBSoA OBBBuffer::View() const
+	{
+		OBBSoA view{};
+		for (int i = 0; i < 3; ++i)
+		{
+			view.center[i] = center[i];
+			view.size[i] = size[i];
+			for (int j = 0; j < 3; ++j)
+			{
+				view.orientations[i][j] = orientations[i][j];
+			}
+		}
+		return view;
+	}
+
+	void PlaneBuffer::Clear()
+	{
+		for (auto& n : normal) { n.clear(); }
+		distance.clear();
+	}
+
+	void PlaneBuffer::PushBack(const Plane& plane)
+	{
+		normal[0].push_back(plane.normal.x);
+		normal[1].push_back(plane.normal.y);
+		normal[2].push_back(plane.normal.z);
+		distance.push_back(plane.distance);
+	}
+
+	void PlaneBuffer::Assign(std::span<const Plane> planes)
+	{
+		Clear();
+		for (auto& n : normal) { n.reserve(planes.size()); }
+		distance.reserve(planes.size());
+		for (const Plane& plane : planes) { PushBack(plane); }
+	}
+
+	PlaneSoA PlaneBuffer::View() const
+	{
+		return { { normal[0], normal[1], normal[2] }, distance };
+	}
+
+	void TriangleBuffer::Clear()
+	{
+		for (auto& vertex : vertices)
+		{
+			for (auto& v : vertex) { v.clear(); }
+		}
+	}
+
+	void TriangleBuffer::PushBack(const Triangle& triangle)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			vertices[i][0].push_back(triangle.vertices[i].x);
+			vertices[i][1].push_back(triangle.vertices[i].y);
+			vertices[i][2].push_back(triangle.vertices[i].z);
+		}
+	}
+
+	void TriangleBuffer::Assign(std::span<const Triangle> triangles)
+	{
+		Clear();
+		for (auto& vertex : vertices)
+		{
+			for (auto& v : vertex) { v.reserve(triangles.size()); }
+		}
+		for (const Triangle& triangle : triangles) { PushBack(triangle); }
+	}
+
+	TriangleSoA TriangleBuffer::View() const
+	{
+		TriangleSoA view{};
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				view.vertices[i][j] = vertices[i][j];
+			}
+		}
+		return view;
+	}
+
+	void IsCollisionBatch(const Sphere& sphere, const SphereSoA& spheres, std::span<uint32_t> hitMask)
+	{
+		const float center[3] = { sphere.center.x, sphere.center.y, sphere.center.z };
+
+		RunBatch(spheres.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			// IsCollision(const Sphere&, const Sphere&)と同じく中心間の距離の2乗を半径の合計の2乗と比べる
+			typename S::Float distanceSquared{};
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				typename S::Float diff = S::Sub(S::Load(&spheres.center[axis][i]), S::Set(center[axis]));
+				distanceSquared = axis == 0 ? S::Mul(diff, diff) : S::Add(distanceSquared, S::Mul(diff, diff));
+			}
+			typename S::Float radiusSum = S::Add(S::Set(sphere.radius), S::Load(&spheres.radius[i]));
+			return S::MoveMask(S::CmpLe(distanceSquared, S::Mul(radiusSum, radiusSum)));
+		});
+	}
+
+	void IsCollisionBatch(const AABB& aabb, const AABBSoA& aabbs, std::span<uint32_t> hitMask)
+	{
+		const float min[3] = { aabb.min.x, aabb.min.y, aabb.min.z };
+		const float max[3] = { aabb.max.x, aabb.max.y, aabb.max.z };
+
+		RunBatch(aabbs.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			typename S::Mask hit{};
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				typename S::Mask overlap = S::And(
+					S::CmpLe(S::Set(min[axis]), S::Load(&aabbs.max[axis][i])),
+					S::CmpLe(S::Load(&aabbs.min[axis][i]), S::Set(max[axis])));
+				hit = axis == 0 ? overlap : S::And(hit, overlap);
+			}
+			return S::MoveMask(hit);
+		});
+	}
+
+	void IsCollisionBatch(const AABB& aabb, const SphereSoA& spheres, std::span<uint32_t> hitMask)
+	{
+		RunBatch(spheres.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			const typename S::Float min[3] = { S::Set(aabb.min.x), S::Set(aabb.min.y), S::Set(aabb.min.z) };
+			const typename S::Float max[3] = { S::Set(aabb.max.x), S::Set(aabb.max.y), S::Set(aabb.max.z) };
+			const typename S::Float center[3] = { S::Load(&spheres.center[0][i]), S::Load(&spheres.center[1][i]), S::Load(&spheres.center[2][i]) };
+			return S::MoveMask(AABBSphere<S>(min, max, center, S::Load(&spheres.radius[i])));
+		});
+	}
+
+	void IsCollisionBatch(const AABBSoA& aabbs, const Sphere& sphere, std::span<uint32_t> hitMask)
+	{
+		RunBatch(aabbs.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			const typename S::Float min[3] = { S::Load(&aabbs.min[0][i]), S::Load(&aabbs.min[1][i]), S::Load(&aabbs.min[2][i]) };
+			const typename S::Float max[3] = { S::Load(&aabbs.max[0][i]), S::Load(&aabbs.max[1][i]), S::Load(&aabbs.max[2][i]) };
+			const typename S::Float center[3] = { S::Set(sphere.center.x), S::Set(sphere.center.y), S::Set(sphere.center.z) };
+			return S::MoveMask(AABBSphere<S>(min, max, center, S::Set(sphere.radius)));
+		});
+	}
+
+	void IsCollisionBatch(const OBBSoA& obbs, const Sphere& sphere, std::span<uint32_t> hitMask)
+	{
+		RunBatch(obbs.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			typename S::Float obbCenter[3];
+			typename S::Float orientations[3][3];
+			typename S::Float size[3];
+			for (int a = 0; a < 3; ++a)
+			{
+				obbCenter[a] = S::Load(&obbs.center[a][i]);
+				size[a] = S::Load(&obbs.size[a][i]);
+				for (int c = 0; c < 3; ++c)
+				{
+					orientations[a][c] = S::Load(&obbs.orientations[a][c][i]);
+				}
+			}
+			const typename S::Float center[3] = { S::Set(sphere.center.x), S::Set(sphere.center.y), S::Set(sphere.center.z) };
+			return S::MoveMask(OBBSphere<S>(obbCenter, orientations, size, center, S::Set(sphere.radius)));
+		});
+	}
+
+	void IsCollisionBatch(const OBB& obb, const SphereSoA& spheres, std::span<uint32_t> hitMask)
+	{
+		RunBatch(spheres.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			const typename S::Float obbCenter[3] = { S::Set(obb.center.x), S::Set(obb.center.y), S::Set(obb.center.z) };
+			const typename S::Float size[3] = { S::Set(obb.size.x), S::Set(obb.size.y), S::Set(obb.size.z) };
+			typename S::Float orientations[3][3];
+			for (int a = 0; a < 3; ++a)
+			{
+				orientations[a][0] = S::Set(obb.orientations[a].x);
+				orientations[a][1] = S::Set(obb.orientations[a].y);
+				orientations[a][2] = S::Set(obb.orientations[a].z);
+			}
+			const typename S::Float center[3] = { S::Load(&spheres.center[0][i]), S::Load(&spheres.center[1][i]), S::Load(&spheres.center[2][i]) };
+			return S::MoveMask(OBBSphere<S>(obbCenter, orientations, size, center, S::Load(&spheres.radius[i])));
+		});
+	}
+
+	void IsCollisionBatch(const OBB& obb, const OBBSoA& obbs, std::span<uint32_t> hitMask)
+	{
+		RunBatch(obbs.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			const typename S::Float center1[3] = { S::Set(obb.center.x), S::Set(obb.center.y), S::Set(obb.center.z) };
+			const typename S::Float extent1[3] = { S::Set(obb.size.x * 0.5f), S::Set(obb.size.y * 0.5f), S::Set(obb.size.z * 0.5f) };
+			typename S::Float axes1[3][3];
+			for (int a = 0; a < 3; ++a)
+			{
+				axes1[a][0] = S::Set(obb.orientations[a].x);
+				axes1[a][1] = S::Set(obb.orientations[a].y);
+				axes1[a][2] = S::Set(obb.orientations[a].z);
+			}
+
+			const typename S::Float half = S::Set(0.5f);
+			typename S::Float center2[3];
+			typename S::Float axes2[3][3];
+			typename S::Float extent2[3];
+			for (int a = 0; a < 3; ++a)
+			{
+				center2[a] = S::Load(&obbs.center[a][i]);
+				extent2[a] = S::Mul(S::Load(&obbs.size[a][i]), half);
+				for (int c = 0; c < 3; ++c)
+				{
+					axes2[a][c] = S::Load(&obbs.orientations[a][c][i]);
+				}
+			}
+			const uint32_t kAllLanes = (1u << S::kWidth) - 1u;
+			return ~S::MoveMask(OBBOBB<S>(center1, axes1, extent1, center2, axes2, extent2)) & kAllLanes;
+		});
+	}
+
+	void IsCollisionBatch(const Frustum& frustum, const SphereSoA& spheres, std::span<uint32_t> hitMask)
+	{
+		RunBatch(spheres.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			const uint32_t kAllLanes = (1u << S::kWidth) - 1u;
+			const typename S::Float center[3] = { S::Load(&spheres.center[0][i]), S::Load(&spheres.center[1][i]), S::Load(&spheres.center[2][i]) };
+			const typename S::Float radius = S::Load(&spheres.radius[i]);
+			return ~S::MoveMask(OutsideFrustum<S>(frustum, center, [&](const Vector3&) { return radius; })) & kAllLanes;
+		});
+	}
+
+	void IsCollisionBatch(const Frustum& frustum, const AABBSoA& aabbs, std::span<uint32_t> hitMask)
+	{
+		RunBatch(aabbs.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			const uint32_t kAllLanes = (1u << S::kWidth) - 1u;
+			const typename S::Float half = S::Set(0.5f);
+			typename S::Float center[3];
+			typename S::Float extent[3];
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				typename S::Float min = S::Load(&aabbs.min[axis][i]);
+				typename S::Float max = S::Load(&aabbs.max[axis][i]);
+				center[axis] = S::Mul(S::Add(min, max), half);
+				extent[axis] = S::Mul(S::Sub(max, min), half);
+			}
+			return ~S::MoveMask(OutsideFrustum<S>(frustum, center, [&](const Vector3& normal)
+			{
+				return S::Add(S::Add(S::Mul(S::Set(std::abs(normal.x)), extent[0]), S::Mul(S::Set(std::abs(normal.y)), extent[1])), S::Mul(S::Set(std::abs(normal.z)), extent[2]));
+			})) & kAllLanes;
+		});
+	}
+
+	void IsCollisionBatch(const Frustum& frustum, const OBBSoA& obbs, std::span<uint32_t> hitMask)
+	{
+		RunBatch(obbs.Count(), hitMask, [&]<class S>(size_t i)
+		{
+			const uint32_t kAllLanes = (1u << S::kWidth) - 1u;
+			const typename S::Float half = S::Set(0.5f);
+			typename S::Float center[3];
+			typename S::Float orientations[3][3];
+			typename S::Float extent[3];
+			for (int a = 0; a < 3; ++a)
+			{
+				center[a] = S::Load(&obbs.center[a][i]);
+				extent[a] = S::Mul(S::Load(&obbs.size[a][i]), half);
+				for (int c = 0; c < 3; ++c)
+				{
+					orientations[a][c] = S::Load(&obbs.orientations[a][c][i]);
+				}
+			}
+			return ~S::MoveMask(OutsideFrustum<S>(frustum, center, [&](const Vector3& normal)
+			{
+				const typename S::Float n[3] = { S::Set(normal.x), S::Set(normal.y), S::Set(normal.z) };
+				typename S::Float radius{};
+				for (int a = 0; a < 3; ++a)
+				{
+					typename S::Float projected = S::Add(S::Add(S::Mul(n[0], orientations[a][0]), S::Mul(n[1], orientations[a][1])), S::Mul(n[2], orientations[a][2]));
+					typename S::Float term = S::Mul(S::Abs(projected), extent[a]);
+					radius = a == 0 ? term : S::Add(radius, term);
+				}
+				return radius;
+			})) & kAllLanes;
+		});
+	}
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include "AABB.h"
+#include "Frustum.h"
+#include "OBB.h"
+#include "Plane.h"
+#include "Sphereh.h"
+#include "Triangle.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Math
+{
+	/*----------SoA(成分ごとの配列)形式のプリミティブ----------*/
+
+	/// <summary>
+	/// 球の配列をSoA形式で参照する
+	/// </summary>
+	struct SphereSoA final
+	{
+		std::span<const float> center[3];	//!< 中心点(x, y, z)
+		std::span<const float> radius;		//!< 半径
+
+		size_t Count() const { return radius.size(); }
+	};
+
+	/// <summary>
+	/// AABBの配列をSoA形式で参照する
+	/// </summary>
+	struct AABBSoA final
+	{
+		std::span<const float> min[3];	//!< 最小値(x, y, z)
+		std::span<const float> max[3];	//!< 最大値(x, y, z)
+
+		size_t Count() const { return min[0].size(); }
+	};
+
+	/// <summary>
+	/// OBBの配列をSoA形式で参照する
+	/// </summary>
+	struct OBBSoA final
+	{
+		std::span<const float> center[3];			//!< 中心点(x, y, z)
+		std::span<const float> orientations[3][3];	//!< [軸][成分]
+		std::span<const float> size[3];				//!< 大きさ(x, y, z)
+
+		size_t Count() const { return center[0].size(); }
+	};
+
+	/// <summary>
+	/// 平面の配列をSoA形式で参照する
+	/// </summary>
+	struct PlaneSoA final
+	{
+		std::span<const float> normal[3];	//!< 法線(x, y, z)
+		std::span<const float> distance;	//!< 距離
+
+		size_t Count() const { return distance.size(); }
+	};
+
+	/// <summary>
+	/// 三角形の配列をSoA形式で参照する
+	/// </summary>
+	struct TriangleSoA final
+	{
+		std::span<const float> vertices[3][3];	//!< [頂点][成分]
+
+		size_t Count() const { return vertices[0][0].size(); }
+	};
+
+	/// <summary>
+	/// 球の配列をSoA形式で保持する
+	/// </summary>
+	struct SphereBuffer final
+	{
+		std::vector<float> center[3];
+		std::vector<float> radius;
+
+		void Clear();
+		void PushBack(const Sphere& sphere);
+		void Assign(std::span<const Sphere> spheres);
+		SphereSoA View() const;
+	};
+
+	/// <summary>
+	/// AABBの配列をSoA形式で保持する
+	/// </summary>
+	struct AABBBuffer final
+	{
+		std::vector<float> min[3];
+		std::vector<float> max[3];
+
+		void Clear();
+		void PushBack(const AABB& aabb);
+		void Assign(std::span<const AABB> aabbs);
+		AABBSoA View() const;
+	};
+
+	/// <summary>
+	/// OBBの配列をSoA形式で保持する
+	/// </summary>
+	struct OBBBuffer final
+	{
+		std::vector<float> center[3];
+		std::vector<float> orientations[3][3];
+		std::vector<float> size[3];
+
+		void Clear();
+		void PushBack(const OBB& obb);
+		void Assign(std::span<const OBB> obbs);
+		OBBSoA View() const;
+	};
+
+	/// <summary>
+	/// 平面の配列をSoA形式で保持する
+	/// </summary>
+	struct PlaneBuffer final
+	{
+		std::vector<float> normal[3];
+		std::vector<float> distance;
+
+		void Clear();
+		void PushBack(const Plane& plane);
+		void Assign(std::span<const Plane> planes);
+		PlaneSoA View() const;
+	};
+
+	/// <summary>
+	/// 三角形の配列をSoA形式で保持する
+	/// </summary>
+	struct TriangleBuffer final
+	{
+		std::vector<float> vertices[3][3];
+
+		void Clear();
+		void PushBack(const Triangle& triangle);
+		void Assign(std::span<const Triangle> triangles);
+		TriangleSoA View() const;
+	};
+
+	/*----------まとめて衝突判定を取る関数----------*/
+
+	// 判定結果はi番目の要素をhitMask[i / 32]の(i % 32)ビット目に書き込む
+	constexpr size_t HitMaskWordCount(size_t count) { return (count + 31) / 32; }
+	inline bool TestHitMask(std::span<const uint32_t> hitMask, size_t index) { return (hitMask[index / 32] >> (index % 32)) & 1u; }
+
+	void IsCollisionBatch(const Sphere& sphere, const SphereSoA& spheres, std::span<uint32_t> hitMask);
+	void IsCollisionBatch(const AABB& aabb, const AABBSoA& aabbs, std::span<uint32_t> hitMask);
+	void IsCollisionBatch(const AABB& aabb, const SphereSoA& spheres, std::span<uint32_t> hitMask);
+	void IsCollisionBatch(const AABBSoA& aabbs, const Sphere& sphere, std::span<uint32_t> hitMask);
+	void IsCollisionBatch(const OBBSoA& obbs, const Sphere& sphere, std::span<uint32_t> hitMask);
+	void IsCollisionBatch(const OBB& obb, const SphereSoA& spheres, std::span<uint32_t> hitMask);
+	void IsCollisionBatch(const OBB& obb, const OBBSoA& obbs, std::span<uint32_t> hitMask);
+
+	// 視錐台カリング用。IsCollision(const Frustum&, ...)と同じく、見えている可能性があればビットが立つ
+	void IsCollisionBatch(const Frustum& frustum, const SphereSoA& spheres, std::span<uint32_t> hitMask);
+	void IsCollisionBatch(const Frustum& frustum, const AABBSoA& aabbs, std::span<uint32_t> hitMask);
+	void IsCollisionBatch(const Frustum& frustum, const OBBSoA& obbs, std::span<uint32_t> hitMask);
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "Vector3.h"
+#include <cstdint>
+
+//2つの形状の接触情報
+struct ContactManifold final
+{
+	static constexpr uint32_t kMaxPointCount = 4;
+
+	Vector3 normal;						//!<接触法線(正規化済み、1つ目の形状から2つ目の形状へ向かう向き)
+	float depth;						//!<めり込みの深さ
+	Vector3 points[kMaxPointCount];		//!<接触点(ワールド座標)
+	uint32_t pointCount;				//!<接触点の数
+};
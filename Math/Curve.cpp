@@ -0,0 +1,390 @@
+#include "Curve.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Math
+{
+	namespace
+	{
+		// TessellateAdaptiveで二分割する最大の回数
+		const uint32_t kMaxSubdivisionDepth = 10;
+		// 一部だけが視錐台の外にある区間をこの回数までは分割して、見えない部分を捨てる
+		const uint32_t kCullSubdivisionDepth = 4;
+		// 1つの区間を等間隔に分けて線にする最大の本数。これより多く必要なら先に二分割する
+		const uint32_t kMaxUniformSegmentCount = 64;
+		// wがこれ以下の点はスクリーンに射影できないので、分割数を求めずに二分割を続ける
+		const float kMinProjectableW = 1.0e-6f;
+
+		// 分割中の区間。制御点ごとにワールド座標(x, y, z)とクリップ座標(x, y, z, w)を並べて持ち、同じ計算で二分割する
+		// 行列の変換は線形なので、クリップ座標を分割した結果は分割したワールド座標を変換した結果と同じになる
+		const int kNodeComponentCount = 7;
+		struct CurveNode final
+		{
+			float points[4][kNodeComponentCount];
+			uint32_t depth;
+		};
+
+		// de Casteljauの方法でt = 0.5で二分割する
+		void Split(const CurveNode& node, CurveNode& left, CurveNode& right)
+		{
+			for (int c = 0; c < kNodeComponentCount; ++c)
+			{
+				float p01 = (node.points[0][c] + node.points[1][c]) * 0.5f;
+				float p12 = (node.points[1][c] + node.points[2][c]) * 0.5f;
+				float p23 = (node.points[2][c] + node.points[3][c]) * 0.5f;
+				float p012 = (p01 + p12) * 0.5f;
+				float p123 = (p12 + p23) * 0.5f;
+				float middle = (p012 + p123) * 0.5f;
+
+				left.points[0][c] = node.points[0][c];
+				left.points[1][c] = p01;
+				left.points[2][c] = p012;
+				left.points[3][c] = middle;
+				right.points[0][c] = middle;
+				right.points[1][c] = p123;
+				right.points[2][c] = p23;
+				right.points[3][c] = node.points[3][c];
+			}
+			left.depth = node.depth + 1;
+			right.depth = node.depth + 1;
+		}
+
+		// 制御点ごとに、外側にある面のビットを立てる(近、遠、左、右、下、上)
+		// 曲線は制御点の凸包に収まるので、全ての制御点で同じビットが立っていれば区間全体が見えない
+		void ClassifyFrustum(const CurveNode& node, uint32_t& outsideAll, uint32_t& outsideAny)
+		{
+			outsideAll = 0x3F;
+			outsideAny = 0;
+			for (const auto& p : node.points)
+			{
+				// 深度が0～1の射影なので近平面は z >= 0
+				float x = p[3], y = p[4], z = p[5], w = p[6];
+				uint32_t outside = 0;
+				outside |= (z < 0.0f) ? 1u : 0u;
+				outside |= (w - z < 0.0f) ? 2u : 0u;
+				outside |= (w + x < 0.0f) ? 4u : 0u;
+				outside |= (w - x < 0.0f) ? 8u : 0u;
+				outside |= (w + y < 0.0f) ? 16u : 0u;
+				outside |= (w - y < 0.0f) ? 32u : 0u;
+				outsideAll &= outside;
+				outsideAny |= outside;
+			}
+		}
+
+		// 制御点をスクリーンに射影し、線にしたときのずれがtolerance(ピクセル)以内になる等分の数をWangの式で求める
+		// 射影できない制御点があれば0を返す
+		uint32_t UniformSegmentCount(const CurveNode& node, const Matrix4x4& viewportMatrix, float tolerance)
+		{
+			float screen[4][2];
+			for (int i = 0; i < 4; ++i)
+			{
+				const float* p = node.points[i];
+				if (p[6] <= kMinProjectableW)
+				{
+					return 0;
+				}
+				// ビューポート変換の平行移動は差を取ると消えるので、拡大部分だけをかける
+				float inverseW = 1.0f / p[6];
+				float ndcX = p[3] * inverseW;
+				float ndcY = p[4] * inverseW;
+				screen[i][0] = ndcX * viewportMatrix.m[0][0] + ndcY * viewportMatrix.m[1][0];
+				screen[i][1] = ndcX * viewportMatrix.m[0][1] + ndcY * viewportMatrix.m[1][1];
+			}
+
+			// 3次の曲線をn等分した線のずれは、制御点の2階差分の大きさMを使って 3 * 2 / 8 * M / n^2 以下になる
+			float secondDifference[2][2];
+			for (int axis = 0; axis < 2; ++axis)
+			{
+				secondDifference[0][axis] = screen[0][axis] - 2.0f * screen[1][axis] + screen[2][axis];
+				secondDifference[1][axis] = screen[1][axis] - 2.0f * screen[2][axis] + screen[3][axis];
+			}
+			float maxSquared = (std::max)(
+				secondDifference[0][0] * secondDifference[0][0] + secondDifference[0][1] * secondDifference[0][1],
+				secondDifference[1][0] * secondDifference[1][0] + secondDifference[1][1] * secondDifference[1][1]);
+			float count = std::ceil(std::sqrt(0.75f * std::sqrt(maxSquared) / tolerance));
+			return count < 1.0f ? 1u : (count > static_cast<float>(UINT32_MAX >> 1) ? UINT32_MAX : static_cast<uint32_t>(count));
+		}
+
+		// 区間のワールド座標の制御点を取り出す
+		CubicBezier ToCubicBezier(const CurveNode& node)
+		{
+			CubicBezier curve;
+			for (int i = 0; i < 4; ++i)
+			{
+				curve.controlPoints[i] = { node.points[i][0], node.points[i][1], node.points[i][2] };
+			}
+			return curve;
+		}
+	}
+
+	CubicBezier MakeQuadraticBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2)
+	{
+		// 次数上げ: 内側の2点は、端点から中央の制御点へ2/3だけ進んだ点
+		return { {
+			controlPoint0,
+			Multiply(1.0f / 3.0f, Add(controlPoint0, Multiply(2.0f, controlPoint1))),
+			Multiply(1.0f / 3.0f, Add(controlPoint2, Multiply(2.0f, controlPoint1))),
+			controlPoint2,
+		} };
+	}
+
+	void MakeCatmullRomSegments(std::span<const Vector3> points, std::vector<CubicBezier>& segments)
+	{
+		segments.clear();
+		if (points.size() < 2)
+		{
+			return;
+		}
+
+		// 点p1からp2までの区間の接線は(p2 - p0) / 2と(p3 - p1) / 2。ベジエの制御点はその1/3だけ離れた点になる
+		size_t last = points.size() - 1;
+		segments.reserve(last);
+		for (size_t i = 0; i < last; ++i)
+		{
+			const Vector3& p0 = points[i == 0 ? 0 : i - 1];
+			const Vector3& p1 = points[i];
+			const Vector3& p2 = points[i + 1];
+			const Vector3& p3 = points[(std::min)(i + 2, last)];
+			segments.push_back({ {
+				p1,
+				Add(p1, Multiply(1.0f / 6.0f, Subtract(p2, p0))),
+				Subtract(p2, Multiply(1.0f / 6.0f, Subtract(p3, p1))),
+				p2,
+			} });
+		}
+	}
+
+	void MakeBSplineSegments(std::span<const Vector3> points, std::vector<CubicBezier>& segments)
+	{
+		segments.clear();
+		if (points.size() < 4)
+		{
+			return;
+		}
+
+		segments.reserve(points.size() - 3);
+		for (size_t i = 0; i + 3 < points.size(); ++i)
+		{
+			const Vector3& p0 = points[i];
+			const Vector3& p1 = points[i + 1];
+			const Vector3& p2 = points[i + 2];
+			const Vector3& p3 = points[i + 3];
+			// 内側の2点はp1とp2を3等分する点、端点は(隣の点 + 4 * 自分 + 反対の隣の点) / 6
+			segments.push_back({ {
+				Multiply(1.0f / 6.0f, Add(Add(p0, Multiply(4.0f, p1)), p2)),
+				Multiply(1.0f / 3.0f, Add(Multiply(2.0f, p1), p2)),
+				Multiply(1.0f / 3.0f, Add(p1, Multiply(2.0f, p2))),
+				Multiply(1.0f / 6.0f, Add(Add(p1, Multiply(4.0f, p2)), p3)),
+			} });
+		}
+	}
+
+	Vector3 Evaluate(const CubicBezier& curve, float t)
+	{
+		float s = 1.0f - t;
+		const Vector3* p = curve.controlPoints;
+		Vector3 result = Multiply(s * s * s, p[0]);
+		result = Add(result, Multiply(3.0f * s * s * t, p[1]));
+		result = Add(result, Multiply(3.0f * s * t * t, p[2]));
+		return Add(result, Multiply(t * t * t, p[3]));
+	}
+
+	void EvaluateUniform(const CubicBezier& curve, std::span<Vector3> points)
+	{
+		if (points.empty())
+		{
+			return;
+		}
+		const Vector3* p = curve.controlPoints;
+		points[0] = p[0];
+		if (points.size() == 1)
+		{
+			return;
+		}
+
+		// a t^3 + b t^2 + c t + d の形にして、刻みhの1階・2階・3階差分を足していく
+		Vector3 a = Add(Subtract(p[3], p[0]), Multiply(3.0f, Subtract(p[1], p[2])));
+		Vector3 b = Multiply(3.0f, Add(Subtract(p[0], Multiply(2.0f, p[1])), p[2]));
+		Vector3 c = Multiply(3.0f, Subtract(p[1], p[0]));
+		float h = 1.0f / static_cast<float>(points.size() - 1);
+		float h2 = h * h;
+		float h3 = h2 * h;
+
+		Vector3 point = p[0];
+		Vector3 delta1 = Add(Add(Multiply(h3, a), Multiply(h2, b)), Multiply(h, c));
+		Vector3 delta2 = Add(Multiply(6.0f * h3, a), Multiply(2.0f * h2, b));
+		Vector3 delta3 = Multiply(6.0f * h3, a);
+		for (size_t i = 1; i + 1 < points.size(); ++i)
+		{
+			point = Add(point, delta1);
+			delta1 = Add(delta1, delta2);
+			delta2 = Add(delta2, delta3);
+			points[i] = point;
+		}
+		points[points.size() - 1] = p[3];
+	}
+
+	size_t TessellateAdaptive(const CubicBezier& curve, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix,
+		float tolerance, std::vector<Vector3>& lineVertices)
+	{
+		CurveNode stack[kMaxSubdivisionDepth + 1];
+		CurveNode& root = stack[0];
+		for (int i = 0; i < 4; ++i)
+		{
+			const Vector3& v = curve.controlPoints[i];
+			root.points[i][0] = v.x;
+			root.points[i][1] = v.y;
+			root.points[i][2] = v.z;
+			TransformHomogeneous(v, viewProjectionMatrix, &root.points[i][3]);
+		}
+		root.depth = 0;
+
+		// 二分割するのは、視錐台の一部だけにかかる区間、カメラの後ろにかかる区間、曲がりすぎている区間だけ
+		// それ以外はWangの式で求めた数に等分し、前進差分でまとめて評価する
+		// 前半を先に処理するように後半から積むので、線は始点から終点の順に並ぶ
+		// 深さ優先なので、スタックに積まれるのは最大でも分割回数+1個
+		size_t lineCount = 0;
+		size_t stackSize = 1;
+		Vector3 points[kMaxUniformSegmentCount + 1];
+		while (stackSize > 0)
+		{
+			CurveNode node = stack[--stackSize];
+			uint32_t outsideAll, outsideAny;
+			ClassifyFrustum(node, outsideAll, outsideAny);
+			if (outsideAll != 0)
+			{
+				continue;
+			}
+
+			bool canSplit = node.depth < kMaxSubdivisionDepth;
+			uint32_t segmentCount = UniformSegmentCount(node, viewportMatrix, tolerance);
+			bool shouldSplit = segmentCount == 0 || segmentCount > kMaxUniformSegmentCount || (outsideAny != 0 && node.depth < kCullSubdivisionDepth);
+			if (canSplit && shouldSplit)
+			{
+				Split(node, stack[stackSize + 1], stack[stackSize]);
+				stackSize += 2;
+				continue;
+			}
+
+			// 分割しきれなかった区間(カメラの後ろにかかるものなど)は弦を線にする。描画側でクリップ空間で切り取られる
+			segmentCount = std::clamp(segmentCount, 1u, kMaxUniformSegmentCount);
+			std::span<Vector3> segmentPoints(points, segmentCount + 1);
+			EvaluateUniform(ToCubicBezier(node), segmentPoints);
+			for (uint32_t i = 0; i < segmentCount; ++i)
+			{
+				lineVertices.push_back(segmentPoints[i]);
+				lineVertices.push_back(segmentPoints[i + 1]);
+			}
+			lineCount += segmentCount;
+		}
+		return lineCount;
+	}
+
+	void Curve::SetQuadraticBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2)
+	{
+		SetCubicBezier(MakeQuadraticBezier(controlPoint0, controlPoint1, controlPoint2));
+	}
+
+	void Curve::SetCubicBezier(const CubicBezier& curve)
+	{
+		segments_.assign(1, curve);
+		isArcLengthDirty_ = true;
+	}
+
+	void Curve::SetCatmullRom(std::span<const Vector3> points)
+	{
+		MakeCatmullRomSegments(points, segments_);
+		isArcLengthDirty_ = true;
+	}
+
+	void Curve::SetBSpline(std::span<const Vector3> points)
+	{
+		MakeBSplineSegments(points, segments_);
+		isArcLengthDirty_ = true;
+	}
+
+	void Curve::SetSegments(std::span<const CubicBezier> segments)
+	{
+		segments_.assign(segments.begin(), segments.end());
+		isArcLengthDirty_ = true;
+	}
+
+	Vector3 Curve::Evaluate(float t) const
+	{
+		assert(!segments_.empty());
+		float u = std::clamp(t, 0.0f, 1.0f) * static_cast<float>(segments_.size());
+		size_t segment = (std::min)(static_cast<size_t>(u), segments_.size() - 1);
+		return Math::Evaluate(segments_[segment], u - static_cast<float>(segment));
+	}
+
+	float Curve::GetLength() const
+	{
+		if (isArcLengthDirty_)
+		{
+			BuildArcLengths();
+		}
+		return arcLengths_.back();
+	}
+
+	Vector3 Curve::EvaluateAtDistance(float distance) const
+	{
+		assert(!segments_.empty());
+		size_t segment;
+		float t;
+		FindParameter(distance, segment, t);
+		return Math::Evaluate(segments_[segment], t);
+	}
+
+	void Curve::SampleUniformSpeed(std::span<Vector3> points) const
+	{
+		assert(!segments_.empty());
+		if (points.empty())
+		{
+			return;
+		}
+		float step = points.size() > 1 ? GetLength() / static_cast<float>(points.size() - 1) : 0.0f;
+		for (size_t i = 0; i < points.size(); ++i)
+		{
+			points[i] = EvaluateAtDistance(step * static_cast<float>(i));
+		}
+	}
+
+	void Curve::FindParameter(float distance, size_t& segment, float& t) const
+	{
+		if (isArcLengthDirty_)
+		{
+			BuildArcLengths();
+		}
+
+		// distanceを超える最初の標本を二分探索し、1つ前の標本との間を線形補間する
+		auto upper = std::upper_bound(arcLengths_.begin() + 1, arcLengths_.end() - 1, distance);
+		size_t sample = static_cast<size_t>(upper - arcLengths_.begin()) - 1;
+		float begin = arcLengths_[sample];
+		float length = arcLengths_[sample + 1] - begin;
+		float fraction = length > 0.0f ? std::clamp((distance - begin) / length, 0.0f, 1.0f) : 0.0f;
+
+		segment = sample / kArcLengthSamplesPerSegment;
+		t = (static_cast<float>(sample % kArcLengthSamplesPerSegment) + fraction) / static_cast<float>(kArcLengthSamplesPerSegment);
+	}
+
+	void Curve::BuildArcLengths() const
+	{
+		arcLengths_.resize(segments_.size() * kArcLengthSamplesPerSegment + 1);
+		arcLengths_[0] = 0.0f;
+
+		Vector3 samples[kArcLengthSamplesPerSegment + 1];
+		float length = 0.0f;
+		for (size_t segment = 0; segment < segments_.size(); ++segment)
+		{
+			EvaluateUniform(segments_[segment], samples);
+			for (uint32_t i = 1; i <= kArcLengthSamplesPerSegment; ++i)
+			{
+				length += Length(Subtract(samples[i], samples[i - 1]));
+				arcLengths_[segment * kArcLengthSamplesPerSegment + i] = length;
+			}
+		}
+		isArcLengthDirty_ = false;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 3次ベジエ曲線の1区間
+/// 2次ベジエ、Catmull-Rom、一様B-スプラインもこの形に直してから扱う
+/// </summary>
+struct CubicBezier final
+{
+	Vector3 controlPoints[4];	//!<始点、制御点1、制御点2、終点
+};
+
+namespace Math
+{
+	/*----------いろいろな曲線を3次ベジエに直す関数----------*/
+	// 2次ベジエを次数上げする。形は変わらない
+	CubicBezier MakeQuadraticBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2);
+	// 全ての点を通るCatmull-Rom曲線。両端は端の点を延ばしたものとして扱い、points.size() - 1区間になる
+	void MakeCatmullRomSegments(std::span<const Vector3> points, std::vector<CubicBezier>& segments);
+	// 一様3次B-スプライン。点は通らず、points.size() - 3区間になる(4点未満なら空)
+	void MakeBSplineSegments(std::span<const Vector3> points, std::vector<CubicBezier>& segments);
+
+	/*----------3次ベジエの評価----------*/
+	Vector3 Evaluate(const CubicBezier& curve, float t);
+	// tを0～1で等間隔にしたpoints.size()個の点を、前進差分で加算だけを使って求める
+	// 最後の点は誤差がたまらないように終点をそのまま入れる
+	void EvaluateUniform(const CubicBezier& curve, std::span<Vector3> points);
+	// スクリーン上のずれがおよそtolerance(ピクセル)以内になるように曲線を線に分け、始点と終点を2つずつ並べてlineVerticesの後ろに追加する
+	// 線の数は制御点をスクリーンに射影した曲がり具合から決め(遠近によるゆがみは見ないので目安)、点は前進差分でまとめて求める
+	// 視錐台の一部だけにかかる区間は二分割し、制御点がすべてどれか1枚の平面の外にある部分は捨てるので、見える部分の線だけが残る
+	// 戻り値は追加した線の本数
+	size_t TessellateAdaptive(const CubicBezier& curve, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix,
+		float tolerance, std::vector<Vector3>& lineVertices);
+
+	/// <summary>
+	/// 3次ベジエをつないだ曲線
+	/// 弧長の表は初めて長さを使うときに作り、曲線を変えるまで使い回す
+	/// </summary>
+	class Curve final
+	{
+	public:
+		// 弧長の表で1区間を何個の直線で近似するか
+		static constexpr uint32_t kArcLengthSamplesPerSegment = 16;
+
+		void SetQuadraticBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2);
+		void SetCubicBezier(const CubicBezier& curve);
+		void SetCatmullRom(std::span<const Vector3> points);
+		void SetBSpline(std::span<const Vector3> points);
+		void SetSegments(std::span<const CubicBezier> segments);
+
+		std::span<const CubicBezier> GetSegments() const { return segments_; }
+
+		// tは曲線全体で0～1。区間ごとのパラメータで進むので、速さは一定にならない
+		Vector3 Evaluate(float t) const;
+
+		// 全体の長さ(弧長の表から求めた近似値)
+		float GetLength() const;
+		// 始点から曲線に沿ってdistanceだけ進んだ点。0～GetLength()の外は端の点になる
+		Vector3 EvaluateAtDistance(float distance) const;
+		// 弧長で等間隔に並んだpoints.size()個の点を求める(一定の速さで動かすときの位置)
+		void SampleUniformSpeed(std::span<Vector3> points) const;
+
+	private:
+		// 曲線に沿った距離を、区間の番号と区間内のパラメータにする
+		void FindParameter(float distance, size_t& segment, float& t) const;
+		void BuildArcLengths() const;
+
+		std::vector<CubicBezier> segments_;
+
+		// arcLengths_[segment * kArcLengthSamplesPerSegment + i]は、その区間のt = i / kArcLengthSamplesPerSegmentまでの長さ
+		mutable std::vector<float> arcLengths_;
+		mutable bool isArcLengthDirty_ = true;
+	};
+}
@@ -0,0 +1,84 @@
+#include "DebugDraw.h"
+#include <cassert>
+
+namespace Math
+{
+	namespace
+	{
+		// 最初に確保しておく線の本数
+		const size_t kInitialLineCapacity = 4096;
+
+		struct DebugDrawState final
+		{
+			DebugDrawBackend* backend = nullptr;
+			std::vector<DebugLineVertex> vertices;
+
+			DebugDrawState()
+			{
+				vertices.reserve(kInitialLineCapacity * 2);
+			}
+		};
+
+		DebugDrawState& GetState()
+		{
+			static DebugDrawState state;
+			return state;
+		}
+	}
+
+	void HeadlessDebugDrawBackend::DrawLines(std::span<const DebugLineVertex> vertices)
+	{
+		vertices_.assign(vertices.begin(), vertices.end());
+		++flushCount_;
+	}
+
+	namespace DebugDraw
+	{
+		void SetBackend(DebugDrawBackend* backend)
+		{
+			GetState().backend = backend;
+		}
+
+		DebugDrawBackend* GetBackend()
+		{
+			return GetState().backend;
+		}
+
+		void AddLine(const Vector3& start, const Vector3& end, uint32_t color)
+		{
+			std::vector<DebugLineVertex>& vertices = GetState().vertices;
+			vertices.push_back({ start.x, start.y, color });
+			vertices.push_back({ end.x, end.y, color });
+		}
+
+		std::span<DebugLineVertex> AllocateLines(size_t lineCount)
+		{
+			std::vector<DebugLineVertex>& vertices = GetState().vertices;
+			size_t offset = vertices.size();
+			vertices.resize(offset + lineCount * 2);
+			return std::span<DebugLineVertex>(vertices).subspan(offset);
+		}
+
+		void ReleaseLines(size_t lineCount)
+		{
+			std::vector<DebugLineVertex>& vertices = GetState().vertices;
+			assert(lineCount * 2 <= vertices.size());
+			vertices.resize(vertices.size() - lineCount * 2);
+		}
+
+		void Flush()
+		{
+			DebugDrawState& state = GetState();
+			if (state.backend)
+			{
+				state.backend->DrawLines(state.vertices);
+			}
+			state.vertices.clear();
+		}
+
+		size_t GetLineCount()
+		{
+			return GetState().vertices.size() / 2;
+		}
+	}
+}
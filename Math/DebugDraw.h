@@ -0,0 +1,75 @@
+#pragma once
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Math
+{
+	/// <summary>
+	/// スクリーン座標系の線の端点
+	/// </summary>
+	struct DebugLineVertex final
+	{
+		float x;		//!<X座標
+		float y;		//!<Y座標
+		uint32_t color;	//!<色
+	};
+
+	/// <summary>
+	/// 溜めた線を実際に描画する先
+	/// </summary>
+	class DebugDrawBackend
+	{
+	public:
+		virtual ~DebugDrawBackend() = default;
+
+		// verticesは始点と終点が2つずつ並んでいる
+		virtual void DrawLines(std::span<const DebugLineVertex> vertices) = 0;
+	};
+
+	/// <summary>
+	/// 描画せずに線を記録するだけのバックエンド
+	/// ウィンドウのない環境での計測や確認に使う
+	/// </summary>
+	class HeadlessDebugDrawBackend final : public DebugDrawBackend
+	{
+	public:
+		void DrawLines(std::span<const DebugLineVertex> vertices) override;
+
+		// 直前のFlushで受け取った線
+		const std::vector<DebugLineVertex>& GetVertices() const { return vertices_; }
+		size_t GetLineCount() const { return vertices_.size() / 2; }
+		uint32_t GetFlushCount() const { return flushCount_; }
+
+	private:
+		std::vector<DebugLineVertex> vertices_;
+		uint32_t flushCount_ = 0;
+	};
+
+	// Draw*関数が引く線を1フレーム分溜めておき、Flushでまとめてバックエンドに渡す
+	// 溜める配列はフレームをまたいで使い回すので、線の数が増えない限りメモリ確保は起きない
+	// Novice::EndFrameの前にFlushを呼ぶこと
+	namespace DebugDraw
+	{
+		// バックエンドがnullptrのとき、Flushは線を捨てるだけになる
+		void SetBackend(DebugDrawBackend* backend);
+		DebugDrawBackend* GetBackend();
+
+		// start, endはスクリーン座標系
+		void AddLine(const Vector3& start, const Vector3& end, uint32_t color);
+
+		// lineCount本分の端点を確保して返す。呼び出し側で2つずつ書き込む
+		// 次にAddLine/AllocateLines/Flushを呼ぶまで有効
+		std::span<DebugLineVertex> AllocateLines(size_t lineCount);
+		// 直前にAllocateLinesで確保した線のうち、末尾のlineCount本を使わずに返す
+		void ReleaseLines(size_t lineCount);
+
+		// 溜めた線をバックエンドに渡して空にする
+		void Flush();
+
+		// 溜まっている線の本数
+		size_t GetLineCount();
+	}
+}
@@ -0,0 +1,350 @@
+#include "DrawFunction.h"
+#include "Camera.h"
+#include "Curve.h"
+#include "Frustum.h"
+#include "GridRenderer.h"
+#include "SphereMesh.h"
+#include <bit>
+#include <vector>
+
+namespace Math
+{
+	// DrawPlaneで描く四角形の中心から角までの距離
+	static const float kPlaneDrawRadius = 2.0f;
+	// DrawControlPointで描く球の半径
+	static const float kControlPointRadius = 0.01f;
+	// 曲線を線で近似するときに許す、スクリーン上のずれ(ピクセル)
+	static const float kCurveTolerance = 0.5f;
+
+	// Draw*関数が線を切り取るときの面
+	static LineClipMode sLineClipMode = LineClipMode::Near;
+
+	// 以下のstatic関数はワールド座標からクリップ空間への変換行列(ビュー・プロジェクション)とビューポート行列を受け取る
+	static void DrawGridClipped(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix)
+	{
+		//Grid用。半分の幅2.0f、分割数10で、線の端点は最初の呼び出しで1度だけ作る
+		static GridRenderer gridRenderer(2.0f, 10);
+		gridRenderer.Draw(viewProjectionMatrix, viewportMatrix, 0x6F6F6FFF, sLineClipMode);
+	}
+
+	static void DrawSphereClipped(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		//球体用。スクリーン上の大きさで分割数(最大20)を選び、キャッシュした単位球を描画する
+		SphereMesh::Get(SphereMesh::SelectSubdivision(sphere, viewProjectionMatrix, viewportMatrix)).Draw(sphere, viewProjectionMatrix, viewportMatrix, color, sLineClipMode);
+	}
+
+	static void DrawPlaneClipped(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		Vector3 center = Multiply(plane.distance, plane.normal);
+		Vector3 perpendiculars[4];
+		perpendiculars[0] = Normalize(Perpendicular(plane.normal));
+		perpendiculars[1] = { -perpendiculars[0].x,-perpendiculars[0].y,-perpendiculars[0].z };
+		perpendiculars[2] = Cross(plane.normal, perpendiculars[0]);
+		perpendiculars[3] = { -perpendiculars[2].x,-perpendiculars[2].y,-perpendiculars[2].z };
+
+		// 平面の四隅を計算
+		Vector3 points[4];
+		for (int32_t index = 0; index < 4; index++)
+		{
+			Vector3 extend = Multiply(kPlaneDrawRadius, perpendiculars[index]);
+			points[index] = Add(center, extend);
+		}
+
+		static const uint16_t kLineIndices[] = { 0, 2, 1, 3, 2, 1, 3, 0 };
+		DrawClippedLines(points, kLineIndices, viewProjectionMatrix, viewportMatrix, color, sLineClipMode);
+	}
+
+	static void DrawTriangleClipped(const Triangle& triangle, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		// ワイヤーフレームなので3本の線として描画する
+		static const uint16_t kLineIndices[] = { 0, 1, 1, 2, 2, 0 };
+		DrawClippedLines(triangle.vertices, kLineIndices, viewProjectionMatrix, viewportMatrix, color, sLineClipMode);
+	}
+
+	static void DrawAABBClipped(const AABB& aabb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		Vector3 vertices[8];
+		vertices[0] = { aabb.min.x, aabb.min.y, aabb.min.z };
+		vertices[1] = { aabb.max.x, aabb.min.y, aabb.min.z };
+		vertices[2] = { aabb.min.x, aabb.max.y, aabb.min.z };
+		vertices[3] = { aabb.max.x, aabb.max.y, aabb.min.z };
+		vertices[4] = { aabb.min.x, aabb.min.y, aabb.max.z };
+		vertices[5] = { aabb.max.x, aabb.min.y, aabb.max.z };
+		vertices[6] = { aabb.min.x, aabb.max.y, aabb.max.z };
+		vertices[7] = { aabb.max.x, aabb.max.y, aabb.max.z };
+
+		static const uint16_t kLineIndices[] = {
+			0, 1, 0, 2, 0, 4, 1, 3, 1, 5, 2, 3,
+			2, 6, 3, 7, 4, 5, 4, 6, 5, 7, 6, 7,
+		};
+		DrawClippedLines(vertices, kLineIndices, viewProjectionMatrix, viewportMatrix, color, sLineClipMode);
+	}
+
+	// 曲線の区間をスクリーン上の曲がり具合に合わせて線に分け、見える部分だけを描画する
+	static void DrawCurveSegmentsClipped(std::span<const CubicBezier> segments, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		// 線の端点は呼び出しごとに作り直すので、配列だけを使い回す
+		static std::vector<Vector3> lineVertices;
+		lineVertices.clear();
+		for (const CubicBezier& segment : segments)
+		{
+			TessellateAdaptive(segment, viewProjectionMatrix, viewportMatrix, kCurveTolerance, lineVertices);
+		}
+		DrawClippedLines(lineVertices, viewProjectionMatrix, viewportMatrix, color, sLineClipMode);
+	}
+
+	static void DrawBezierClipped(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		// 2次ベジエは3次ベジエに直して描画する
+		CubicBezier curve = MakeQuadraticBezier(controlPoint0, controlPoint1, controlPoint2);
+		DrawCurveSegmentsClipped({ &curve, 1 }, viewProjectionMatrix, viewportMatrix, color);
+	}
+
+	static void DrawControlPointClipped(const Vector3& controlPoint, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix)
+	{
+		Sphere sphere = { controlPoint, kControlPointRadius };						// 0.01mの半径の球体
+		DrawSphereClipped(sphere, viewProjectionMatrix, viewportMatrix, 0x000000);	// 黒色で描画
+	}
+
+	static void DrawOBBClipped(const OBB& obb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		Vector3 corners[8];
+
+		// OBBの8つの頂点を計算する
+		Vector3 halfSize = { obb.size.x / 2.0f, obb.size.y / 2.0f, obb.size.z / 2.0f };
+		Vector3 right = obb.orientations[0];
+		Vector3 up = obb.orientations[1];
+		Vector3 forward = obb.orientations[2];
+
+		// 8つの頂点を計算
+		corners[0] = obb.center - right * halfSize.x - up * halfSize.y - forward * halfSize.z; // 左下手前
+		corners[1] = obb.center + right * halfSize.x - up * halfSize.y - forward * halfSize.z; // 右下手前
+		corners[2] = obb.center + right * halfSize.x + up * halfSize.y - forward * halfSize.z; // 右上手前
+		corners[3] = obb.center - right * halfSize.x + up * halfSize.y - forward * halfSize.z; // 左上手前
+		corners[4] = obb.center - right * halfSize.x - up * halfSize.y + forward * halfSize.z; // 左下奥
+		corners[5] = obb.center + right * halfSize.x - up * halfSize.y + forward * halfSize.z; // 右下奥
+		corners[6] = obb.center + right * halfSize.x + up * halfSize.y + forward * halfSize.z; // 右上奥
+		corners[7] = obb.center - right * halfSize.x + up * halfSize.y + forward * halfSize.z; // 左上奥
+
+		// 立方体の12本のエッジを描画する
+		static const uint16_t kLineIndices[] = {
+			0, 1, 1, 2, 2, 3, 3, 0,	// 手前の面
+			4, 5, 5, 6, 6, 7, 7, 4,	// 奥の面
+			0, 4, 1, 5, 2, 6, 3, 7,	// 手前と奥をつなぐ辺
+		};
+		DrawClippedLines(corners, kLineIndices, viewProjectionMatrix, viewportMatrix, color, sLineClipMode);
+	}
+
+	// 以下はカリング用。見えないものは分割や座標変換をする前に捨てる
+	// 描画する線をすべて含む形状で判定するので、見えているものを捨てることはない
+	static Sphere PlaneBoundingSphere(const Plane& plane)
+	{
+		return { Multiply(plane.distance, plane.normal), kPlaneDrawRadius };
+	}
+
+	// hitMaskのビットが立っている要素だけdrawを呼ぶ
+	template <class Draw>
+	static void ForEachVisible(std::span<const uint32_t> hitMask, size_t count, const Draw& draw)
+	{
+		for (size_t word = 0; word < HitMaskWordCount(count); ++word)
+		{
+			for (uint32_t bits = hitMask[word]; bits != 0; bits &= bits - 1)
+			{
+				draw(word * 32 + std::countr_zero(bits));
+			}
+		}
+	}
+
+	void SetLineClipMode(LineClipMode mode)
+	{
+		sLineClipMode = mode;
+	}
+
+	void DrawGrid(const Matrix4x4& ViewProjectionMatrix, const Matrix4x4& ViewportMatrix)
+	{
+		DrawGridClipped(ViewProjectionMatrix, ViewportMatrix);
+	}
+
+	void DrawGrid(const Camera& camera)
+	{
+		DrawGridClipped(camera.GetViewProjectionMatrix(), camera.GetViewportMatrix());
+	}
+
+	void DrawSphere(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		if (!IsCollision(MakeFrustum(viewProjectionMatrix), sphere))
+		{
+			return;
+		}
+		DrawSphereClipped(sphere, viewProjectionMatrix, viewportMatrix, color);
+	}
+
+	void DrawSphere(const Sphere& sphere, const Camera& camera, uint32_t color)
+	{
+		if (!IsCollision(camera.GetFrustum(), sphere))
+		{
+			return;
+		}
+		DrawSphereClipped(sphere, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+	}
+
+	void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		if (!IsCollision(MakeFrustum(viewProjectionMatrix), PlaneBoundingSphere(plane)))
+		{
+			return;
+		}
+		DrawPlaneClipped(plane, viewProjectionMatrix, viewportMatrix, color);
+	}
+
+	void DrawPlane(const Plane& plane, const Camera& camera, uint32_t color)
+	{
+		if (!IsCollision(camera.GetFrustum(), PlaneBoundingSphere(plane)))
+		{
+			return;
+		}
+		DrawPlaneClipped(plane, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+	}
+
+	void DrawTriangle(const Triangle& triangle, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		if (!IsCollision(MakeFrustum(viewProjectionMatrix), MakeAABB(triangle)))
+		{
+			return;
+		}
+		DrawTriangleClipped(triangle, viewProjectionMatrix, viewportMatrix, color);
+	}
+
+	void DrawTriangle(const Triangle& triangle, const Camera& camera, uint32_t color)
+	{
+		if (!IsCollision(camera.GetFrustum(), MakeAABB(triangle)))
+		{
+			return;
+		}
+		DrawTriangleClipped(triangle, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+	}
+
+	void DrawAABB(const AABB& aabb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		if (!IsCollision(MakeFrustum(viewProjectionMatrix), aabb))
+		{
+			return;
+		}
+		DrawAABBClipped(aabb, viewProjectionMatrix, viewportMatrix, color);
+	}
+
+	void DrawAABB(const AABB& aabb, const Camera& camera, uint32_t color)
+	{
+		if (!IsCollision(camera.GetFrustum(), aabb))
+		{
+			return;
+		}
+		DrawAABBClipped(aabb, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+	}
+
+	void DrawBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		// 曲線は制御点を頂点とする三角形に収まる
+		if (!IsCollision(MakeFrustum(viewProjection), MakeAABB(Triangle{ { controlPoint0, controlPoint1, controlPoint2 } })))
+		{
+			return;
+		}
+		DrawBezierClipped(controlPoint0, controlPoint1, controlPoint2, viewProjection, viewportMatrix, color);
+	}
+
+	void DrawBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2, const Camera& camera, uint32_t color)
+	{
+		// 曲線は制御点を頂点とする三角形に収まる
+		if (!IsCollision(camera.GetFrustum(), MakeAABB(Triangle{ { controlPoint0, controlPoint1, controlPoint2 } })))
+		{
+			return;
+		}
+		DrawBezierClipped(controlPoint0, controlPoint1, controlPoint2, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+	}
+
+	void DrawCurve(const Curve& curve, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		// 区間ごとのカリングはTessellateAdaptiveが制御点で行う
+		DrawCurveSegmentsClipped(curve.GetSegments(), viewProjectionMatrix, viewportMatrix, color);
+	}
+
+	void DrawCurve(const Curve& curve, const Camera& camera, uint32_t color)
+	{
+		DrawCurveSegmentsClipped(curve.GetSegments(), camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+	}
+
+	void DrawControlPoint(const Vector3& controlPoint, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix)
+	{
+		if (!IsCollision(MakeFrustum(viewProjection), Sphere{ controlPoint, kControlPointRadius }))
+		{
+			return;
+		}
+		DrawControlPointClipped(controlPoint, viewProjection, viewportMatrix);
+	}
+
+	void DrawControlPoint(const Vector3& controlPoint, const Camera& camera)
+	{
+		if (!IsCollision(camera.GetFrustum(), Sphere{ controlPoint, kControlPointRadius }))
+		{
+			return;
+		}
+		DrawControlPointClipped(controlPoint, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix());
+	}
+
+	void DrawOBB(const OBB& obb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+	{
+		if (!IsCollision(MakeFrustum(viewProjectionMatrix), obb))
+		{
+			return;
+		}
+		DrawOBBClipped(obb, viewProjectionMatrix, viewportMatrix, color);
+	}
+
+	void DrawOBB(const OBB& obb, const Camera& camera, uint32_t color)
+	{
+		if (!IsCollision(camera.GetFrustum(), obb))
+		{
+			return;
+		}
+		DrawOBBClipped(obb, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+	}
+
+	void DrawSpheres(const SphereSoA& spheres, const Camera& camera, uint32_t color)
+	{
+		std::vector<uint32_t> hitMask(HitMaskWordCount(spheres.Count()));
+		IsCollisionBatch(camera.GetFrustum(), spheres, hitMask);
+		ForEachVisible(hitMask, spheres.Count(), [&](size_t i)
+		{
+			Sphere sphere = { { spheres.center[0][i], spheres.center[1][i], spheres.center[2][i] }, spheres.radius[i] };
+			DrawSphereClipped(sphere, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+		});
+	}
+
+	void DrawAABBs(const AABBSoA& aabbs, const Camera& camera, uint32_t color)
+	{
+		std::vector<uint32_t> hitMask(HitMaskWordCount(aabbs.Count()));
+		IsCollisionBatch(camera.GetFrustum(), aabbs, hitMask);
+		ForEachVisible(hitMask, aabbs.Count(), [&](size_t i)
+		{
+			AABB aabb = { { aabbs.min[0][i], aabbs.min[1][i], aabbs.min[2][i] }, { aabbs.max[0][i], aabbs.max[1][i], aabbs.max[2][i] } };
+			DrawAABBClipped(aabb, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+		});
+	}
+
+	void DrawOBBs(const OBBSoA& obbs, const Camera& camera, uint32_t color)
+	{
+		std::vector<uint32_t> hitMask(HitMaskWordCount(obbs.Count()));
+		IsCollisionBatch(camera.GetFrustum(), obbs, hitMask);
+		ForEachVisible(hitMask, obbs.Count(), [&](size_t i)
+		{
+			OBB obb{};
+			obb.center = { obbs.center[0][i], obbs.center[1][i], obbs.center[2][i] };
+			for (int a = 0; a < 3; ++a)
+			{
+				obb.orientations[a] = { obbs.orientations[a][0][i], obbs.orientations[a][1][i], obbs.orientations[a][2][i] };
+			}
+			obb.size = { obbs.size[0][i], obbs.size[1][i], obbs.size[2][i] };
+			DrawOBBClipped(obb, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color);
+		});
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "ClipSpaceLines.h"
+#include "CollisionBatch.h"
+#include "MathFunction.h"
+#include <cstdint>
+
+// デバッグ用の立体の描画
+// 線はDebugDrawに溜まるので、描画するにはバックエンドを設定してFlushを呼ぶ
+// 線はクリップ空間で切り取ってからwで割るので、カメラの後ろに回り込んでも壊れた線にならない
+// 計算や衝突判定だけを使うときは、このファイル(と描画用のソース)は要らない
+namespace Math
+{
+	class Camera;
+	class Curve;
+
+	// 線を切り取る面を選ぶ。初期値は近平面だけ(LineClipMode::Near)
+	void SetLineClipMode(LineClipMode mode);
+
+	/*----------立体を描画する関数----------*/
+	void DrawGrid(const Matrix4x4& ViewProjectionMatrix, const Matrix4x4& ViewportMatrix);
+	void DrawGrid(const Camera& camera);
+	void DrawSphere(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+	void DrawSphere(const Sphere& sphere, const Camera& camera, uint32_t color);
+	void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+	void DrawPlane(const Plane& plane, const Camera& camera, uint32_t color);
+	void DrawTriangle(const Triangle& triangle, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+	void DrawTriangle(const Triangle& triangle, const Camera& camera, uint32_t color);
+	void DrawAABB(const AABB& aabb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+	void DrawAABB(const AABB& aabb, const Camera& camera, uint32_t color);
+	void DrawBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix, uint32_t color);
+	void DrawBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2, const Camera& camera, uint32_t color);
+	// 曲線はスクリーン上の曲がり具合に合わせて分割し、見える区間だけを線にする
+	void DrawCurve(const Curve& curve, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+	void DrawCurve(const Curve& curve, const Camera& camera, uint32_t color);
+	void DrawControlPoint(const Vector3& controlPoint, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix);
+	void DrawControlPoint(const Vector3& controlPoint, const Camera& camera);
+	void DrawOBB(const OBB& obb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+	void DrawOBB(const OBB& obb, const Camera& camera, uint32_t color);
+
+	// 上の関数は、視錐台の完全に外にあるものを分割や座標変換の前に捨てる
+	// 以下はカリングをSIMDでまとめて行い、見えるものだけを描画する
+	void DrawSpheres(const SphereSoA& spheres, const Camera& camera, uint32_t color);
+	void DrawAABBs(const AABBSoA& aabbs, const Camera& camera, uint32_t color);
+	void DrawOBBs(const OBBSoA& obbs, const Camera& camera, uint32_t color);
+}
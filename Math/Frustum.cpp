@@ -0,0 +1,71 @@
+#include "Frustum.h"
+#include "MathFunction.h"
+#include <cmath>
+
+namespace Math
+{
+	namespace
+	{
+		// a * x + b * y + c * z + d >= 0 を内側とする平面を、法線の長さが1のPlaneにする
+		Plane MakeNormalizedPlane(float a, float b, float c, float d)
+		{
+			float length = std::sqrt(a * a + b * b + c * c);
+			return { MakeVector3(a / length, b / length, c / length), -d / length };
+		}
+
+		// 中心と、各平面の法線方向への広がり(射影した半径)で判定する
+		// 1枚でも完全に外側の平面があれば見えない
+		template <class Radius>
+		bool IsInsideAllPlanes(const Frustum& frustum, const Vector3& center, const Radius& projectedRadius)
+		{
+			for (const Plane& plane : frustum.planes)
+			{
+				if (Dot(plane.normal, center) - plane.distance < -projectedRadius(plane.normal))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	Frustum MakeFrustum(const Matrix4x4& viewProjectionMatrix)
+	{
+		// 行ベクトルなので、クリップ座標のx, y, z, wは行列の各列と点の内積になる
+		// -w <= x <= w, -w <= y <= w, 0 <= z <= w の各不等式が1枚の平面になる
+		const Matrix4x4& m = viewProjectionMatrix;
+		Frustum frustum{};
+		frustum.planes[0] = MakeNormalizedPlane(m.m[0][3] + m.m[0][0], m.m[1][3] + m.m[1][0], m.m[2][3] + m.m[2][0], m.m[3][3] + m.m[3][0]);
+		frustum.planes[1] = MakeNormalizedPlane(m.m[0][3] - m.m[0][0], m.m[1][3] - m.m[1][0], m.m[2][3] - m.m[2][0], m.m[3][3] - m.m[3][0]);
+		frustum.planes[2] = MakeNormalizedPlane(m.m[0][3] + m.m[0][1], m.m[1][3] + m.m[1][1], m.m[2][3] + m.m[2][1], m.m[3][3] + m.m[3][1]);
+		frustum.planes[3] = MakeNormalizedPlane(m.m[0][3] - m.m[0][1], m.m[1][3] - m.m[1][1], m.m[2][3] - m.m[2][1], m.m[3][3] - m.m[3][1]);
+		frustum.planes[4] = MakeNormalizedPlane(m.m[0][2], m.m[1][2], m.m[2][2], m.m[3][2]);
+		frustum.planes[5] = MakeNormalizedPlane(m.m[0][3] - m.m[0][2], m.m[1][3] - m.m[1][2], m.m[2][3] - m.m[2][2], m.m[3][3] - m.m[3][2]);
+		return frustum;
+	}
+
+	bool IsCollision(const Frustum& frustum, const Sphere& sphere)
+	{
+		return IsInsideAllPlanes(frustum, sphere.center, [&](const Vector3&) { return sphere.radius; });
+	}
+
+	bool IsCollision(const Frustum& frustum, const AABB& aabb)
+	{
+		Vector3 center = Multiply(0.5f, Add(aabb.min, aabb.max));
+		Vector3 extent = Multiply(0.5f, Subtract(aabb.max, aabb.min));
+		return IsInsideAllPlanes(frustum, center, [&](const Vector3& normal)
+		{
+			return std::abs(normal.x) * extent.x + std::abs(normal.y) * extent.y + std::abs(normal.z) * extent.z;
+		});
+	}
+
+	bool IsCollision(const Frustum& frustum, const OBB& obb)
+	{
+		// sizeは辺の長さ(DrawOBB、IsCollisionBatchと同じ)
+		Vector3 extent = Multiply(0.5f, obb.size);
+		return IsInsideAllPlanes(frustum, obb.center, [&](const Vector3& normal)
+		{
+			return std::abs(Dot(normal, obb.orientations[0])) * extent.x + std::abs(Dot(normal, obb.orientations[1])) * extent.y + std::abs(Dot(normal, obb.orientations[2])) * extent.z;
+		});
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "AABB.h"
+#include "Matrix4x4.h"
+#include "OBB.h"
+#include "Plane.h"
+#include "Sphereh.h"
+
+/// <summary>
+/// 視錐台
+/// 平面の法線は内側を向いていて、Dot(normal, point) - distance >= 0 なら平面の内側
+/// </summary>
+struct Frustum final
+{
+	Plane planes[6];	//!<左、右、下、上、近、遠
+};
+
+namespace Math
+{
+	// ビュー・プロジェクション行列から6枚の平面を取り出す
+	// 深度が0～1になる射影行列(MakePerspectiveFovMatrix、MakeOrthographicMatrix)を前提にする
+	Frustum MakeFrustum(const Matrix4x4& viewProjectionMatrix);
+
+	/*----------視錐台との判定----------*/
+	// どれか1枚の平面の完全に外側にあるときだけfalseを返す
+	// 視錐台の角の近くでは、外にあってもtrueになることがある(カリングには問題ない)
+	bool IsCollision(const Frustum& frustum, const Sphere& sphere);
+	bool IsCollision(const Frustum& frustum, const AABB& aabb);
+	bool IsCollision(const Frustum& frustum, const OBB& obb);
+}
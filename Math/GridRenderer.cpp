@@ -0,0 +1,61 @@
+#include "GridRenderer.h"
+#include "Camera.h"
+
+namespace Math
+{
+	GridRenderer::GridRenderer(float halfWidth, uint32_t subdivision)
+		: halfWidth_(halfWidth), subdivision_(subdivision)
+	{
+		BuildVertices();
+	}
+
+	void GridRenderer::SetHalfWidth(float halfWidth)
+	{
+		if (halfWidth_ == halfWidth)
+		{
+			return;
+		}
+		halfWidth_ = halfWidth;
+		BuildVertices();
+	}
+
+	void GridRenderer::SetSubdivision(uint32_t subdivision)
+	{
+		if (subdivision_ == subdivision || subdivision == 0)
+		{
+			return;
+		}
+		subdivision_ = subdivision;
+		BuildVertices();
+	}
+
+	void GridRenderer::BuildVertices()
+	{
+		const float kGridEvery = (halfWidth_ * 2.0f) / float(subdivision_);	//1つ分の長さ
+
+		vertices_.clear();
+		vertices_.reserve(GetLineCount() * 2);
+		for (uint32_t index = 0; index <= subdivision_; index++)
+		{
+			float pos = -halfWidth_ + kGridEvery * index;
+
+			//奥から手前への線 (X軸上の位置が変わる)
+			vertices_.push_back({ pos, 0.0f, -halfWidth_ });
+			vertices_.push_back({ pos, 0.0f, halfWidth_ });
+
+			//左から右への線 (Z軸上の位置が変わる)
+			vertices_.push_back({ -halfWidth_, 0.0f, pos });
+			vertices_.push_back({ halfWidth_, 0.0f, pos });
+		}
+	}
+
+	void GridRenderer::Draw(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode)
+	{
+		DrawClippedLines(vertices_, viewProjectionMatrix, viewportMatrix, color, mode);
+	}
+
+	void GridRenderer::Draw(const Camera& camera, uint32_t color, LineClipMode mode)
+	{
+		Draw(camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), color, mode);
+	}
+}
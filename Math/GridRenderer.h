@@ -0,0 +1,44 @@
+#pragma once
+#include "ClipSpaceLines.h"
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <vector>
+
+namespace Math
+{
+	class Camera;
+
+	/// <summary>
+	/// XZ平面上のグリッドを描画する
+	/// 線の端点は設定が変わったときだけ作り直し、描画時にまとめてクリップ空間に変換し、線を切り取ってからスクリーン座標にする
+	/// 縦横それぞれ(分割数 + 1)本の線を1回ずつ引く
+	/// </summary>
+	class GridRenderer final
+	{
+	public:
+		explicit GridRenderer(float halfWidth = 2.0f, uint32_t subdivision = 10);
+
+		void SetHalfWidth(float halfWidth);
+		void SetSubdivision(uint32_t subdivision);
+
+		float GetHalfWidth() const { return halfWidth_; }
+		uint32_t GetSubdivision() const { return subdivision_; }
+
+		// 描画する線の本数 (2 * (分割数 + 1))
+		uint32_t GetLineCount() const { return 2 * (subdivision_ + 1); }
+
+		void Draw(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color = 0x6F6F6FFF, LineClipMode mode = LineClipMode::Near);
+		void Draw(const Camera& camera, uint32_t color = 0x6F6F6FFF, LineClipMode mode = LineClipMode::Near);
+
+	private:
+		// 線の端点を作り直す
+		void BuildVertices();
+
+		float halfWidth_;
+		uint32_t subdivision_;
+
+		// 2つずつ並べた線の始点と終点 (ワールド座標)
+		std::vector<Vector3> vertices_;
+	};
+}
@@ -0,0 +1,153 @@
+#include "MappedFile.h"
+#include <utility>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Math
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: data_(std::exchange(other.data_, nullptr))
+		, size_(std::exchange(other.size_, 0))
+		, isOpen_(std::exchange(other.isOpen_, false))
+	{
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			data_ = std::exchange(other.data_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+			isOpen_ = std::exchange(other.isOpen_, false);
+		}
+		return *this;
+	}
+
+#if defined(_WIN32)
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return false;
+		}
+		if (fileSize.QuadPart == 0)
+		{
+			// 大きさ0のファイルはマップできないので、空のまま開いたことにする
+			CloseHandle(file);
+			isOpen_ = true;
+			return true;
+		}
+
+		// ビューがマッピングを参照し続けるので、ハンドルはビューを作ったらすぐに閉じてよい
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (mapping == nullptr)
+		{
+			return false;
+		}
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (view == nullptr)
+		{
+			return false;
+		}
+
+		data_ = static_cast<const char*>(view);
+		size_ = static_cast<size_t>(fileSize.QuadPart);
+		isOpen_ = true;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data_ != nullptr)
+		{
+			UnmapViewOfFile(data_);
+		}
+		data_ = nullptr;
+		size_ = 0;
+		isOpen_ = false;
+	}
+#else
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
+
+		struct stat status;
+		if (::fstat(file, &status) != 0)
+		{
+			::close(file);
+			return false;
+		}
+		if (status.st_size == 0)
+		{
+			// 大きさ0のファイルはマップできないので、空のまま開いたことにする
+			::close(file);
+			isOpen_ = true;
+			return true;
+		}
+
+		// マップしたあとはファイルディスクリプタを閉じてもよい
+		size_t size = static_cast<size_t>(status.st_size);
+		void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file);
+		if (view == MAP_FAILED)
+		{
+			return false;
+		}
+		// 先頭から順に読むことを伝えて、先読みを増やしてもらう
+		::madvise(view, size, MADV_SEQUENTIAL);
+
+		data_ = static_cast<const char*>(view);
+		size_ = size;
+		isOpen_ = true;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data_ != nullptr)
+		{
+			::munmap(const_cast<char*>(data_), size_);
+		}
+		data_ = nullptr;
+		size_ = 0;
+		isOpen_ = false;
+	}
+#endif
+}
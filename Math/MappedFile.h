@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace Math
+{
+	/// <summary>
+	/// 読み取り専用でメモリマップしたファイル
+	/// 中身はコピーせずにOSのページキャッシュをそのまま参照するので、大きなファイルでも開くのは一瞬で済む
+	/// (Windowsはfile mapping、それ以外はmmap)
+	/// </summary>
+	class MappedFile final
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// 開けなかったらfalseを返す。空のファイルは開けるが、GetDataは空になる
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		bool IsOpen() const { return isOpen_; }
+		// ファイルの中身。Closeするかこのオブジェクトが破棄されるまで有効
+		std::span<const char> GetData() const { return { data_, size_ }; }
+
+	private:
+		const char* data_ = nullptr;
+		size_t size_ = 0;
+		bool isOpen_ = false;
+	};
+}
@@ -1,5 +1,6 @@
 #include "MathFunction.h"
-#include "Novice.h"
+#include "MatrixSimd.h"
+#include <cfloat>
 
 namespace Math
 {
@@ -13,77 +14,9 @@ namespace Math
 		return result;
 	}
 
-	Vector3 Add(const Vector3& v1, const Vector3& v2)
-	{
-		return Vector3(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z);
-	}
-
-	Vector3 Subtract(const Vector3& v1, const Vector3& v2)
-	{
-		Vector3 result{};
-		result.x = v1.x - v2.x;
-		result.y = v1.y - v2.y;
-		result.z = v1.z - v2.z;
-		return result;
-	}
-
-	Vector3 Multiply(float scalar, const Vector3& v)
-	{
-		Vector3 result{};
-		result.x = scalar * v.x;
-		result.y = scalar * v.y;
-		result.z = scalar * v.z;
-		return result;
-	}
-
-	float Dot(const Vector3& v1, const Vector3& v2)
-	{
-		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
-	}
-
-	float Length(const Vector3& v)
-	{
-		return sqrtf(powf(v.x, 2) + powf(v.y, 2) + powf(v.z, 2));
-	}
-
-	Vector3 Normalize(const Vector3& v)
-	{
-		float length = Length(v);
-		Vector3 result{};
-		if (length != 0.0) {
-			result.x = v.x / length;
-			result.y = v.y / length;
-			result.z = v.z / length;
-		}
-		return result;
-	}
-
-	Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix)
-	{
-		Vector3 result{};
-		result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
-		result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
-		result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
-		float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
-		assert(w != 0.0f);
-		result.x /= w;
-		result.y /= w;
-		result.z /= w;
-		return result;
-	}
-
-	Vector3 Cross(const Vector3& v1, const Vector3& v2)
-	{
-		Vector3 result{};
-		result.x = v1.y * v2.z - v1.z * v2.y;
-		result.y = v1.z * v2.x - v1.x * v2.z;
-		result.z = v1.x * v2.y - v1.y * v2.x;
-		return result;
-	}
-
 	Vector3 Project(const Vector3& v1, const Vector3& v2)
 	{
-		return Multiply(Dot(v1, v2) / powf(Length(v2), 2), v2);
+		return Multiply(Dot(v1, v2) / LengthSquared(v2), v2);
 	}
 
 	Vector3 ClosestPoint(const Vector3& point, const Segment& segment)
@@ -112,11 +45,6 @@ namespace Math
 		return { 0.0f, -vector.z, vector.y }; // y軸のみの場合
 	}
 
-	Vector3 Lerp(const Vector3& v1, const Vector3& v2, float t)
-	{
-		return Vector3(t * v1.x + (1.0f - t) * v2.x, t * v1.y + (1.0f - t) * v2.y, t * v1.z + (1.0f - t) * v2.z);
-	}
-
 	Vector3 ProjectToScreen(const Vector3& point, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix)
 	{
 		Vector4 clipSpacePoint = Multiply(Vector4{ point.x, point.y, point.z, 1.0f }, viewProjectionMatrix);
@@ -132,157 +60,24 @@ namespace Math
 		return reflection;
 	}
 
-	Matrix4x4 Add(const Matrix4x4& m1, const Matrix4x4& m2)
-	{
-		Matrix4x4 result;
-		for (int i = 0; i < 4; ++i)
-		{
-			for (int j = 0; j < 4; ++j)
-			{
-				result.m[i][j] = m1.m[i][j] + m2.m[i][j];
-			}
-		}
-		return result;
-	}
-
-	Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2)
-	{
-		Matrix4x4 result{};
-		for (int i = 0; i < 4; i++)
-		{
-			for (int j = 0; j < 4; j++)
-			{
-				result.m[i][j] = m1.m[i][j] - m2.m[i][j];
-			}
-		}
-		return result;
-	}
-
 	Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
 	{
-		Matrix4x4 result{};
-		for (int i = 0; i < 4; i++)
-		{
-			for (int j = 0; j < 4; j++)
-			{
-				for (int k = 0; k < 4; k++)
-				{
-					result.m[i][j] += m1.m[i][k] * m2.m[k][j];
-				}
-			}
-		}
-		return result;
+		return MatrixSimd::Multiply(m1, m2);
 	}
 
 	Matrix4x4 Inverse(const Matrix4x4& matrix)
 	{
-		Matrix4x4 result{};
-
-		float det = matrix.m[0][0] * (matrix.m[1][1] * matrix.m[2][2] * matrix.m[3][3] + matrix.m[1][2] * matrix.m[2][3] * matrix.m[3][1] + matrix.m[1][3] * matrix.m[2][1] * matrix.m[3][2] -
-			matrix.m[1][3] * matrix.m[2][2] * matrix.m[3][1] - matrix.m[1][2] * matrix.m[2][1] * matrix.m[3][3] - matrix.m[1][1] * matrix.m[2][3] * matrix.m[3][2]) -
-			matrix.m[0][1] * (matrix.m[1][0] * matrix.m[2][2] * matrix.m[3][3] + matrix.m[1][2] * matrix.m[2][3] * matrix.m[3][0] + matrix.m[1][3] * matrix.m[2][0] * matrix.m[3][2] -
-				matrix.m[1][3] * matrix.m[2][2] * matrix.m[3][0] - matrix.m[1][2] * matrix.m[2][0] * matrix.m[3][3] - matrix.m[1][0] * matrix.m[2][3] * matrix.m[3][2]) +
-			matrix.m[0][2] * (matrix.m[1][0] * matrix.m[2][1] * matrix.m[3][3] + matrix.m[1][1] * matrix.m[2][3] * matrix.m[3][0] + matrix.m[1][3] * matrix.m[2][0] * matrix.m[3][1] -
-				matrix.m[1][3] * matrix.m[2][1] * matrix.m[3][0] - matrix.m[1][1] * matrix.m[2][0] * matrix.m[3][3] - matrix.m[1][0] * matrix.m[2][3] * matrix.m[3][1]) -
-			matrix.m[0][3] * (matrix.m[1][0] * matrix.m[2][1] * matrix.m[3][2] + matrix.m[1][1] * matrix.m[2][2] * matrix.m[3][0] + matrix.m[1][2] * matrix.m[2][0] * matrix.m[3][1] -
-				matrix.m[1][2] * matrix.m[2][1] * matrix.m[3][0] - matrix.m[1][1] * matrix.m[2][0] * matrix.m[3][2] - matrix.m[1][0] * matrix.m[2][2] * matrix.m[3][1]);
-
-		result.m[0][0] = (matrix.m[1][1] * matrix.m[2][2] * matrix.m[3][3] + matrix.m[1][2] * matrix.m[2][3] * matrix.m[3][1] + matrix.m[1][3] * matrix.m[2][1] * matrix.m[3][2] -
-			matrix.m[1][3] * matrix.m[2][2] * matrix.m[3][1] - matrix.m[1][2] * matrix.m[2][1] * matrix.m[3][3] - matrix.m[1][1] * matrix.m[2][3] * matrix.m[3][2]) /
-			det;
-		result.m[0][1] = (-matrix.m[0][1] * matrix.m[2][2] * matrix.m[3][3] - matrix.m[0][2] * matrix.m[2][3] * matrix.m[3][1] - matrix.m[0][3] * matrix.m[2][1] * matrix.m[3][2] +
-			matrix.m[0][3] * matrix.m[2][2] * matrix.m[3][1] + matrix.m[0][2] * matrix.m[2][1] * matrix.m[3][3] + matrix.m[0][1] * matrix.m[2][3] * matrix.m[3][2]) /
-			det;
-		result.m[0][2] = (matrix.m[0][1] * matrix.m[1][2] * matrix.m[3][3] + matrix.m[0][2] * matrix.m[1][3] * matrix.m[3][1] + matrix.m[0][3] * matrix.m[1][1] * matrix.m[3][2] -
-			matrix.m[0][3] * matrix.m[1][2] * matrix.m[3][1] - matrix.m[0][2] * matrix.m[1][1] * matrix.m[3][3] - matrix.m[0][1] * matrix.m[1][3] * matrix.m[3][2]) /
-			det;
-		result.m[0][3] = (-matrix.m[0][1] * matrix.m[1][2] * matrix.m[2][3] - matrix.m[0][2] * matrix.m[1][3] * matrix.m[2][1] - matrix.m[0][3] * matrix.m[1][1] * matrix.m[2][2] +
-			matrix.m[0][3] * matrix.m[1][2] * matrix.m[2][1] + matrix.m[0][2] * matrix.m[1][1] * matrix.m[2][3] + matrix.m[0][1] * matrix.m[1][3] * matrix.m[2][2]) /
-			det;
-
-		result.m[1][0] = (-matrix.m[1][0] * matrix.m[2][2] * matrix.m[3][3] - matrix.m[1][2] * matrix.m[2][3] * matrix.m[3][0] - matrix.m[1][3] * matrix.m[2][0] * matrix.m[3][2] +
-			matrix.m[1][3] * matrix.m[2][2] * matrix.m[3][0] + matrix.m[1][2] * matrix.m[2][0] * matrix.m[3][3] + matrix.m[1][0] * matrix.m[2][3] * matrix.m[3][2]) /
-			det;
-		result.m[1][1] = (matrix.m[0][0] * matrix.m[2][2] * matrix.m[3][3] + matrix.m[0][2] * matrix.m[2][3] * matrix.m[3][0] + matrix.m[0][3] * matrix.m[2][0] * matrix.m[3][2] -
-			matrix.m[0][3] * matrix.m[2][2] * matrix.m[3][0] - matrix.m[0][2] * matrix.m[2][0] * matrix.m[3][3] - matrix.m[0][0] * matrix.m[2][3] * matrix.m[3][2]) /
-			det;
-		result.m[1][2] = (-matrix.m[0][0] * matrix.m[1][2] * matrix.m[3][3] - matrix.m[0][2] * matrix.m[1][3] * matrix.m[3][0] - matrix.m[0][3] * matrix.m[1][0] * matrix.m[3][2] +
-			matrix.m[0][3] * matrix.m[1][2] * matrix.m[3][0] + matrix.m[0][2] * matrix.m[1][0] * matrix.m[3][3] + matrix.m[0][0] * matrix.m[1][3] * matrix.m[3][2]) /
-			det;
-		result.m[1][3] = (matrix.m[0][0] * matrix.m[1][2] * matrix.m[2][3] + matrix.m[0][2] * matrix.m[1][3] * matrix.m[2][0] + matrix.m[0][3] * matrix.m[1][0] * matrix.m[2][2] -
-			matrix.m[0][3] * matrix.m[1][2] * matrix.m[2][0] - matrix.m[0][2] * matrix.m[1][0] * matrix.m[2][3] - matrix.m[0][0] * matrix.m[1][3] * matrix.m[2][2]) /
-			det;
-
-		result.m[2][0] = (matrix.m[1][0] * matrix.m[2][1] * matrix.m[3][3] + matrix.m[1][1] * matrix.m[2][3] * matrix.m[3][0] + matrix.m[1][3] * matrix.m[2][0] * matrix.m[3][1] -
-			matrix.m[1][3] * matrix.m[2][1] * matrix.m[3][0] - matrix.m[1][1] * matrix.m[2][0] * matrix.m[3][3] - matrix.m[1][0] * matrix.m[2][3] * matrix.m[3][1]) /
-			det;
-		result.m[2][1] = (-matrix.m[0][0] * matrix.m[2][1] * matrix.m[3][3] - matrix.m[0][1] * matrix.m[2][3] * matrix.m[3][0] - matrix.m[0][3] * matrix.m[2][0] * matrix.m[3][1] +
-			matrix.m[0][3] * matrix.m[2][1] * matrix.m[3][0] + matrix.m[0][1] * matrix.m[2][0] * matrix.m[3][3] + matrix.m[0][0] * matrix.m[2][3] * matrix.m[3][1]) /
-			det;
-		result.m[2][2] = (matrix.m[0][0] * matrix.m[1][1] * matrix.m[3][3] + matrix.m[0][1] * matrix.m[1][3] * matrix.m[3][0] + matrix.m[0][3] * matrix.m[1][0] * matrix.m[3][1] -
-			matrix.m[0][3] * matrix.m[1][1] * matrix.m[3][0] - matrix.m[0][1] * matrix.m[1][0] * matrix.m[3][3] - matrix.m[0][0] * matrix.m[1][3] * matrix.m[3][1]) /
-			det;
-		result.m[2][3] = (-matrix.m[0][0] * matrix.m[1][1] * matrix.m[2][3] - matrix.m[0][1] * matrix.m[1][3] * matrix.m[2][0] - matrix.m[0][3] * matrix.m[1][0] * matrix.m[2][1] +
-			matrix.m[0][3] * matrix.m[1][1] * matrix.m[2][0] + matrix.m[0][1] * matrix.m[1][0] * matrix.m[2][3] + matrix.m[0][0] * matrix.m[1][3] * matrix.m[2][1]) /
-			det;
-
-		result.m[3][0] = (-matrix.m[1][0] * matrix.m[2][1] * matrix.m[3][2] - matrix.m[1][1] * matrix.m[2][2] * matrix.m[3][0] - matrix.m[1][2] * matrix.m[2][0] * matrix.m[3][1] +
-			matrix.m[1][2] * matrix.m[2][1] * matrix.m[3][0] + matrix.m[1][1] * matrix.m[2][0] * matrix.m[3][2] + matrix.m[1][0] * matrix.m[2][2] * matrix.m[3][1]) /
-			det;
-		result.m[3][1] = (matrix.m[0][0] * matrix.m[2][1] * matrix.m[3][2] + matrix.m[0][1] * matrix.m[2][2] * matrix.m[3][0] + matrix.m[0][2] * matrix.m[2][0] * matrix.m[3][1] -
-			matrix.m[0][2] * matrix.m[2][1] * matrix.m[3][0] - matrix.m[0][1] * matrix.m[2][0] * matrix.m[3][2] - matrix.m[0][0] * matrix.m[2][2] * matrix.m[3][1]) /
-			det;
-		result.m[3][2] = (-matrix.m[0][0] * matrix.m[1][1] * matrix.m[3][2] - matrix.m[0][1] * matrix.m[1][2] * matrix.m[3][0] - matrix.m[0][2] * matrix.m[1][0] * matrix.m[3][1] +
-			matrix.m[0][2] * matrix.m[1][1] * matrix.m[3][0] + matrix.m[0][1] * matrix.m[1][0] * matrix.m[3][2] + matrix.m[0][0] * matrix.m[1][2] * matrix.m[3][1]) /
-			det;
-		result.m[3][3] = (matrix.m[0][0] * matrix.m[1][1] * matrix.m[2][2] + matrix.m[0][1] * matrix.m[1][2] * matrix.m[2][0] + matrix.m[0][2] * matrix.m[1][0] * matrix.m[2][1] -
-			matrix.m[0][2] * matrix.m[1][1] * matrix.m[2][0] - matrix.m[0][1] * matrix.m[1][0] * matrix.m[2][2] - matrix.m[0][0] * matrix.m[1][2] * matrix.m[2][1]) /
-			det;
-
-		return result;
+		return MatrixSimd::Inverse(matrix);
 	}
 
-	Matrix4x4 Transpose(const Matrix4x4& m)
+	Matrix4x4 InverseAffine(const Matrix4x4& matrix)
 	{
-		Matrix4x4 result{};
-		for (int i = 0; i < 4; i++)
-		{
-			for (int j = 0; j < 4; j++)
-			{
-				result.m[i][j] = m.m[j][i];
-			}
-		}
-		return result;
+		return MatrixSimd::InverseAffine(matrix);
 	}
 
-	Matrix4x4 MakeIdentity()
-	{
-		Matrix4x4 result{};
-		for (int i = 0; i < 4; i++)
-		{
-			for (int j = 0; j < 4; j++)
-			{
-				if (i == j)
-				{
-					result.m[i][j] = 1.0f;
-				}
-				else
-				{
-					result.m[i][j] = 0.0f;
-				}
-			}
-		}
-		return result;
-	}
-
-	Matrix4x4 MakeScaleMatrix(const Vector3& scale)
+	Matrix4x4 Transpose(const Matrix4x4& m)
 	{
-		Matrix4x4 result{};
-		result.m[0][0] = scale.x;
-		result.m[1][1] = scale.y;
-		result.m[2][2] = scale.z;
-		result.m[3][3] = 1.0f;
-		return result;
+		return MatrixSimd::Transpose(m);
 	}
 
 	Matrix4x4 MakeRotateXMatrix(float radian)
@@ -321,25 +116,21 @@ namespace Math
 		return result;
 	}
 
-	Matrix4x4 MakeTranslateMatrix(const Vector3& translate)
-	{
-		Matrix4x4 result{};
-		for (int i = 0; i < 4; i++) {
-			for (int j = 0; j < 4; j++) {
-				if (i == j) {
-					result.m[i][j] = 1.0f;
-				}
-			}
-		}
-		result.m[3][0] = translate.x;
-		result.m[3][1] = translate.y;
-		result.m[3][2] = translate.z;
-		return result;
-	}
-
 	Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& radian, const Vector3& translate)
 	{
-		return Multiply(MakeScaleMatrix(scale), Multiply(Multiply(MakeRotateXMatrix(radian.x), Multiply(MakeRotateYMatrix(radian.y), MakeRotateZMatrix(radian.z))), MakeTranslateMatrix(translate)));
+		// 拡縮 * X回転 * Y回転 * Z回転 * 平行移動 を展開して、値の入る12要素を直接書き込む
+		float sx = std::sin(radian.x);
+		float cx = std::cos(radian.x);
+		float sy = std::sin(radian.y);
+		float cy = std::cos(radian.y);
+		float sz = std::sin(radian.z);
+		float cz = std::cos(radian.z);
+		return MakeMatrix4x4({ {
+			{ scale.x * (cy * cz), scale.x * (cy * sz), scale.x * -sy, 0.0f },
+			{ scale.y * (sx * sy * cz - cx * sz), scale.y * (sx * sy * sz + cx * cz), scale.y * (sx * cy), 0.0f },
+			{ scale.z * (cx * sy * cz + sx * sz), scale.z * (cx * sy * sz - sx * cz), scale.z * (cx * cy), 0.0f },
+			{ translate.x, translate.y, translate.z, 1.0f },
+		} });
 	}
 
 	Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip)
@@ -379,252 +170,13 @@ namespace Math
 		return result;
 	}
 
-	void DrawGrid(const Matrix4x4& ViewProjectionMatrix, const Matrix4x4& ViewportMatrix)
-	{
-		//Grid用
-		const float	kGridHalfWidth = 2.0f;										//Gridの半分の幅
-		const uint32_t kSubdivision = 10;										//分割数
-		const float kGridEvery = (kGridHalfWidth * 2.0f) / float(kSubdivision);	//1つ分の長さ
-
-		//水平方向の線を描画
-		for (uint32_t xIndex = 0; xIndex <= kSubdivision; xIndex++)
-		{
-			//上の情報を使ってワールド座標系上の始点と終点を求める
-			//X軸上の座標
-			float posX = -kGridHalfWidth + kGridEvery * xIndex;
-
-			//始点と終点
-			Vector3 start = { posX, 0.0f, -kGridHalfWidth };
-			Vector3 end = { posX, 0.0f, kGridHalfWidth };
-			//// ワールド座標系 -> スクリーン座標系まで変換をかける
-			start = Transform(start, Multiply(ViewProjectionMatrix, ViewportMatrix));
-			end = Transform(end, Multiply(ViewProjectionMatrix, ViewportMatrix));
-
-			//左から右も同じように順々に引いていく
-			for (uint32_t zIndex = 0; zIndex <= kSubdivision; zIndex++)
-			{
-				//奥から手前が左右に代わるだけ
-				//上の情報を使ってワールド座標系上の始点と終点を求める
-				//Z軸上の座標
-				float posZ = -kGridHalfWidth + kGridEvery * zIndex;
-
-				//始点と終点
-				Vector3 startZ = { -kGridHalfWidth, 0.0f, posZ };
-				Vector3 endZ = { kGridHalfWidth, 0.0f, posZ };
-				//// ワールド座標系 -> スクリーン座標系まで変換をかける
-				startZ = Transform(startZ, Multiply(ViewProjectionMatrix, ViewportMatrix));
-				endZ = Transform(endZ, Multiply(ViewProjectionMatrix, ViewportMatrix));
-
-				//変換した画像を使って表示。色は薄い灰色(0xAAAAAAFF)、原点は黒ぐらいがいいが、なんでもいい
-				Novice::DrawLine((int)start.x, (int)start.y, (int)end.x, (int)end.y, 0x6F6F6FFF);
-				Novice::DrawLine((int)startZ.x, (int)startZ.y, (int)endZ.x, (int)endZ.y, 0x6F6F6FFF);
-			}
-		}
-	}
-
-	void DrawSphere(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
-	{
-		//球体用
-		const uint32_t kSubdivision = 20;										//分割数
-		const float kLatStep = (float)M_PI / kSubdivision;						//緯度のステップ
-		const float kLonStep = 2.0f * (float)M_PI / kSubdivision;				//経度のステップ
-
-		// 緯度のループ
-		for (uint32_t latIndex = 0; latIndex < kSubdivision; ++latIndex)
-		{
-			float lat = -0.5f * (float)M_PI + latIndex * kLatStep;	//現在の緯度
-
-			//次の緯度
-			float nextLat = lat + kLatStep;
-
-			//経度のループ
-			for (uint32_t lonIndex = 0; lonIndex < kSubdivision; ++lonIndex)
-			{
-				//現在の経度
-				float lon = lonIndex * kLonStep;
-
-				//次の経度
-				float nextLon = lon + kLonStep;
-
-				// 球面座標の計算
-				Vector3 pointA
-				{
-					sphere.center.x + sphere.radius * cos(lat) * cos(lon),
-					sphere.center.y + sphere.radius * sin(lat),
-					sphere.center.z + sphere.radius * cos(lat) * sin(lon)
-				};
-
-				Vector3 pointB
-				{
-					sphere.center.x + sphere.radius * cos(nextLat) * cos(lon),
-					sphere.center.y + sphere.radius * sin(nextLat),
-					sphere.center.z + sphere.radius * cos(nextLat) * sin(lon)
-				};
-
-				Vector3 pointC
-				{
-					sphere.center.x + sphere.radius * cos(lat) * cos(nextLon),
-					sphere.center.y + sphere.radius * sin(lat),
-					sphere.center.z + sphere.radius * cos(lat) * sin(nextLon)
-				};
-
-				// スクリーン座標に変換
-				pointA = Transform(pointA, Multiply(viewProjectionMatrix, viewportMatrix));
-				pointB = Transform(pointB, Multiply(viewProjectionMatrix, viewportMatrix));
-				pointC = Transform(pointC, Multiply(viewProjectionMatrix, viewportMatrix));
-
-				// 線分の描画
-				Novice::DrawLine((int)pointA.x, (int)pointA.y, (int)pointB.x, (int)pointB.y, color);
-				Novice::DrawLine((int)pointA.x, (int)pointA.y, (int)pointC.x, (int)pointC.y, color);
-			}
-		}
-	}
-
-	void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
-	{
-		Vector3 center = Multiply(plane.distance, plane.normal);
-		Vector3 perpendiculars[4];
-		perpendiculars[0] = Normalize(Perpendicular(plane.normal));
-		perpendiculars[1] = { -perpendiculars[0].x,-perpendiculars[0].y,-perpendiculars[0].z };
-		perpendiculars[2] = Cross(plane.normal, perpendiculars[0]);
-		perpendiculars[3] = { -perpendiculars[2].x,-perpendiculars[2].y,-perpendiculars[2].z };
-
-		// 平面の四隅を計算
-		Vector3 points[4];
-		for (int32_t index = 0; index < 4; index++)
-		{
-			Vector3 extend = Multiply(2.0f, perpendiculars[index]);
-			Vector3 point = Add(center, extend);
-			points[index] = Transform(Transform(point, viewProjectionMatrix), viewportMatrix);
-		}
-
-		Novice::DrawLine((int)points[0].x, (int)points[0].y, (int)points[2].x, (int)points[2].y, color);
-		Novice::DrawLine((int)points[1].x, (int)points[1].y, (int)points[3].x, (int)points[3].y, color);
-		Novice::DrawLine((int)points[2].x, (int)points[2].y, (int)points[1].x, (int)points[1].y, color);
-		Novice::DrawLine((int)points[3].x, (int)points[3].y, (int)points[0].x, (int)points[0].y, color);
-	}
-
-	void DrawTriangle(const Triangle& triangle, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
-	{
-		Vector3 screenVertices[3];
-		for (int i = 0; i < 3; ++i)
-		{
-			screenVertices[i] = Transform(Transform(triangle.vertices[i], viewProjectionMatrix), viewportMatrix);
-		}
-		Novice::DrawTriangle((int)screenVertices[0].x, (int)screenVertices[0].y,
-			(int)screenVertices[1].x, (int)screenVertices[1].y,
-			(int)screenVertices[2].x, (int)screenVertices[2].y,
-			color, kFillModeWireFrame);
-	}
-
-	void DrawAABB(const AABB& aabb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
-	{
-		Vector3 vertices[8];
-		vertices[0] = { aabb.min.x, aabb.min.y, aabb.min.z };
-		vertices[1] = { aabb.max.x, aabb.min.y, aabb.min.z };
-		vertices[2] = { aabb.min.x, aabb.max.y, aabb.min.z };
-		vertices[3] = { aabb.max.x, aabb.max.y, aabb.min.z };
-		vertices[4] = { aabb.min.x, aabb.min.y, aabb.max.z };
-		vertices[5] = { aabb.max.x, aabb.min.y, aabb.max.z };
-		vertices[6] = { aabb.min.x, aabb.max.y, aabb.max.z };
-		vertices[7] = { aabb.max.x, aabb.max.y, aabb.max.z };
-
-		for (int i = 0; i < 8; ++i)
-		{
-			vertices[i] = Transform(vertices[i], Multiply(viewProjectionMatrix, viewportMatrix));
-		}
-
-		Novice::DrawLine((int)vertices[0].x, (int)vertices[0].y, (int)vertices[1].x, (int)vertices[1].y, color);
-		Novice::DrawLine((int)vertices[0].x, (int)vertices[0].y, (int)vertices[2].x, (int)vertices[2].y, color);
-		Novice::DrawLine((int)vertices[0].x, (int)vertices[0].y, (int)vertices[4].x, (int)vertices[4].y, color);
-		Novice::DrawLine((int)vertices[1].x, (int)vertices[1].y, (int)vertices[3].x, (int)vertices[3].y, color);
-		Novice::DrawLine((int)vertices[1].x, (int)vertices[1].y, (int)vertices[5].x, (int)vertices[5].y, color);
-		Novice::DrawLine((int)vertices[2].x, (int)vertices[2].y, (int)vertices[3].x, (int)vertices[3].y, color);
-		Novice::DrawLine((int)vertices[2].x, (int)vertices[2].y, (int)vertices[6].x, (int)vertices[6].y, color);
-		Novice::DrawLine((int)vertices[3].x, (int)vertices[3].y, (int)vertices[7].x, (int)vertices[7].y, color);
-		Novice::DrawLine((int)vertices[4].x, (int)vertices[4].y, (int)vertices[5].x, (int)vertices[5].y, color);
-		Novice::DrawLine((int)vertices[4].x, (int)vertices[4].y, (int)vertices[6].x, (int)vertices[6].y, color);
-		Novice::DrawLine((int)vertices[5].x, (int)vertices[5].y, (int)vertices[7].x, (int)vertices[7].y, color);
-		Novice::DrawLine((int)vertices[6].x, (int)vertices[6].y, (int)vertices[7].x, (int)vertices[7].y, color);
-	}
-
-	void DrawBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix, uint32_t color)
-	{
-		const int kNumSegments = 100; // ベジエ曲線を描画するためのセグメント数
-
-		for (int i = 0; i < kNumSegments; ++i)
-		{
-			float t1 = static_cast<float>(i) / kNumSegments;
-			float t2 = static_cast<float>(i + 1) / kNumSegments;
-
-			Vector3 point1 = Lerp(Lerp(controlPoint0, controlPoint1, t1), Lerp(controlPoint1, controlPoint2, t1), t1);
-			Vector3 point2 = Lerp(Lerp(controlPoint0, controlPoint1, t2), Lerp(controlPoint1, controlPoint2, t2), t2);
-
-			Vector3 screenPoint1 = Transform(point1, viewProjection);
-			screenPoint1 = Transform(screenPoint1, viewportMatrix);
-
-			Vector3 screenPoint2 = Transform(point2, viewProjection);
-			screenPoint2 = Transform(screenPoint2, viewportMatrix);
-
-			Novice::DrawLine((int)screenPoint1.x, (int)screenPoint1.y, (int)screenPoint2.x, (int)screenPoint2.y, color);
-		}
-	}
-
-	void DrawControlPoint(const Vector3& controlPoint, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix)
-	{
-		Sphere sphere = { controlPoint, 0.01f };						// 0.01mの半径の球体
-		DrawSphere(sphere, viewProjection, viewportMatrix, 0x000000);	// 黒色で描画
-	}
-
-	void DrawOBB(const OBB& obb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
-	{
-		Vector3 corners[8];
-
-		// OBBの8つの頂点を計算する
-		Vector3 halfSize = { obb.size.x / 2.0f, obb.size.y / 2.0f, obb.size.z / 2.0f };
-		Vector3 right = obb.orientations[0];
-		Vector3 up = obb.orientations[1];
-		Vector3 forward = obb.orientations[2];
-
-		// 8つの頂点を計算
-		corners[0] = obb.center - right * halfSize.x - up * halfSize.y - forward * halfSize.z; // 左下手前
-		corners[1] = obb.center + right * halfSize.x - up * halfSize.y - forward * halfSize.z; // 右下手前
-		corners[2] = obb.center + right * halfSize.x + up * halfSize.y - forward * halfSize.z; // 右上手前
-		corners[3] = obb.center - right * halfSize.x + up * halfSize.y - forward * halfSize.z; // 左上手前
-		corners[4] = obb.center - right * halfSize.x - up * halfSize.y + forward * halfSize.z; // 左下奥
-		corners[5] = obb.center + right * halfSize.x - up * halfSize.y + forward * halfSize.z; // 右下奥
-		corners[6] = obb.center + right * halfSize.x + up * halfSize.y + forward * halfSize.z; // 右上奥
-		corners[7] = obb.center - right * halfSize.x + up * halfSize.y + forward * halfSize.z; // 左上奥
-
-		// ビュー・プロジェクション行列とビューポート行列を使って各頂点を変換
-		for (int i = 0; i < 8; ++i) {
-			corners[i] = Transform(corners[i], viewProjectionMatrix);
-			corners[i] = Transform(corners[i], viewportMatrix);
-		}
-
-		// 立方体の12本のエッジを描画する
-		Novice::DrawLine((int)corners[0].x, (int)corners[0].y, (int)corners[1].x, (int)corners[1].y, color); // 左下手前 - 右下手前
-		Novice::DrawLine((int)corners[1].x, (int)corners[1].y, (int)corners[2].x, (int)corners[2].y, color); // 右下手前 - 右上手前
-		Novice::DrawLine((int)corners[2].x, (int)corners[2].y, (int)corners[3].x, (int)corners[3].y, color); // 右上手前 - 左上手前
-		Novice::DrawLine((int)corners[3].x, (int)corners[3].y, (int)corners[0].x, (int)corners[0].y, color); // 左上手前 - 左下手前
-
-		Novice::DrawLine((int)corners[4].x, (int)corners[4].y, (int)corners[5].x, (int)corners[5].y, color); // 左下奥 - 右下奥
-		Novice::DrawLine((int)corners[5].x, (int)corners[5].y, (int)corners[6].x, (int)corners[6].y, color); // 右下奥 - 右上奥
-		Novice::DrawLine((int)corners[6].x, (int)corners[6].y, (int)corners[7].x, (int)corners[7].y, color); // 右上奥 - 左上奥
-		Novice::DrawLine((int)corners[7].x, (int)corners[7].y, (int)corners[4].x, (int)corners[4].y, color); // 左上奥 - 左下奥
-
-		Novice::DrawLine((int)corners[0].x, (int)corners[0].y, (int)corners[4].x, (int)corners[4].y, color); // 左下手前 - 左下奥
-		Novice::DrawLine((int)corners[1].x, (int)corners[1].y, (int)corners[5].x, (int)corners[5].y, color); // 右下手前 - 右下奥
-		Novice::DrawLine((int)corners[2].x, (int)corners[2].y, (int)corners[6].x, (int)corners[6].y, color); // 右上手前 - 右上奥
-		Novice::DrawLine((int)corners[3].x, (int)corners[3].y, (int)corners[7].x, (int)corners[7].y, color); // 左上手前 - 左上奥
-	}
-
 	bool IsCollision(const Sphere& s1, const Sphere& s2)
 	{
-		//2つの球の中心点間の距離を求める
-		float distance = Length(Subtract(s2.center, s1.center));
-		// 半径の合計よりも短ければ衝突
-		return distance <= (s1.radius + s2.radius);
+		//2つの球の中心点間の距離の2乗を求める
+		float distanceSquared = LengthSquared(Subtract(s2.center, s1.center));
+		// 半径の合計よりも短ければ衝突(2乗のまま比べてsqrtを省く)
+		float radiusSum = s1.radius + s2.radius;
+		return distanceSquared <= radiusSum * radiusSum;
 	}
 
 	bool IsCollision(const Sphere& sphere, const Plane& plane)
@@ -718,10 +270,10 @@ namespace Math
 			std::clamp(sphere.center.y,aabb.min.y,aabb.max.y),
 			std::clamp(sphere.center.z,aabb.min.z,aabb.max.z)
 		};
-		//最近接点と球の中途の距離を求める
-		float distance = Length(Subtract(clossestPoint, sphere.center));
+		//最近接点と球の中心の距離の2乗を求める
+		float distanceSquared = LengthSquared(Subtract(clossestPoint, sphere.center));
 		//距離が半径よりも小さければ衝突
-		return distance <= sphere.radius;
+		return distanceSquared <= sphere.radius * sphere.radius;
 	}
 
 	bool IsCollision(const AABB& aabb, const Segment& segment)
@@ -751,30 +303,29 @@ namespace Math
 
 	bool IsCollision(const OBB& obb, const Sphere& sphere)
 	{
-		// Step 1: Transform the sphere's center into the OBB's local space
-		Matrix4x4 obbWorldMatrix = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, obb.center);
-		Matrix4x4 obbRotationMatrix = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, {}, Vector3());
-		obbRotationMatrix.m[0][0] = obb.orientations[0].x;
-		obbRotationMatrix.m[0][1] = obb.orientations[0].y;
-		obbRotationMatrix.m[0][2] = obb.orientations[0].z;
+		return IsCollision(MakeCachedOBB(obb), sphere);
+	}
 
-		obbRotationMatrix.m[1][0] = obb.orientations[1].x;
-		obbRotationMatrix.m[1][1] = obb.orientations[1].y;
-		obbRotationMatrix.m[1][2] = obb.orientations[1].z;
+	bool IsCollision(const OBB& obb, const Segment& segment)
+	{
+		return IsCollision(MakeCachedOBB(obb), segment);
+	}
 
-		obbRotationMatrix.m[2][0] = obb.orientations[2].x;
-		obbRotationMatrix.m[2][1] = obb.orientations[2].y;
-		obbRotationMatrix.m[2][2] = obb.orientations[2].z;
+	bool IsCollision(const OBB& obb1, const OBB& obb2)
+	{
+		return IsCollision(MakeCachedOBB(obb1), MakeCachedOBB(obb2));
+	}
 
-		obbWorldMatrix = Multiply(obbWorldMatrix, obbRotationMatrix);
-		Matrix4x4 obbWorldMatrixInverse = Inverse(obbWorldMatrix);
-		Vector3 centerInOBBLocalSpace = Transform(sphere.center, obbWorldMatrixInverse);
+	bool IsCollision(const CachedOBB& obb, const Sphere& sphere)
+	{
+		// Step 1: Transform the sphere's center into the OBB's local space
+		Vector3 centerInOBBLocalSpace = TransformToLocal(obb, sphere.center);
 
 		// Step 2: Find the closest point on the OBB to the sphere center in local space
 		Vector3 closestPoint = centerInOBBLocalSpace;
-		closestPoint.x = std::max(-obb.size.x * 0.5f, std::min(closestPoint.x, obb.size.x * 0.5f));
-		closestPoint.y = std::max(-obb.size.y * 0.5f, std::min(closestPoint.y, obb.size.y * 0.5f));
-		closestPoint.z = std::max(-obb.size.z * 0.5f, std::min(closestPoint.z, obb.size.z * 0.5f));
+		closestPoint.x = std::max(-obb.halfExtents.x, std::min(closestPoint.x, obb.halfExtents.x));
+		closestPoint.y = std::max(-obb.halfExtents.y, std::min(closestPoint.y, obb.halfExtents.y));
+		closestPoint.z = std::max(-obb.halfExtents.z, std::min(closestPoint.z, obb.halfExtents.z));
 
 		// Step 3: Calculate the distance between the sphere center and this closest point
 		Vector3 difference = centerInOBBLocalSpace - closestPoint;
@@ -784,25 +335,11 @@ namespace Math
 		return distanceSquared <= sphere.radius * sphere.radius;
 	}
 
-	bool IsCollision(const OBB& obb, const Segment& segment)
+	bool IsCollision(const CachedOBB& obb, const Segment& segment)
 	{
-		// OBBの回転行列を作成
-		Matrix4x4 rotationMatrix = {
-			obb.orientations[0].x, obb.orientations[0].y, obb.orientations[0].z, 0.0f,
-			obb.orientations[1].x, obb.orientations[1].y, obb.orientations[1].z, 0.0f,
-			obb.orientations[2].x, obb.orientations[2].y, obb.orientations[2].z, 0.0f,
-			0.0f, 0.0f, 0.0f, 1.0f
-		};
-
-		// OBBの逆変換行列（回転の転置行列と平行移動の逆変換）を作成
-		Matrix4x4 obbWorldMatrixInverse = Inverse(rotationMatrix);
-		obbWorldMatrixInverse.m[3][0] = -(obb.center.x * obbWorldMatrixInverse.m[0][0] + obb.center.y * obbWorldMatrixInverse.m[1][0] + obb.center.z * obbWorldMatrixInverse.m[2][0]);
-		obbWorldMatrixInverse.m[3][1] = -(obb.center.x * obbWorldMatrixInverse.m[0][1] + obb.center.y * obbWorldMatrixInverse.m[1][1] + obb.center.z * obbWorldMatrixInverse.m[2][1]);
-		obbWorldMatrixInverse.m[3][2] = -(obb.center.x * obbWorldMatrixInverse.m[0][2] + obb.center.y * obbWorldMatrixInverse.m[1][2] + obb.center.z * obbWorldMatrixInverse.m[2][2]);
-
 		// セグメントの始点と終点をOBBのローカル空間に変換
-		Vector3 localOrigin = Transform(segment.origin, obbWorldMatrixInverse);
-		Vector3 localEnd = Transform(segment.origin + segment.diff, obbWorldMatrixInverse);
+		Vector3 localOrigin = TransformToLocal(obb, segment.origin);
+		Vector3 localEnd = TransformToLocal(obb, segment.origin + segment.diff);
 
 		// 変換後のセグメント
 		Segment localSegment;
@@ -810,69 +347,553 @@ namespace Math
 		localSegment.diff = localEnd - localOrigin;
 
 		// OBBのローカル空間でAABBとの衝突判定を行う
-		AABB aabbOBBLocal{ -obb.size, obb.size };
+		AABB aabbOBBLocal{ -obb.halfExtents, obb.halfExtents };
 		return IsCollision(aabbOBBLocal, localSegment);
 	}
 
-	bool IsCollision(const OBB& obb1, const OBB& obb2)
+	// OBB同士の分離軸判定。obb1の座標系で見たobb2の回転(相対回転行列)を使うので軸を正規化しなくてよい
+	// 安い面の軸(6本)を先に調べ、分離軸が見つかった時点で抜ける
+	// penetrationがnullptrでなければ、めり込みが最小になる軸と深さを求める
+	static bool TestOBBSeparatingAxes(const CachedOBB& obb1, const CachedOBB& obb2, OBBPenetration* penetration)
+	{
+		// 辺同士の軸がほぼ平行なときに外積が0になって誤判定しないように足す値
+		const float kEpsilon = 1e-6f;
+		// 辺同士の軸は、面の軸よりこの割合以上浅いときだけ採用する(面の接触を優先する)
+		const float kEdgeAxisBias = 0.95f;
+
+		const float extent1[3] = { obb1.halfExtents.x, obb1.halfExtents.y, obb1.halfExtents.z };
+		const float extent2[3] = { obb2.halfExtents.x, obb2.halfExtents.y, obb2.halfExtents.z };
+
+		// obb2の軸をobb1の座標系で表した回転行列
+		float rotation[3][3];
+		float absRotation[3][3];
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				rotation[i][j] = Dot(obb1.axes[i], obb2.axes[j]);
+				absRotation[i][j] = std::abs(rotation[i][j]) + kEpsilon;
+			}
+		}
+
+		// obb1からobb2への中心の差をobb1の座標系で表す
+		Vector3 difference = obb2.center - obb1.center;
+		const float translation[3] = { Dot(difference, obb1.axes[0]), Dot(difference, obb1.axes[1]), Dot(difference, obb1.axes[2]) };
+
+		float bestDepth = FLT_MAX;
+		Vector3 bestAxis{};
+		int bestAxisIndex = 0;
+		// distanceは軸上の中心間距離(符号付き)、lengthは軸の長さ
+		auto updatePenetration = [&](float radius, float distance, const Vector3& axis, float length, float bias, int axisIndex)
+		{
+			float depth = (radius - std::abs(distance)) / length;
+			if (depth >= bestDepth * bias)
+			{
+				return;
+			}
+			bestDepth = depth;
+			bestAxis = Multiply((distance < 0.0f ? -1.0f : 1.0f) / length, axis);
+			bestAxisIndex = axisIndex;
+		};
+
+		// obb1の面の軸
+		for (int i = 0; i < 3; ++i)
+		{
+			float radius = extent1[i] + extent2[0] * absRotation[i][0] + extent2[1] * absRotation[i][1] + extent2[2] * absRotation[i][2];
+			if (std::abs(translation[i]) > radius)
+			{
+				return false;
+			}
+			if (penetration)
+			{
+				updatePenetration(radius, translation[i], obb1.axes[i], 1.0f, 1.0f, i);
+			}
+		}
+
+		// obb2の面の軸
+		for (int j = 0; j < 3; ++j)
+		{
+			float radius = extent1[0] * absRotation[0][j] + extent1[1] * absRotation[1][j] + extent1[2] * absRotation[2][j] + extent2[j];
+			float distance = translation[0] * rotation[0][j] + translation[1] * rotation[1][j] + translation[2] * rotation[2][j];
+			if (std::abs(distance) > radius)
+			{
+				return false;
+			}
+			if (penetration)
+			{
+				updatePenetration(radius, distance, obb2.axes[j], 1.0f, 1.0f, 3 + j);
+			}
+		}
+
+		// 辺同士の軸 (obb1の軸i x obb2の軸j)
+		for (int i = 0; i < 3; ++i)
+		{
+			int i1 = (i + 1) % 3;
+			int i2 = (i + 2) % 3;
+			for (int j = 0; j < 3; ++j)
+			{
+				int j1 = (j + 1) % 3;
+				int j2 = (j + 2) % 3;
+				float radius =
+					extent1[i1] * absRotation[i2][j] + extent1[i2] * absRotation[i1][j] +
+					extent2[j1] * absRotation[i][j2] + extent2[j2] * absRotation[i][j1];
+				float distance = translation[i2] * rotation[i1][j] - translation[i1] * rotation[i2][j];
+				if (std::abs(distance) > radius)
+				{
+					return false;
+				}
+				if (penetration)
+				{
+					// 正規直交なので外積の長さの2乗は 1 - cos^2
+					float lengthSquared = 1.0f - rotation[i][j] * rotation[i][j];
+					if (lengthSquared > kEpsilon)
+					{
+						updatePenetration(radius, distance, Cross(obb1.axes[i], obb2.axes[j]), std::sqrt(lengthSquared), kEdgeAxisBias, 6 + i * 3 + j);
+					}
+				}
+			}
+		}
+
+		if (penetration)
+		{
+			penetration->axis = bestAxis;
+			penetration->depth = bestDepth;
+			penetration->axisIndex = bestAxisIndex;
+		}
+		return true;
+	}
+
+	bool IsCollision(const CachedOBB& obb1, const CachedOBB& obb2)
+	{
+		return TestOBBSeparatingAxes(obb1, obb2, nullptr);
+	}
+
+	bool IsCollision(const CachedOBB& obb1, const CachedOBB& obb2, OBBPenetration& penetration)
 	{
-		const float epsilon = 1e-5f;
-
-		// OBBの軸
-		Vector3 axes[15] = {
-			obb1.orientations[0],
-			obb1.orientations[1],
-			obb1.orientations[2],
-			obb2.orientations[0],
-			obb2.orientations[1],
-			obb2.orientations[2],
-			Cross(obb1.orientations[0], obb2.orientations[0]),
-			Cross(obb1.orientations[0], obb2.orientations[1]),
-			Cross(obb1.orientations[0], obb2.orientations[2]),
-			Cross(obb1.orientations[1], obb2.orientations[0]),
-			Cross(obb1.orientations[1], obb2.orientations[1]),
-			Cross(obb1.orientations[1], obb2.orientations[2]),
-			Cross(obb1.orientations[2], obb2.orientations[0]),
-			Cross(obb1.orientations[2], obb2.orientations[1]),
-			Cross(obb1.orientations[2], obb2.orientations[2]),
+		return TestOBBSeparatingAxes(obb1, obb2, &penetration);
+	}
+
+	CachedOBB MakeCachedOBB(const OBB& obb)
+	{
+		CachedOBB result;
+		result.center = obb.center;
+		result.axes[0] = obb.orientations[0];
+		result.axes[1] = obb.orientations[1];
+		result.axes[2] = obb.orientations[2];
+		result.halfExtents = obb.size * 0.5f;
+
+		// 回転行列の各行が軸なので、逆行列はその転置(各列が軸)になる
+		// 平行移動は中心を各軸に射影したものを引く
+		result.worldToLocal = {
+			obb.orientations[0].x, obb.orientations[1].x, obb.orientations[2].x, 0.0f,
+			obb.orientations[0].y, obb.orientations[1].y, obb.orientations[2].y, 0.0f,
+			obb.orientations[0].z, obb.orientations[1].z, obb.orientations[2].z, 0.0f,
+			-Dot(obb.center, obb.orientations[0]), -Dot(obb.center, obb.orientations[1]), -Dot(obb.center, obb.orientations[2]), 1.0f
 		};
+		return result;
+	}
 
-		// 各軸に対して分離が存在するかをチェック
-		for (int i = 0; i < 15; ++i) {
-			if (Length(axes[i]) < epsilon) {
-				continue; // 無視できる軸
+	Vector3 TransformToLocal(const CachedOBB& obb, const Vector3& point)
+	{
+		// 同次座標のwは常に1なので割り算はしない
+		const Matrix4x4& m = obb.worldToLocal;
+		return {
+			point.x * m.m[0][0] + point.y * m.m[1][0] + point.z * m.m[2][0] + m.m[3][0],
+			point.x * m.m[0][1] + point.y * m.m[1][1] + point.z * m.m[2][1] + m.m[3][1],
+			point.x * m.m[0][2] + point.y * m.m[1][2] + point.z * m.m[2][2] + m.m[3][2]
+		};
+	}
+
+	static float GetComponent(const Vector3& v, int axis)
+	{
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+
+	static void SetComponent(Vector3& v, int axis, float value)
+	{
+		(axis == 0 ? v.x : (axis == 1 ? v.y : v.z)) = value;
+	}
+
+	// 原点を中心とする箱と球の接触情報(箱のローカル空間)
+	// IsCollision(const AABB&, const Sphere&)と同じく最近接点までの距離で判定し、その値から法線と深さを求める
+	static bool MakeBoxSphereContact(const Vector3& halfExtents, const Vector3& center, float radius, Vector3& normal, Vector3& point, float& depth)
+	{
+		//最近接点を求める
+		Vector3 closestPoint
+		{
+			std::clamp(center.x, -halfExtents.x, halfExtents.x),
+			std::clamp(center.y, -halfExtents.y, halfExtents.y),
+			std::clamp(center.z, -halfExtents.z, halfExtents.z)
+		};
+		Vector3 difference = center - closestPoint;
+		float distanceSquared = Dot(difference, difference);
+		if (distanceSquared > radius * radius)
+		{
+			return false;
+		}
+
+		if (distanceSquared > 0.0f)
+		{
+			float distance = std::sqrt(distanceSquared);
+			normal = Multiply(1.0f / distance, difference);
+			point = closestPoint;
+			depth = radius - distance;
+			return true;
+		}
+
+		// 中心が箱の中にあるときは一番近い面から押し出す
+		int axis = 0;
+		float faceDistance = FLT_MAX;
+		for (int i = 0; i < 3; ++i)
+		{
+			float distance = GetComponent(halfExtents, i) - std::abs(GetComponent(center, i));
+			if (distance < faceDistance)
+			{
+				faceDistance = distance;
+				axis = i;
 			}
+		}
+		float sign = GetComponent(center, axis) < 0.0f ? -1.0f : 1.0f;
+		normal = { 0.0f, 0.0f, 0.0f };
+		SetComponent(normal, axis, sign);
+		point = center;
+		SetComponent(point, axis, sign * GetComponent(halfExtents, axis));
+		depth = radius + faceDistance;
+		return true;
+	}
 
-			// 軸を正規化
-			Vector3 axis = Normalize(axes[i]);
+	bool IsCollision(const Sphere& s1, const Sphere& s2, ContactManifold& manifold)
+	{
+		Vector3 difference = s2.center - s1.center;
+		float distanceSquared = Dot(difference, difference);
+		float radiusSum = s1.radius + s2.radius;
+		if (distanceSquared > radiusSum * radiusSum)
+		{
+			return false;
+		}
 
-			// OBB1の投影範囲
-			float center1 = Dot(obb1.center, axis);
-			float extent1 =
-				std::abs(Dot(obb1.orientations[0] * obb1.size.x * 0.5f, axis)) +
-				std::abs(Dot(obb1.orientations[1] * obb1.size.y * 0.5f, axis)) +
-				std::abs(Dot(obb1.orientations[2] * obb1.size.z * 0.5f, axis));
+		// 中心が重なっているときは上向きに押し出す
+		float distance = std::sqrt(distanceSquared);
+		manifold.normal = distance > 0.0f ? Multiply(1.0f / distance, difference) : Vector3{ 0.0f, 1.0f, 0.0f };
+		manifold.depth = radiusSum - distance;
+		manifold.points[0] = s1.center + manifold.normal * (s1.radius - manifold.depth * 0.5f);
+		manifold.pointCount = 1;
+		return true;
+	}
 
-			float min1 = center1 - extent1;
-			float max1 = center1 + extent1;
+	bool IsCollision(const Sphere& sphere, const Plane& plane, ContactManifold& manifold)
+	{
+		// 平面の法線ベクトルと球の中心点との距離
+		float distance = Dot(plane.normal, sphere.center) - plane.distance;
+		if (fabs(distance) > sphere.radius)
+		{
+			return false;
+		}
+
+		// 球から平面へ向かう向きにする
+		manifold.normal = distance >= 0.0f ? -plane.normal : plane.normal;
+		manifold.depth = sphere.radius - std::abs(distance);
+		manifold.points[0] = sphere.center - plane.normal * distance;
+		manifold.pointCount = 1;
+		return true;
+	}
 
-			// OBB2の投影範囲
-			float center2 = Dot(obb2.center, axis);
-			float extent2 =
-				std::abs(Dot(obb2.orientations[0] * obb2.size.x * 0.5f, axis)) +
-				std::abs(Dot(obb2.orientations[1] * obb2.size.y * 0.5f, axis)) +
-				std::abs(Dot(obb2.orientations[2] * obb2.size.z * 0.5f, axis));
+	bool IsCollision(const AABB& aabb, const Sphere& sphere, ContactManifold& manifold)
+	{
+		Vector3 center = (aabb.min + aabb.max) * 0.5f;
+		Vector3 halfExtents = (aabb.max - aabb.min) * 0.5f;
+		Vector3 point;
+		if (!MakeBoxSphereContact(halfExtents, sphere.center - center, sphere.radius, manifold.normal, point, manifold.depth))
+		{
+			return false;
+		}
+		manifold.points[0] = center + point;
+		manifold.pointCount = 1;
+		return true;
+	}
 
-			float min2 = center2 - extent2;
-			float max2 = center2 + extent2;
+	bool IsCollision(const AABB& aabb1, const AABB& aabb2, ContactManifold& manifold)
+	{
+		// 重なっている範囲
+		AABB overlap
+		{
+			{ std::max(aabb1.min.x, aabb2.min.x), std::max(aabb1.min.y, aabb2.min.y), std::max(aabb1.min.z, aabb2.min.z) },
+			{ std::min(aabb1.max.x, aabb2.max.x), std::min(aabb1.max.y, aabb2.max.y), std::min(aabb1.max.z, aabb2.max.z) }
+		};
+		Vector3 size = overlap.max - overlap.min;
+		if (size.x < 0.0f || size.y < 0.0f || size.z < 0.0f)
+		{
+			return false;
+		}
 
-			// 投影範囲が重ならなければ分離している
-			if (max1 < min2 || max2 < min1) {
-				return false; // 分離軸が存在する
+		// 重なりが一番浅い軸で押し出す
+		int axis = (size.x <= size.y && size.x <= size.z) ? 0 : (size.y <= size.z ? 1 : 2);
+		float direction = GetComponent(aabb2.min + aabb2.max, axis) >= GetComponent(aabb1.min + aabb1.max, axis) ? 1.0f : -1.0f;
+		manifold.normal = { 0.0f, 0.0f, 0.0f };
+		SetComponent(manifold.normal, axis, direction);
+		manifold.depth = GetComponent(size, axis);
+
+		// 重なっている範囲の、押し出す軸に垂直な断面の4隅を接触点にする
+		int axis1 = (axis + 1) % 3;
+		int axis2 = (axis + 2) % 3;
+		float middle = (GetComponent(overlap.min, axis) + GetComponent(overlap.max, axis)) * 0.5f;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			Vector3& point = manifold.points[i];
+			SetComponent(point, axis, middle);
+			SetComponent(point, axis1, GetComponent((i & 1) ? overlap.max : overlap.min, axis1));
+			SetComponent(point, axis2, GetComponent((i & 2) ? overlap.max : overlap.min, axis2));
+		}
+		manifold.pointCount = 4;
+		return true;
+	}
+
+	bool IsCollision(const CachedOBB& obb, const Sphere& sphere, ContactManifold& manifold)
+	{
+		Vector3 localNormal, localPoint;
+		if (!MakeBoxSphereContact(obb.halfExtents, TransformToLocal(obb, sphere.center), sphere.radius, localNormal, localPoint, manifold.depth))
+		{
+			return false;
+		}
+
+		// ローカル空間からワールド空間へ戻す
+		manifold.normal = obb.axes[0] * localNormal.x + obb.axes[1] * localNormal.y + obb.axes[2] * localNormal.z;
+		manifold.points[0] = obb.center + obb.axes[0] * localPoint.x + obb.axes[1] * localPoint.y + obb.axes[2] * localPoint.z;
+		manifold.pointCount = 1;
+		return true;
+	}
+
+	// 面の軸で分離しているOBB同士の接触点を求める
+	// 基準面(referenceの面)の4つの側面で、相手(incident)の一番向かい合う面を切り取る
+	static uint32_t ClipOBBFace(const CachedOBB& reference, const CachedOBB& incident, int referenceAxis, const Vector3& referenceNormal, Vector3 points[ContactManifold::kMaxPointCount])
+	{
+		const int kMaxClipPointCount = 8;
+
+		Vector3 referenceFaceCenter = reference.center + referenceNormal * GetComponent(reference.halfExtents, referenceAxis);
+		int tangentAxis1 = (referenceAxis + 1) % 3;
+		int tangentAxis2 = (referenceAxis + 2) % 3;
+		const Vector3& tangent1 = reference.axes[tangentAxis1];
+		const Vector3& tangent2 = reference.axes[tangentAxis2];
+
+		// 基準面の法線と一番逆を向いている相手の面
+		int incidentAxis = 0;
+		float maxAlignment = -1.0f;
+		for (int i = 0; i < 3; ++i)
+		{
+			float alignment = std::abs(Dot(incident.axes[i], referenceNormal));
+			if (alignment > maxAlignment)
+			{
+				maxAlignment = alignment;
+				incidentAxis = i;
+			}
+		}
+		float sign = Dot(incident.axes[incidentAxis], referenceNormal) > 0.0f ? -1.0f : 1.0f;
+		Vector3 incidentFaceCenter = incident.center + incident.axes[incidentAxis] * (sign * GetComponent(incident.halfExtents, incidentAxis));
+		Vector3 edge1 = incident.axes[(incidentAxis + 1) % 3] * GetComponent(incident.halfExtents, (incidentAxis + 1) % 3);
+		Vector3 edge2 = incident.axes[(incidentAxis + 2) % 3] * GetComponent(incident.halfExtents, (incidentAxis + 2) % 3);
+
+		Vector3 polygon[kMaxClipPointCount] = { incidentFaceCenter + edge1 + edge2, incidentFaceCenter - edge1 + edge2, incidentFaceCenter - edge1 - edge2, incidentFaceCenter + edge1 - edge2 };
+		int polygonCount = 4;
+
+		// 基準面の4つの側面で切り取る(Sutherland-Hodgman)
+		const Vector3 planeNormals[4] = { tangent1, -tangent1, tangent2, -tangent2 };
+		const float planeOffsets[4] =
+		{
+			GetComponent(reference.halfExtents, tangentAxis1), GetComponent(reference.halfExtents, tangentAxis1),
+			GetComponent(reference.halfExtents, tangentAxis2), GetComponent(reference.halfExtents, tangentAxis2)
+		};
+		for (int plane = 0; plane < 4 && polygonCount > 0; ++plane)
+		{
+			Vector3 clipped[kMaxClipPointCount];
+			int clippedCount = 0;
+			for (int i = 0; i < polygonCount; ++i)
+			{
+				const Vector3& start = polygon[i];
+				const Vector3& end = polygon[(i + 1) % polygonCount];
+				float startDistance = Dot(start - reference.center, planeNormals[plane]) - planeOffsets[plane];
+				float endDistance = Dot(end - reference.center, planeNormals[plane]) - planeOffsets[plane];
+				if (startDistance <= 0.0f && clippedCount < kMaxClipPointCount)
+				{
+					clipped[clippedCount++] = start;
+				}
+				if ((startDistance < 0.0f) != (endDistance < 0.0f) && clippedCount < kMaxClipPointCount)
+				{
+					clipped[clippedCount++] = Lerp(start, end, startDistance / (startDistance - endDistance));
+				}
+			}
+			std::copy(clipped, clipped + clippedCount, polygon);
+			polygonCount = clippedCount;
+		}
+
+		// 基準面より奥にある点だけを残し、基準面との中間を接触点にする
+		Vector3 contacts[kMaxClipPointCount];
+		int contactCount = 0;
+		for (int i = 0; i < polygonCount; ++i)
+		{
+			float separation = Dot(polygon[i] - referenceFaceCenter, referenceNormal);
+			if (separation <= 0.0f)
+			{
+				contacts[contactCount++] = polygon[i] - referenceNormal * (separation * 0.5f);
+			}
+		}
+
+		if (contactCount <= static_cast<int>(ContactManifold::kMaxPointCount))
+		{
+			std::copy(contacts, contacts + contactCount, points);
+			return static_cast<uint32_t>(contactCount);
+		}
+
+		// 多すぎるときは基準面の2つの軸方向で端にある点を残す
+		int extremes[4] = { 0, 0, 0, 0 };
+		for (int i = 1; i < contactCount; ++i)
+		{
+			float p1 = Dot(contacts[i], tangent1);
+			float p2 = Dot(contacts[i], tangent2);
+			if (p1 < Dot(contacts[extremes[0]], tangent1)) { extremes[0] = i; }
+			if (p1 > Dot(contacts[extremes[1]], tangent1)) { extremes[1] = i; }
+			if (p2 < Dot(contacts[extremes[2]], tangent2)) { extremes[2] = i; }
+			if (p2 > Dot(contacts[extremes[3]], tangent2)) { extremes[3] = i; }
+		}
+		uint32_t pointCount = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (std::find(extremes, extremes + i, extremes[i]) == extremes + i)
+			{
+				points[pointCount++] = contacts[extremes[i]];
+			}
+		}
+		return pointCount;
+	}
+
+	bool IsCollision(const CachedOBB& obb1, const CachedOBB& obb2, ContactManifold& manifold)
+	{
+		OBBPenetration penetration;
+		if (!IsCollision(obb1, obb2, penetration))
+		{
+			return false;
+		}
+		manifold.normal = penetration.axis;
+		manifold.depth = penetration.depth;
+
+		if (penetration.axisIndex < 6)
+		{
+			// 面の軸: 法線を持つ側の面を基準にして相手の面を切り取る
+			bool isFirstReference = penetration.axisIndex < 3;
+			manifold.pointCount = isFirstReference ?
+				ClipOBBFace(obb1, obb2, penetration.axisIndex, manifold.normal, manifold.points) :
+				ClipOBBFace(obb2, obb1, penetration.axisIndex - 3, -manifold.normal, manifold.points);
+			if (manifold.pointCount > 0)
+			{
+				return true;
 			}
 		}
+		else
+		{
+			// 辺同士の軸: 法線方向に一番出ている辺どうしの最近接点の中点
+			int axis1 = (penetration.axisIndex - 6) / 3;
+			int axis2 = (penetration.axisIndex - 6) % 3;
+			Vector3 edgePoint1 = obb1.center;
+			Vector3 edgePoint2 = obb2.center;
+			for (int i = 0; i < 3; ++i)
+			{
+				if (i != axis1)
+				{
+					edgePoint1 = edgePoint1 + obb1.axes[i] * (Dot(obb1.axes[i], manifold.normal) > 0.0f ? GetComponent(obb1.halfExtents, i) : -GetComponent(obb1.halfExtents, i));
+				}
+				if (i != axis2)
+				{
+					edgePoint2 = edgePoint2 + obb2.axes[i] * (Dot(obb2.axes[i], manifold.normal) > 0.0f ? -GetComponent(obb2.halfExtents, i) : GetComponent(obb2.halfExtents, i));
+				}
+			}
 
-		// すべての軸で分離がなければ衝突している
+			const Vector3& direction1 = obb1.axes[axis1];
+			const Vector3& direction2 = obb2.axes[axis2];
+			Vector3 offset = edgePoint1 - edgePoint2;
+			float b = Dot(direction1, direction2);
+			float c = Dot(direction1, offset);
+			float f = Dot(direction2, offset);
+			float denominator = 1.0f - b * b;
+			float s = denominator > 1e-6f ? (b * f - c) / denominator : 0.0f;
+			s = std::clamp(s, -GetComponent(obb1.halfExtents, axis1), GetComponent(obb1.halfExtents, axis1));
+			float t = std::clamp(b * s + f, -GetComponent(obb2.halfExtents, axis2), GetComponent(obb2.halfExtents, axis2));
+
+			manifold.points[0] = ((edgePoint1 + direction1 * s) + (edgePoint2 + direction2 * t)) * 0.5f;
+			manifold.pointCount = 1;
+			return true;
+		}
+
+		// 数値誤差で接触点が残らなかったときは中心の中点を使う
+		manifold.points[0] = (obb1.center + obb2.center) * 0.5f;
+		manifold.pointCount = 1;
 		return true;
 	}
+
+	bool IsCollision(const OBB& obb, const Sphere& sphere, ContactManifold& manifold)
+	{
+		return IsCollision(MakeCachedOBB(obb), sphere, manifold);
+	}
+
+	bool IsCollision(const OBB& obb1, const OBB& obb2, ContactManifold& manifold)
+	{
+		return IsCollision(MakeCachedOBB(obb1), MakeCachedOBB(obb2), manifold);
+	}
+
+	AABB MakeAABB(const Sphere& sphere)
+	{
+		Vector3 extent = { sphere.radius, sphere.radius, sphere.radius };
+		return { sphere.center - extent, sphere.center + extent };
+	}
+
+	AABB MakeAABB(const OBB& obb)
+	{
+		// 各軸の半分の大きさをワールド軸へ射影した長さの合計が広がりになる
+		Vector3 halfSize = obb.size * 0.5f;
+		Vector3 extent
+		{
+			std::abs(obb.orientations[0].x) * halfSize.x + std::abs(obb.orientations[1].x) * halfSize.y + std::abs(obb.orientations[2].x) * halfSize.z,
+			std::abs(obb.orientations[0].y) * halfSize.x + std::abs(obb.orientations[1].y) * halfSize.y + std::abs(obb.orientations[2].y) * halfSize.z,
+			std::abs(obb.orientations[0].z) * halfSize.x + std::abs(obb.orientations[1].z) * halfSize.y + std::abs(obb.orientations[2].z) * halfSize.z
+		};
+		return { obb.center - extent, obb.center + extent };
+	}
+
+	AABB MakeAABB(const Triangle& triangle)
+	{
+		AABB result{ triangle.vertices[0], triangle.vertices[0] };
+		for (int i = 1; i < 3; ++i)
+		{
+			result.min = { std::min(result.min.x, triangle.vertices[i].x), std::min(result.min.y, triangle.vertices[i].y), std::min(result.min.z, triangle.vertices[i].z) };
+			result.max = { std::max(result.max.x, triangle.vertices[i].x), std::max(result.max.y, triangle.vertices[i].y), std::max(result.max.z, triangle.vertices[i].z) };
+		}
+		return result;
+	}
+
+	AABB MakeAABB(const Segment& segment)
+	{
+		Vector3 end = segment.origin + segment.diff;
+		return {
+			{ std::min(segment.origin.x, end.x), std::min(segment.origin.y, end.y), std::min(segment.origin.z, end.z) },
+			{ std::max(segment.origin.x, end.x), std::max(segment.origin.y, end.y), std::max(segment.origin.z, end.z) }
+		};
+	}
+
+	AABB Union(const AABB& aabb1, const AABB& aabb2)
+	{
+		return {
+			{ std::min(aabb1.min.x, aabb2.min.x), std::min(aabb1.min.y, aabb2.min.y), std::min(aabb1.min.z, aabb2.min.z) },
+			{ std::max(aabb1.max.x, aabb2.max.x), std::max(aabb1.max.y, aabb2.max.y), std::max(aabb1.max.z, aabb2.max.z) }
+		};
+	}
+
+	bool Contains(const AABB& outer, const AABB& inner)
+	{
+		return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+			inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+	}
+
+	float SurfaceArea(const AABB& aabb)
+	{
+		Vector3 d = aabb.max - aabb.min;
+		return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+	}
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #ifndef MATHFUNCTION_H
 #define MATHFUNCTION_H
 
+#if defined(_WIN32) && !defined(NOMINMAX)
 #define NOMINMAX
+#endif
 #include "AABB.h"
 #include "Ball.h"
 #include "Vector3.h"
@@ -12,10 +14,15 @@
 #include "Plane.h"
 #include "Triangle.h"
 #include "OBB.h"
+#include "CachedOBB.h"
+#include "ContactManifold.h"
+#include "MathInline.h"
 #include <algorithm>
 #include <assert.h>
 #include <cmath>
+#ifdef _WIN32
 #include <corecrt_math_defines.h>
+#endif
 
 namespace Math
 {
@@ -23,48 +30,27 @@ namespace Math
     Vector4 Multiply(const Vector4& v, const Matrix4x4& m);
 
     /*----------Vector3型の関数----------*/
-    Vector3 Add(const Vector3& v1, const Vector3& v2);
-    Vector3 Subtract(const Vector3& v1, const Vector3& v2);
-    Vector3 Multiply(float scalar, const Vector3& v);
-    float Dot(const Vector3& v1, const Vector3& v2);
-    float Length(const Vector3& v);
-    Vector3 Normalize(const Vector3& v);
-    Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix);
-    Vector3 Cross(const Vector3& v1, const Vector3& v2);
+    // Add, Subtract, Multiply(スカラー倍), Dot, LengthSquared, Length, Normalize, Cross, Lerp, Transform, TransformHomogeneousはMathInline.hで定義
     Vector3 Project(const Vector3& v1, const Vector3& v2);
     Vector3 ClosestPoint(const Vector3& point, const Segment& segment);
     Vector3 Perpendicular(const Vector3& vector);
-    Vector3 Lerp(const Vector3& v1, const Vector3& v2, float t);
     Vector3 ProjectToScreen(const Vector3& point, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix);
     Vector3 Reflect(const Vector3& input, const Vector3& normal);
 
     /*----------Matrix型の関数----------*/
-    Matrix4x4 Add(const Matrix4x4& m1, const Matrix4x4& m2);
-    Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2);
+    // Add, Subtract, MakeIdentity, MakeScaleMatrix, MakeTranslateMatrixはMathInline.hで定義
     Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
     Matrix4x4 Inverse(const Matrix4x4& matrix);
+    Matrix4x4 InverseAffine(const Matrix4x4& matrix);
     Matrix4x4 Transpose(const Matrix4x4& m);
-    Matrix4x4 MakeIdentity();
-    Matrix4x4 MakeScaleMatrix(const Vector3& scale);
     Matrix4x4 MakeRotateXMatrix(float radian);
     Matrix4x4 MakeRotateYMatrix(float radian);
     Matrix4x4 MakeRotateZMatrix(float radian);
-    Matrix4x4 MakeTranslateMatrix(const Vector3& translate);
     Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& radian, const Vector3& translate);
     Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
     Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip);
     Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth);
 
-    /*----------立体を描画する関数----------*/
-    void DrawGrid(const Matrix4x4& ViewProjectionMatrix, const Matrix4x4& ViewportMatrix);
-    void DrawSphere(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
-    void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
-    void DrawTriangle(const Triangle& triangle, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
-    void DrawAABB(const AABB& aabb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
-    void DrawBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix, uint32_t color);
-    void DrawControlPoint(const Vector3& controlPoint, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix);
-    void DrawOBB(const OBB& obb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
-
     /*----------衝突判定を取る関数----------*/
     bool IsCollision(const Sphere& s1, const Sphere& s2);
     bool IsCollision(const Sphere& sphere, const Plane& plane);
@@ -76,6 +62,34 @@ namespace Math
     bool IsCollision(const OBB& obb, const Sphere& sphere);
     bool IsCollision(const OBB& obb, const Segment& segment);
     bool IsCollision(const OBB& obb1, const OBB& obb2);
+    bool IsCollision(const CachedOBB& obb, const Sphere& sphere);
+    bool IsCollision(const CachedOBB& obb, const Segment& segment);
+    bool IsCollision(const CachedOBB& obb1, const CachedOBB& obb2);
+    bool IsCollision(const CachedOBB& obb1, const CachedOBB& obb2, OBBPenetration& penetration);
+
+    /*----------接触情報を求める衝突判定----------*/
+    // 当たっていればmanifoldに接触点・法線・深さを書き込んでtrueを返す
+    bool IsCollision(const Sphere& s1, const Sphere& s2, ContactManifold& manifold);
+    bool IsCollision(const Sphere& sphere, const Plane& plane, ContactManifold& manifold);
+    bool IsCollision(const AABB& aabb, const Sphere& sphere, ContactManifold& manifold);
+    bool IsCollision(const AABB& aabb1, const AABB& aabb2, ContactManifold& manifold);
+    bool IsCollision(const CachedOBB& obb, const Sphere& sphere, ContactManifold& manifold);
+    bool IsCollision(const CachedOBB& obb1, const CachedOBB& obb2, ContactManifold& manifold);
+    bool IsCollision(const OBB& obb, const Sphere& sphere, ContactManifold& manifold);
+    bool IsCollision(const OBB& obb1, const OBB& obb2, ContactManifold& manifold);
+
+    /*----------OBBの前計算----------*/
+    CachedOBB MakeCachedOBB(const OBB& obb);
+    Vector3 TransformToLocal(const CachedOBB& obb, const Vector3& point);
+
+    /*----------AABBを求める関数----------*/
+    AABB MakeAABB(const Sphere& sphere);
+    AABB MakeAABB(const OBB& obb);
+    AABB MakeAABB(const Triangle& triangle);
+    AABB MakeAABB(const Segment& segment);
+    AABB Union(const AABB& aabb1, const AABB& aabb2);
+    bool Contains(const AABB& outer, const AABB& inner);
+    float SurfaceArea(const AABB& aabb);
 }
 
 #endif // MATHFUNCTION_H
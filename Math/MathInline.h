@@ -0,0 +1,171 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+
+// 呼び出し回数の多い小さな関数はここにinlineで定義する
+// 呼び出し側でインライン化されるので、LTOなしでも定数の畳み込みやループのベクトル化が効く
+//
+// Vector3とMatrix4x4のコンストラクタはOperators.cppで定義されていて、インライン化できない
+// (KamataEngineのヘッダーで宣言されているため、ここでは変えられない)
+// そこで結果はMakeVector3/MakeMatrix4x4でコンストラクタを通さずに作る
+namespace Math
+{
+	namespace Detail
+	{
+		// Vector3/Matrix4x4と同じメモリ配置の型
+		struct Float3 final
+		{
+			float x, y, z;
+		};
+
+		struct Float4x4 final
+		{
+			float m[4][4];
+		};
+
+		static_assert(sizeof(Float3) == sizeof(Vector3) && std::is_trivially_copyable_v<Vector3>);
+		static_assert(sizeof(Float4x4) == sizeof(Matrix4x4) && std::is_trivially_copyable_v<Matrix4x4>);
+	}
+
+	/*----------コンストラクタを通さずに作る----------*/
+	inline Vector3 MakeVector3(float x, float y, float z)
+	{
+		return std::bit_cast<Vector3>(Detail::Float3{ x, y, z });
+	}
+
+	inline Matrix4x4 MakeMatrix4x4(const Detail::Float4x4& elements)
+	{
+		return std::bit_cast<Matrix4x4>(elements);
+	}
+
+	/*----------Vector3型の関数----------*/
+	inline Vector3 Add(const Vector3& v1, const Vector3& v2)
+	{
+		return MakeVector3(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z);
+	}
+
+	inline Vector3 Subtract(const Vector3& v1, const Vector3& v2)
+	{
+		return MakeVector3(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z);
+	}
+
+	inline Vector3 Multiply(float scalar, const Vector3& v)
+	{
+		return MakeVector3(scalar * v.x, scalar * v.y, scalar * v.z);
+	}
+
+	inline float Dot(const Vector3& v1, const Vector3& v2)
+	{
+		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+	}
+
+	// 長さの2乗。距離を比べるだけならsqrtを省けるのでこちらを使う
+	inline float LengthSquared(const Vector3& v)
+	{
+		return Dot(v, v);
+	}
+
+	inline float Length(const Vector3& v)
+	{
+		return std::sqrt(LengthSquared(v));
+	}
+
+	// 長さが0のときは0ベクトルを返す
+	inline Vector3 Normalize(const Vector3& v)
+	{
+		float length = Length(v);
+		if (length == 0.0f) {
+			return MakeVector3(0.0f, 0.0f, 0.0f);
+		}
+		return MakeVector3(v.x / length, v.y / length, v.z / length);
+	}
+
+	inline Vector3 Cross(const Vector3& v1, const Vector3& v2)
+	{
+		return MakeVector3(v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x);
+	}
+
+	// tが1のときv1、0のときv2になる
+	inline Vector3 Lerp(const Vector3& v1, const Vector3& v2, float t)
+	{
+		float s = 1.0f - t;
+		return MakeVector3(t * v1.x + s * v2.x, t * v1.y + s * v2.y, t * v1.z + s * v2.z);
+	}
+
+	// 同次座標で変換してwで割る
+	inline Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix)
+	{
+		float x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0];
+		float y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1];
+		float z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2];
+		float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + matrix.m[3][3];
+		assert(w != 0.0f);
+		return MakeVector3(x / w, y / w, z / w);
+	}
+
+	// 同次座標で変換し、wで割る前の(x, y, z, w)をresultに入れる
+	inline void TransformHomogeneous(const Vector3& vector, const Matrix4x4& matrix, float result[4])
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			result[c] = vector.x * matrix.m[0][c] + vector.y * matrix.m[1][c] + vector.z * matrix.m[2][c] + matrix.m[3][c];
+		}
+	}
+
+	/*----------Matrix型の関数----------*/
+	inline Matrix4x4 Add(const Matrix4x4& m1, const Matrix4x4& m2)
+	{
+		Detail::Float4x4 result;
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				result.m[i][j] = m1.m[i][j] + m2.m[i][j];
+			}
+		}
+		return MakeMatrix4x4(result);
+	}
+
+	inline Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2)
+	{
+		Detail::Float4x4 result;
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				result.m[i][j] = m1.m[i][j] - m2.m[i][j];
+			}
+		}
+		return MakeMatrix4x4(result);
+	}
+
+	inline Matrix4x4 MakeIdentity()
+	{
+		return MakeMatrix4x4({ {
+			{ 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f },
+		} });
+	}
+
+	inline Matrix4x4 MakeScaleMatrix(const Vector3& scale)
+	{
+		return MakeMatrix4x4({ {
+			{ scale.x, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, scale.y, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, scale.z, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f },
+		} });
+	}
+
+	inline Matrix4x4 MakeTranslateMatrix(const Vector3& translate)
+	{
+		return MakeMatrix4x4({ {
+			{ 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f },
+			{ translate.x, translate.y, translate.z, 1.0f },
+		} });
+	}
+}
@@ -0,0 +1,286 @@
+#include "MatrixSimd.h"
+#include "Simd.h"
+#include <cassert>
+
+namespace Math::MatrixSimd
+{
+	namespace Reference
+	{
+		Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
+		{
+			Matrix4x4 result{};
+			for (int i = 0; i < 4; i++)
+			{
+				for (int j = 0; j < 4; j++)
+				{
+					for (int k = 0; k < 4; k++)
+					{
+						result.m[i][j] += m1.m[i][k] * m2.m[k][j];
+					}
+				}
+			}
+			return result;
+		}
+
+		Matrix4x4 Transpose(const Matrix4x4& m)
+		{
+			Matrix4x4 result{};
+			for (int i = 0; i < 4; i++)
+			{
+				for (int j = 0; j < 4; j++)
+				{
+					result.m[i][j] = m.m[j][i];
+				}
+			}
+			return result;
+		}
+
+		Matrix4x4 Inverse(const Matrix4x4& matrix)
+		{
+			Matrix4x4 result{};
+
+			float det = matrix.m[0][0] * (matrix.m[1][1] * matrix.m[2][2] * matrix.m[3][3] + matrix.m[1][2] * matrix.m[2][3] * matrix.m[3][1] + matrix.m[1][3] * matrix.m[2][1] * matrix.m[3][2] -
+				matrix.m[1][3] * matrix.m[2][2] * matrix.m[3][1] - matrix.m[1][2] * matrix.m[2][1] * matrix.m[3][3] - matrix.m[1][1] * matrix.m[2][3] * matrix.m[3][2]) -
+				matrix.m[0][1] * (matrix.m[1][0] * matrix.m[2][2] * matrix.m[3][3] + matrix.m[1][2] * matrix.m[2][3] * matrix.m[3][0] + matrix.m[1][3] * matrix.m[2][0] * matrix.m[3][2] -
+					matrix.m[1][3] * matrix.m[2][2] * matrix.m[3][0] - matrix.m[1][2] * matrix.m[2][0] * matrix.m[3][3] - matrix.m[1][0] * matrix.m[2][3] * matrix.m[3][2]) +
+				matrix.m[0][2] * (matrix.m[1][0] * matrix.m[2][1] * matrix.m[3][3] + matrix.m[1][1] * matrix.m[2][3] * matrix.m[3][0] + matrix.m[1][3] * matrix.m[2][0] * matrix.m[3][1] -
+					matrix.m[1][3] * matrix.m[2][1] * matrix.m[3][0] - matrix.m[1][1] * matrix.m[2][0] * matrix.m[3][3] - matrix.m[1][0] * matrix.m[2][3] * matrix.m[3][1]) -
+				matrix.m[0][3] * (matrix.m[1][0] * matrix.m[2][1] * matrix.m[3][2] + matrix.m[1][1] * matrix.m[2][2] * matrix.m[3][0] + matrix.m[1][2] * matrix.m[2][0] * matrix.m[3][1] -
+					matrix.m[1][2] * matrix.m[2][1] * matrix.m[3][0] - matrix.m[1][1] * matrix.m[2][0] * matrix.m[3][2] - matrix.m[1][0] * matrix.m[2][2] * matrix.m[3][1]);
+
+			result.m[0][0] = (matrix.m[1][1] * matrix.m[2][2] * matrix.m[3][3] + matrix.m[1][2] * matrix.m[2][3] * matrix.m[3][1] + matrix.m[1][3] * matrix.m[2][1] * matrix.m[3][2] -
+				matrix.m[1][3] * matrix.m[2][2] * matrix.m[3][1] - matrix.m[1][2] * matrix.m[2][1] * matrix.m[3][3] - matrix.m[1][1] * matrix.m[2][3] * matrix.m[3][2]) /
+				det;
+			result.m[0][1] = (-matrix.m[0][1] * matrix.m[2][2] * matrix.m[3][3] - matrix.m[0][2] * matrix.m[2][3] * matrix.m[3][1] - matrix.m[0][3] * matrix.m[2][1] * matrix.m[3][2] +
+				matrix.m[0][3] * matrix.m[2][2] * matrix.m[3][1] + matrix.m[0][2] * matrix.m[2][1] * matrix.m[3][3] + matrix.m[0][1] * matrix.m[2][3] * matrix.m[3][2]) /
+				det;
+			result.m[0][2] = (matrix.m[0][1] * matrix.m[1][2] * matrix.m[3][3] + matrix.m[0][2] * matrix.m[1][3] * matrix.m[3][1] + matrix.m[0][3] * matrix.m[1][1] * matrix.m[3][2] -
+				matrix.m[0][3] * matrix.m[1][2] * matrix.m[3][1] - matrix.m[0][2] * matrix.m[1][1] * matrix.m[3][3] - matrix.m[0][1] * matrix.m[1][3] * matrix.m[3][2]) /
+				det;
+			result.m[0][3] = (-matrix.m[0][1] * matrix.m[1][2] * matrix.m[2][3] - matrix.m[0][2] * matrix.m[1][3] * matrix.m[2][1] - matrix.m[0][3] * matrix.m[1][1] * matrix.m[2][2] +
+				matrix.m[0][3] * matrix.m[1][2] * matrix.m[2][1] + matrix.m[0][2] * matrix.m[1][1] * matrix.m[2][3] + matrix.m[0][1] * matrix.m[1][3] * matrix.m[2][2]) /
+				det;
+
+			result.m[1][0] = (-matrix.m[1][0] * matrix.m[2][2] * matrix.m[3][3] - matrix.m[1][2] * matrix.m[2][3] * matrix.m[3][0] - matrix.m[1][3] * matrix.m[2][0] * matrix.m[3][2] +
+				matrix.m[1][3] * matrix.m[2][2] * matrix.m[3][0] + matrix.m[1][2] * matrix.m[2][0] * matrix.m[3][3] + matrix.m[1][0] * matrix.m[2][3] * matrix.m[3][2]) /
+				det;
+			result.m[1][1] = (matrix.m[0][0] * matrix.m[2][2] * matrix.m[3][3] + matrix.m[0][2] * matrix.m[2][3] * matrix.m[3][0] + matrix.m[0][3] * matrix.m[2][0] * matrix.m[3][2] -
+				matrix.m[0][3] * matrix.m[2][2] * matrix.m[3][0] - matrix.m[0][2] * matrix.m[2][0] * matrix.m[3][3] - matrix.m[0][0] * matrix.m[2][3] * matrix.m[3][2]) /
+				det;
+			result.m[1][2] = (-matrix.m[0][0] * matrix.m[1][2] * matrix.m[3][3] - matrix.m[0][2] * matrix.m[1][3] * matrix.m[3][0] - matrix.m[0][3] * matrix.m[1][0] * matrix.m[3][2] +
+				matrix.m[0][3] * matrix.m[1][2] * matrix.m[3][0] + matrix.m[0][2] * matrix.m[1][0] * matrix.m[3][3] + matrix.m[0][0] * matrix.m[1][3] * matrix.m[3][2]) /
+				det;
+			result.m[1][3] = (matrix.m[0][0] * matrix.m[1][2] * matrix.m[2][3] + matrix.m[0][2] * matrix.m[1][3] * matrix.m[2][0] + matrix.m[0][3] * matrix.m[1][0] * matrix.m[2][2] -
+				matrix.m[0][3] * matrix.m[1][2] * matrix.m[2][0] - matrix.m[0][2] * matrix.m[1][0] * matrix.m[2][3] - matrix.m[0][0] * matrix.m[1][3] * matrix.m[2][2]) /
+				det;
+
+			result.m[2][0] = (matrix.m[1][0] * matrix.m[2][1] * matrix.m[3][3] + matrix.m[1][1] * matrix.m[2][3] * matrix.m[3][0] + matrix.m[1][3] * matrix.m[2][0] * matrix.m[3][1] -
+				matrix.m[1][3] * matrix.m[2][1] * matrix.m[3][0] - matrix.m[1][1] * matrix.m[2][0] * matrix.m[3][3] - matrix.m[1][0] * matrix.m[2][3] * matrix.m[3][1]) /
+				det;
+			result.m[2][1] = (-matrix.m[0][0] * matrix.m[2][1] * matrix.m[3][3] - matrix.m[0][1] * matrix.m[2][3] * matrix.m[3][0] - matrix.m[0][3] * matrix.m[2][0] * matrix.m[3][1] +
+				matrix.m[0][3] * matrix.m[2][1] * matrix.m[3][0] + matrix.m[0][1] * matrix.m[2][0] * matrix.m[3][3] + matrix.m[0][0] * matrix.m[2][3] * matrix.m[3][1]) /
+				det;
+			result.m[2][2] = (matrix.m[0][0] * matrix.m[1][1] * matrix.m[3][3] + matrix.m[0][1] * matrix.m[1][3] * matrix.m[3][0] + matrix.m[0][3] * matrix.m[1][0] * matrix.m[3][1] -
+				matrix.m[0][3] * matrix.m[1][1] * matrix.m[3][0] - matrix.m[0][1] * matrix.m[1][0] * matrix.m[3][3] - matrix.m[0][0] * matrix.m[1][3] * matrix.m[3][1]) /
+				det;
+			result.m[2][3] = (-matrix.m[0][0] * matrix.m[1][1] * matrix.m[2][3] - matrix.m[0][1] * matrix.m[1][3] * matrix.m[2][0] - matrix.m[0][3] * matrix.m[1][0] * matrix.m[2][1] +
+				matrix.m[0][3] * matrix.m[1][1] * matrix.m[2][0] + matrix.m[0][1] * matrix.m[1][0] * matrix.m[2][3] + matrix.m[0][0] * matrix.m[1][3] * matrix.m[2][1]) /
+				det;
+
+			result.m[3][0] = (-matrix.m[1][0] * matrix.m[2][1] * matrix.m[3][2] - matrix.m[1][1] * matrix.m[2][2] * matrix.m[3][0] - matrix.m[1][2] * matrix.m[2][0] * matrix.m[3][1] +
+				matrix.m[1][2] * matrix.m[2][1] * matrix.m[3][0] + matrix.m[1][1] * matrix.m[2][0] * matrix.m[3][2] + matrix.m[1][0] * matrix.m[2][2] * matrix.m[3][1]) /
+				det;
+			result.m[3][1] = (matrix.m[0][0] * matrix.m[2][1] * matrix.m[3][2] + matrix.m[0][1] * matrix.m[2][2] * matrix.m[3][0] + matrix.m[0][2] * matrix.m[2][0] * matrix.m[3][1] -
+				matrix.m[0][2] * matrix.m[2][1] * matrix.m[3][0] - matrix.m[0][1] * matrix.m[2][0] * matrix.m[3][2] - matrix.m[0][0] * matrix.m[2][2] * matrix.m[3][1]) /
+				det;
+			result.m[3][2] = (-matrix.m[0][0] * matrix.m[1][1] * matrix.m[3][2] - matrix.m[0][1] * matrix.m[1][2] * matrix.m[3][0] - matrix.m[0][2] * matrix.m[1][0] * matrix.m[3][1] +
+				matrix.m[0][2] * matrix.m[1][1] * matrix.m[3][0] + matrix.m[0][1] * matrix.m[1][0] * matrix.m[3][2] + matrix.m[0][0] * matrix.m[1][2] * matrix.m[3][1]) /
+				det;
+			result.m[3][3] = (matrix.m[0][0] * matrix.m[1][1] * matrix.m[2][2] + matrix.m[0][1] * matrix.m[1][2] * matrix.m[2][0] + matrix.m[0][2] * matrix.m[1][0] * matrix.m[2][1] -
+				matrix.m[0][2] * matrix.m[1][1] * matrix.m[2][0] - matrix.m[0][1] * matrix.m[1][0] * matrix.m[2][2] - matrix.m[0][0] * matrix.m[1][2] * matrix.m[2][1]) /
+				det;
+
+			return result;
+		}
+	}
+
+#if defined(MATH_SIMD_SSE2)
+	namespace
+	{
+		// _mm_shuffle_psのマスク。(x, y, z, w)の順に取り出す
+		constexpr int ShuffleMask(int x, int y, int z, int w) { return x | (y << 2) | (z << 4) | (w << 6); }
+
+		template <int x, int y, int z, int w>
+		__m128 Swizzle(__m128 v) { return _mm_shuffle_ps(v, v, ShuffleMask(x, y, z, w)); }
+
+		template <int x, int y, int z, int w>
+		__m128 Shuffle(__m128 v1, __m128 v2) { return _mm_shuffle_ps(v1, v2, ShuffleMask(x, y, z, w)); }
+
+		// 2x2行列を(m00, m01, m10, m11)の4要素で表したときの演算
+		// A * B
+		__m128 Mat2Mul(__m128 a, __m128 b)
+		{
+			return _mm_add_ps(_mm_mul_ps(a, Swizzle<0, 3, 0, 3>(b)), _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+		}
+
+		// adj(A) * B
+		__m128 Mat2AdjMul(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(Swizzle<3, 3, 0, 0>(a), b), _mm_mul_ps(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b)));
+		}
+
+		// A * adj(B)
+		__m128 Mat2MulAdj(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(a, Swizzle<3, 0, 3, 0>(b)), _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+		}
+	}
+#endif
+
+	Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
+	{
+		Matrix4x4 result;
+#if defined(MATH_SIMD_AVX2)
+		// 2行ずつまとめて計算する。下位128ビットが偶数行、上位が奇数行
+		const __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[0]));
+		const __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[1]));
+		const __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[2]));
+		const __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[3]));
+		for (int i = 0; i < 4; i += 2)
+		{
+			__m256 a = _mm256_loadu_ps(m1.m[i]);
+			__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), row0);
+			r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), row1));
+			r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xAA), row2));
+			r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xFF), row3));
+			_mm256_storeu_ps(result.m[i], r);
+		}
+#elif defined(MATH_SIMD_SSE2)
+		// 結果のi行目 = m1[i][0] * m2の0行目 + ... + m1[i][3] * m2の3行目
+		const __m128 row0 = _mm_loadu_ps(m2.m[0]);
+		const __m128 row1 = _mm_loadu_ps(m2.m[1]);
+		const __m128 row2 = _mm_loadu_ps(m2.m[2]);
+		const __m128 row3 = _mm_loadu_ps(m2.m[3]);
+		for (int i = 0; i < 4; ++i)
+		{
+			__m128 r = _mm_mul_ps(_mm_set1_ps(m1.m[i][0]), row0);
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[i][1]), row1));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[i][2]), row2));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[i][3]), row3));
+			_mm_storeu_ps(result.m[i], r);
+		}
+#else
+		result = Reference::Multiply(m1, m2);
+#endif
+		return result;
+	}
+
+	Matrix4x4 Transpose(const Matrix4x4& m)
+	{
+#if defined(MATH_SIMD_SSE2)
+		__m128 row0 = _mm_loadu_ps(m.m[0]);
+		__m128 row1 = _mm_loadu_ps(m.m[1]);
+		__m128 row2 = _mm_loadu_ps(m.m[2]);
+		__m128 row3 = _mm_loadu_ps(m.m[3]);
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+		Matrix4x4 result;
+		_mm_storeu_ps(result.m[0], row0);
+		_mm_storeu_ps(result.m[1], row1);
+		_mm_storeu_ps(result.m[2], row2);
+		_mm_storeu_ps(result.m[3], row3);
+		return result;
+#else
+		return Reference::Transpose(m);
+#endif
+	}
+
+	Matrix4x4 Inverse(const Matrix4x4& m)
+	{
+#if defined(MATH_SIMD_SSE2)
+		// 2x2のブロックA, B, C, Dに分けて逆行列を求める
+		// | A B |
+		// | C D |
+		const __m128 row0 = _mm_loadu_ps(m.m[0]);
+		const __m128 row1 = _mm_loadu_ps(m.m[1]);
+		const __m128 row2 = _mm_loadu_ps(m.m[2]);
+		const __m128 row3 = _mm_loadu_ps(m.m[3]);
+
+		const __m128 A = _mm_movelh_ps(row0, row1);
+		const __m128 B = _mm_movehl_ps(row1, row0);
+		const __m128 C = _mm_movelh_ps(row2, row3);
+		const __m128 D = _mm_movehl_ps(row3, row2);
+
+		// 各ブロックの行列式 (|A|, |B|, |C|, |D|)
+		const __m128 detSub = _mm_sub_ps(
+			_mm_mul_ps(Shuffle<0, 2, 0, 2>(row0, row2), Shuffle<1, 3, 1, 3>(row1, row3)),
+			_mm_mul_ps(Shuffle<1, 3, 1, 3>(row0, row2), Shuffle<0, 2, 0, 2>(row1, row3)));
+		const __m128 detA = Swizzle<0, 0, 0, 0>(detSub);
+		const __m128 detB = Swizzle<1, 1, 1, 1>(detSub);
+		const __m128 detC = Swizzle<2, 2, 2, 2>(detSub);
+		const __m128 detD = Swizzle<3, 3, 3, 3>(detSub);
+
+		const __m128 DC = Mat2AdjMul(D, C);
+		const __m128 AB = Mat2AdjMul(A, B);
+
+		__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, DC));
+		__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, AB));
+		__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, AB));
+		__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, DC));
+
+		// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+		__m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+		__m128 trace = _mm_mul_ps(AB, Swizzle<0, 2, 1, 3>(DC));
+		trace = _mm_add_ps(trace, Swizzle<2, 3, 0, 1>(trace));
+		trace = _mm_add_ps(trace, Swizzle<1, 0, 3, 2>(trace));
+		detM = _mm_sub_ps(detM, trace);
+
+		const __m128 inverseDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+		X = _mm_mul_ps(X, inverseDet);
+		Y = _mm_mul_ps(Y, inverseDet);
+		Z = _mm_mul_ps(Z, inverseDet);
+		W = _mm_mul_ps(W, inverseDet);
+
+		Matrix4x4 result;
+		_mm_storeu_ps(result.m[0], Shuffle<3, 1, 3, 1>(X, Y));
+		_mm_storeu_ps(result.m[1], Shuffle<2, 0, 2, 0>(X, Y));
+		_mm_storeu_ps(result.m[2], Shuffle<3, 1, 3, 1>(Z, W));
+		_mm_storeu_ps(result.m[3], Shuffle<2, 0, 2, 0>(Z, W));
+		return result;
+#else
+		return Reference::Inverse(m);
+#endif
+	}
+
+	Matrix4x4 InverseAffine(const Matrix4x4& m)
+	{
+		assert(m.m[0][3] == 0.0f && m.m[1][3] == 0.0f && m.m[2][3] == 0.0f && m.m[3][3] == 1.0f);
+
+		// 左上3x3の逆行列は各行の外積を行列式で割ったものを列に並べたものになる
+		const float* r0 = m.m[0];
+		const float* r1 = m.m[1];
+		const float* r2 = m.m[2];
+		const float c0[3] = { r1[1] * r2[2] - r1[2] * r2[1], r1[2] * r2[0] - r1[0] * r2[2], r1[0] * r2[1] - r1[1] * r2[0] };
+		const float c1[3] = { r2[1] * r0[2] - r2[2] * r0[1], r2[2] * r0[0] - r2[0] * r0[2], r2[0] * r0[1] - r2[1] * r0[0] };
+		const float c2[3] = { r0[1] * r1[2] - r0[2] * r1[1], r0[2] * r1[0] - r0[0] * r1[2], r0[0] * r1[1] - r0[1] * r1[0] };
+		const float inverseDet = 1.0f / (r0[0] * c0[0] + r0[1] * c0[1] + r0[2] * c0[2]);
+
+		Matrix4x4 result;
+		for (int k = 0; k < 3; ++k)
+		{
+			result.m[k][0] = c0[k] * inverseDet;
+			result.m[k][1] = c1[k] * inverseDet;
+			result.m[k][2] = c2[k] * inverseDet;
+			result.m[k][3] = 0.0f;
+		}
+
+		// 平行移動は -t * R^-1
+		const float* t = m.m[3];
+		for (int j = 0; j < 3; ++j)
+		{
+			result.m[3][j] = -(t[0] * result.m[0][j] + t[1] * result.m[1][j] + t[2] * result.m[2][j]);
+		}
+		result.m[3][3] = 1.0f;
+		return result;
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Matrix4x4.h"
+
+// Matrix4x4の乗算・転置・逆行列の実装
+// Simd.hのマクロによってAVX2/SSE2/スカラーのどれを使うかをコンパイル時に決める
+namespace Math::MatrixSimd
+{
+	Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+	Matrix4x4 Transpose(const Matrix4x4& m);
+	Matrix4x4 Inverse(const Matrix4x4& m);
+
+	// 4列目が(0, 0, 0, 1)のアフィン行列専用の逆行列
+	Matrix4x4 InverseAffine(const Matrix4x4& m);
+
+	// 実行時の比較用に常に使えるスカラー実装
+	namespace Reference
+	{
+		Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+		Matrix4x4 Transpose(const Matrix4x4& m);
+		Matrix4x4 Inverse(const Matrix4x4& m);
+	}
+}
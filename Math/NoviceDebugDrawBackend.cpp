@@ -0,0 +1,16 @@
+#include "NoviceDebugDrawBackend.h"
+#include "Novice.h"
+
+namespace Math
+{
+	void NoviceDebugDrawBackend::DrawLines(std::span<const DebugLineVertex> vertices)
+	{
+		// Noviceには線をまとめて渡すAPIがないので、ここで1本ずつ渡す
+		for (size_t i = 0; i + 1 < vertices.size(); i += 2)
+		{
+			const DebugLineVertex& start = vertices[i];
+			const DebugLineVertex& end = vertices[i + 1];
+			Novice::DrawLine((int)start.x, (int)start.y, (int)end.x, (int)end.y, start.color);
+		}
+	}
+}
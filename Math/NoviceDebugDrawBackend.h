@@ -0,0 +1,14 @@
+#pragma once
+#include "DebugDraw.h"
+
+namespace Math
+{
+	/// <summary>
+	/// 溜めた線をNovice::DrawLineで描画するバックエンド
+	/// </summary>
+	class NoviceDebugDrawBackend final : public DebugDrawBackend
+	{
+	public:
+		void DrawLines(std::span<const DebugLineVertex> vertices) override;
+	};
+}
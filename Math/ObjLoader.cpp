@@ -0,0 +1,296 @@
+#include "ObjLoader.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace Math
+{
+	namespace
+	{
+		// 1つのスレッドがまとめて解析する文字数。境界は次の改行まで延ばす
+		const size_t kChunkSize = 1 << 22;
+		// MakeTrianglesでParallelForに渡す三角形の数
+		const size_t kTriangleGrainSize = 1 << 16;
+
+		/// <summary>
+		/// 行の切れ目で分けたOBJの一部と、その解析結果
+		/// </summary>
+		struct ObjChunk final
+		{
+			std::string_view text;
+			std::vector<Vector3> positions;
+			std::vector<uint32_t> indices;
+			// 負の番号(直前の頂点からの相対)で書かれた面の頂点
+			// チャンクの先頭からの番号(前のチャンクの頂点を指すと負になる)を符号付きのまま持っておき、
+			// 前のチャンクの頂点数があとで分かってから足してindices[slot]に入れる
+			struct RelativeIndex final
+			{
+				size_t slot;
+				int64_t index;
+			};
+			std::vector<RelativeIndex> relativeIndices;
+			bool isValid = true;
+		};
+
+		bool IsSpace(char c)
+		{
+			return c == ' ' || c == '\t';
+		}
+
+		bool IsLineEnd(char c)
+		{
+			return c == '\n' || c == '\r' || c == '#';
+		}
+
+		const char* SkipSpaces(const char* p, const char* end)
+		{
+			while (p != end && IsSpace(*p))
+			{
+				++p;
+			}
+			return p;
+		}
+
+		// 次の行の先頭を返す
+		const char* SkipLine(const char* p, const char* end)
+		{
+			const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+			return newline ? newline + 1 : end;
+		}
+
+		// from_charsはロケールを見ず、文字列を作らずにその場で変換する
+		template <class T>
+		bool ParseNumber(const char*& p, const char* end, T& value)
+		{
+			p = SkipSpaces(p, end);
+			if (p != end && *p == '+')
+			{
+				++p;
+			}
+			auto [next, error] = std::from_chars(p, end, value);
+			if (error != std::errc())
+			{
+				return false;
+			}
+			p = next;
+			return true;
+		}
+
+		// "v x y z [w]" の"v"より後ろ。wは使わない
+		bool ParsePosition(const char* p, const char* end, ObjChunk& chunk)
+		{
+			float x, y, z;
+			if (!ParseNumber(p, end, x) || !ParseNumber(p, end, y) || !ParseNumber(p, end, z))
+			{
+				return false;
+			}
+			chunk.positions.push_back({ x, y, z });
+			return true;
+		}
+
+		// "f v1 v2 v3 ..." の"f"より後ろ。各頂点は"v", "v/vt", "v//vn", "v/vt/vn"のどれでもよく、vだけを使う
+		bool ParseFace(const char* p, const char* end, ObjChunk& chunk)
+		{
+			int64_t first = 0;
+			int64_t previous = 0;
+			int vertexCount = 0;
+			bool isFirstRelative = false;
+			bool isPreviousRelative = false;
+			for (;;)
+			{
+				p = SkipSpaces(p, end);
+				if (p == end || IsLineEnd(*p))
+				{
+					break;
+				}
+
+				// 頂点の番号は32ビットに収めるので、それを超える番号は範囲外として扱う
+				// (そのまま32ビットにすると一周して、範囲内の番号に見えてしまう)
+				int64_t number;
+				if (!ParseNumber(p, end, number) || number == 0 || number > static_cast<int64_t>(UINT32_MAX) || number < -static_cast<int64_t>(UINT32_MAX))
+				{
+					return false;
+				}
+				while (p != end && !IsSpace(*p) && !IsLineEnd(*p))
+				{
+					++p;
+				}
+
+				// 正の番号は1から始まるファイル全体での番号。負の番号はこの行より前の頂点から数える
+				// 相対の番号はチャンクの先頭からの番号にしておく。この行より前の頂点しか指さないので、
+				// 前のチャンクの頂点数を足したあとで負でなければ範囲内になる
+				bool isRelative = number < 0;
+				int64_t index = isRelative ? static_cast<int64_t>(chunk.positions.size()) + number : number - 1;
+				if (vertexCount >= 2)
+				{
+					// 扇形に分ける: (最初, 1つ前, 今)
+					const int64_t triangle[3] = { first, previous, index };
+					const bool isTriangleRelative[3] = { isFirstRelative, isPreviousRelative, isRelative };
+					for (int i = 0; i < 3; ++i)
+					{
+						if (isTriangleRelative[i])
+						{
+							chunk.relativeIndices.push_back({ chunk.indices.size(), triangle[i] });
+							chunk.indices.push_back(0);
+						}
+						else
+						{
+							chunk.indices.push_back(static_cast<uint32_t>(triangle[i]));
+						}
+					}
+				}
+				if (vertexCount == 0)
+				{
+					first = index;
+					isFirstRelative = isRelative;
+				}
+				previous = index;
+				isPreviousRelative = isRelative;
+				++vertexCount;
+			}
+			return vertexCount >= 3;
+		}
+
+		void ParseChunk(ObjChunk& chunk)
+		{
+			const char* p = chunk.text.data();
+			const char* end = p + chunk.text.size();
+			while (p != end)
+			{
+				p = SkipSpaces(p, end);
+				if (p + 1 < end && IsSpace(p[1]))
+				{
+					// vt, vnなどは2文字目が空白ではないので、ここには来ない
+					if (*p == 'v' && !ParsePosition(p + 1, end, chunk))
+					{
+						chunk.isValid = false;
+						return;
+					}
+					if (*p == 'f' && !ParseFace(p + 1, end, chunk))
+					{
+						chunk.isValid = false;
+						return;
+					}
+				}
+				if (p != end)
+				{
+					p = SkipLine(p, end);
+				}
+			}
+		}
+
+		// 行の途中で切らないように、だいたいkChunkSizeずつに分ける
+		std::vector<ObjChunk> SplitChunks(std::string_view text)
+		{
+			std::vector<ObjChunk> chunks;
+			const char* begin = text.data();
+			const char* end = begin + text.size();
+			const char* p = begin;
+			while (p != end)
+			{
+				const char* chunkEnd = static_cast<size_t>(end - p) > kChunkSize ? SkipLine(p + kChunkSize, end) : end;
+				chunks.emplace_back().text = std::string_view(p, static_cast<size_t>(chunkEnd - p));
+				p = chunkEnd;
+			}
+			return chunks;
+		}
+	}
+
+	void ObjMesh::Clear()
+	{
+		positions.clear();
+		indices.clear();
+	}
+
+	bool LoadObj(const std::filesystem::path& path, ObjMesh& mesh, ThreadPool* threadPool)
+	{
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			mesh.Clear();
+			return false;
+		}
+		std::span<const char> data = file.GetData();
+		return ParseObj(std::string_view(data.data(), data.size()), mesh, threadPool);
+	}
+
+	bool ParseObj(std::string_view text, ObjMesh& mesh, ThreadPool* threadPool)
+	{
+		mesh.Clear();
+		std::vector<ObjChunk> chunks = SplitChunks(text);
+		ParallelFor(threadPool, chunks.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				ParseChunk(chunks[i]);
+			}
+		});
+
+		// 各チャンクの結果を置く位置を決めてから、並列に1つの配列へまとめる
+		std::vector<size_t> positionOffsets(chunks.size() + 1, 0);
+		std::vector<size_t> indexOffsets(chunks.size() + 1, 0);
+		for (size_t i = 0; i < chunks.size(); ++i)
+		{
+			if (!chunks[i].isValid)
+			{
+				return false;
+			}
+			positionOffsets[i + 1] = positionOffsets[i] + chunks[i].positions.size();
+			indexOffsets[i + 1] = indexOffsets[i] + chunks[i].indices.size();
+		}
+		size_t positionCount = positionOffsets.back();
+		if (positionCount > UINT32_MAX)
+		{
+			return false;
+		}
+		mesh.positions.resize(positionCount);
+		mesh.indices.resize(indexOffsets.back());
+
+		std::vector<uint8_t> isChunkValid(chunks.size(), 1);
+		ParallelFor(threadPool, chunks.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				ObjChunk& chunk = chunks[i];
+				std::copy(chunk.positions.begin(), chunk.positions.end(), mesh.positions.begin() + positionOffsets[i]);
+
+				// 相対の番号がファイルの先頭より前を指していれば読み込み失敗にする
+				// (32ビットで一周させると、あとで定義される頂点を指してしまう)
+				bool isValid = true;
+				const int64_t positionOffset = static_cast<int64_t>(positionOffsets[i]);
+				for (const ObjChunk::RelativeIndex& relative : chunk.relativeIndices)
+				{
+					int64_t index = positionOffset + relative.index;
+					isValid = isValid && index >= 0;
+					chunk.indices[relative.slot] = static_cast<uint32_t>(index);
+				}
+				// 範囲外の正の番号があっても読み込み失敗にする
+				isValid = isValid && std::all_of(chunk.indices.begin(), chunk.indices.end(), [&](uint32_t index) { return index < positionCount; });
+				isChunkValid[i] = isValid ? 1 : 0;
+				std::copy(chunk.indices.begin(), chunk.indices.end(), mesh.indices.begin() + indexOffsets[i]);
+			}
+		});
+
+		if (std::find(isChunkValid.begin(), isChunkValid.end(), uint8_t{ 0 }) != isChunkValid.end())
+		{
+			mesh.Clear();
+			return false;
+		}
+		return true;
+	}
+
+	void MakeTriangles(const ObjMesh& mesh, std::vector<Triangle>& triangles, ThreadPool* threadPool)
+	{
+		triangles.resize(mesh.GetTriangleCount());
+		ParallelFor(threadPool, triangles.size(), kTriangleGrainSize, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				const uint32_t* index = &mesh.indices[i * 3];
+				triangles[i] = { { mesh.positions[index[0]], mesh.positions[index[1]], mesh.positions[index[2]] } };
+			}
+		});
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Triangle.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace Math
+{
+	class ThreadPool;
+
+	/// <summary>
+	/// OBJファイルから読んだ形状。衝突判定と描画に使う頂点と面だけを持つ
+	/// </summary>
+	struct ObjMesh final
+	{
+		std::vector<Vector3> positions;	//!<頂点(vの行)。ファイルに書かれた順
+		std::vector<uint32_t> indices;	//!<三角形ごとに3つずつ並べたpositionsの番号。4角形以上の面は扇形に分ける
+
+		size_t GetTriangleCount() const { return indices.size() / 3; }
+		void Clear();
+	};
+
+	/*----------OBJファイルの読み込み----------*/
+	// ファイルをメモリマップし、コピーせずに解析する。v(頂点)とf(面)の行だけを読み、それ以外の行は読み飛ばす
+	// 大きなファイルは行の切れ目で分けて、threadPoolがあれば並列に解析する
+	// 開けない、数値が読めない、面の番号が範囲外のときはfalseを返し、meshは空になる
+	bool LoadObj(const std::filesystem::path& path, ObjMesh& mesh, ThreadPool* threadPool = nullptr);
+	// メモリ上のOBJの文字列を解析する(LoadObjの中身)
+	bool ParseObj(std::string_view text, ObjMesh& mesh, ThreadPool* threadPool = nullptr);
+
+	// 三角形ごとに頂点を並べた配列にする。TriangleBVH::BuildやDrawTriangleにそのまま渡せる
+	void MakeTriangles(const ObjMesh& mesh, std::vector<Triangle>& triangles, ThreadPool* threadPool = nullptr);
+}
@@ -1,4 +1,5 @@
 #include "Matrix4x4.h"
+#include "MatrixSimd.h"
 #include "Vector3.h"
 
 // デフォルトコンストラクタ: 0で初期化
@@ -37,16 +38,7 @@ Matrix4x4& Matrix4x4::operator-=(const Matrix4x4& other) {
 
 Matrix4x4& Matrix4x4::operator*=(const Matrix4x4& other) {
 	// 乗算の実装
-	Matrix4x4 result;
-	for (int i = 0; i < 4; ++i) {
-		for (int j = 0; j < 4; ++j) {
-			result.m[i][j] = 0;
-			for (int k = 0; k < 4; ++k) {
-				result.m[i][j] += m[i][k] * other.m[k][j];
-			}
-		}
-	}
-	*this = result;
+	*this = Math::MatrixSimd::Multiply(*this, other);
 	return *this;
 }
 
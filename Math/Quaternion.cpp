@@ -0,0 +1,145 @@
+#include "Quaternion.h"
+#include "MathFunction.h"
+
+namespace Math
+{
+	Quaternion IdentityQuaternion()
+	{
+		return { 0.0f, 0.0f, 0.0f, 1.0f };
+	}
+
+	Quaternion Multiply(const Quaternion& q1, const Quaternion& q2)
+	{
+		return {
+			q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y,
+			q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x,
+			q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w,
+			q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z,
+		};
+	}
+
+	Quaternion Conjugate(const Quaternion& quaternion)
+	{
+		return { -quaternion.x, -quaternion.y, -quaternion.z, quaternion.w };
+	}
+
+	float Dot(const Quaternion& q1, const Quaternion& q2)
+	{
+		return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+	}
+
+	float Norm(const Quaternion& quaternion)
+	{
+		return std::sqrt(Dot(quaternion, quaternion));
+	}
+
+	Quaternion Normalize(const Quaternion& quaternion)
+	{
+		float norm = Norm(quaternion);
+		if (norm == 0.0f) {
+			return IdentityQuaternion();
+		}
+		float inverseNorm = 1.0f / norm;
+		return { quaternion.x * inverseNorm, quaternion.y * inverseNorm, quaternion.z * inverseNorm, quaternion.w * inverseNorm };
+	}
+
+	Quaternion Inverse(const Quaternion& quaternion)
+	{
+		float normSquared = Dot(quaternion, quaternion);
+		assert(normSquared != 0.0f);
+		float inverseNormSquared = 1.0f / normSquared;
+		return { -quaternion.x * inverseNormSquared, -quaternion.y * inverseNormSquared, -quaternion.z * inverseNormSquared, quaternion.w * inverseNormSquared };
+	}
+
+	Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle)
+	{
+		float halfSin = std::sin(angle * 0.5f);
+		return { axis.x * halfSin, axis.y * halfSin, axis.z * halfSin, std::cos(angle * 0.5f) };
+	}
+
+	Quaternion MakeRotateEulerQuaternion(const Vector3& radian)
+	{
+		// X軸 → Y軸 → Z軸の順なので qz * qy * qx を展開したもの
+		float sx = std::sin(radian.x * 0.5f);
+		float cx = std::cos(radian.x * 0.5f);
+		float sy = std::sin(radian.y * 0.5f);
+		float cy = std::cos(radian.y * 0.5f);
+		float sz = std::sin(radian.z * 0.5f);
+		float cz = std::cos(radian.z * 0.5f);
+		return {
+			cz * cy * sx - sz * sy * cx,
+			cz * sy * cx + sz * cy * sx,
+			sz * cy * cx - cz * sy * sx,
+			cz * cy * cx + sz * sy * sx,
+		};
+	}
+
+	Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion)
+	{
+		// q * v * q^-1 を展開した形 (v + 2w(u×v) + 2u×(u×v)、uは虚部)
+		Vector3 u = MakeVector3(quaternion.x, quaternion.y, quaternion.z);
+		Vector3 t = Multiply(2.0f, Cross(u, vector));
+		return Add(Add(vector, Multiply(quaternion.w, t)), Cross(u, t));
+	}
+
+	Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t)
+	{
+		float dot = Dot(q0, q1);
+		// qと-qは同じ回転なので、近い方を補間する
+		Quaternion end = q1;
+		if (dot < 0.0f) {
+			end = { -q1.x, -q1.y, -q1.z, -q1.w };
+			dot = -dot;
+		}
+
+		float scale0 = 1.0f - t;
+		float scale1 = t;
+		// ほぼ同じ向きのときはsinθが0に近く割り算が不安定なので線形補間する
+		constexpr float kLerpThreshold = 0.9995f;
+		if (dot < kLerpThreshold) {
+			float theta = std::acos(dot);
+			float inverseSinTheta = 1.0f / std::sin(theta);
+			scale0 = std::sin((1.0f - t) * theta) * inverseSinTheta;
+			scale1 = std::sin(t * theta) * inverseSinTheta;
+		}
+
+		Quaternion result = {
+			scale0 * q0.x + scale1 * end.x,
+			scale0 * q0.y + scale1 * end.y,
+			scale0 * q0.z + scale1 * end.z,
+			scale0 * q0.w + scale1 * end.w,
+		};
+		return dot < kLerpThreshold ? result : Normalize(result);
+	}
+
+	Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion)
+	{
+		return MakeAffineMatrix(MakeVector3(1.0f, 1.0f, 1.0f), quaternion, MakeVector3(0.0f, 0.0f, 0.0f));
+	}
+
+	Matrix4x4 MakeRotateAxisAngle(const Vector3& axis, float angle)
+	{
+		// 長さが1でない軸でも回転行列になるように正規化する
+		return MakeRotateMatrix(MakeRotateAxisAngleQuaternion(Normalize(axis), angle));
+	}
+
+	Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate)
+	{
+		// 回転行列の各行(行ベクトル形式なので、列ベクトル形式の回転行列の転置)に拡縮をかける
+		float xx = rotate.x * rotate.x;
+		float yy = rotate.y * rotate.y;
+		float zz = rotate.z * rotate.z;
+		float xy = rotate.x * rotate.y;
+		float xz = rotate.x * rotate.z;
+		float yz = rotate.y * rotate.z;
+		float wx = rotate.w * rotate.x;
+		float wy = rotate.w * rotate.y;
+		float wz = rotate.w * rotate.z;
+		return MakeMatrix4x4({ {
+			{ scale.x * (1.0f - 2.0f * (yy + zz)), scale.x * 2.0f * (xy + wz), scale.x * 2.0f * (xz - wy), 0.0f },
+			{ scale.y * 2.0f * (xy - wz), scale.y * (1.0f - 2.0f * (xx + zz)), scale.y * 2.0f * (yz + wx), 0.0f },
+			{ scale.z * 2.0f * (xz + wy), scale.z * 2.0f * (yz - wx), scale.z * (1.0f - 2.0f * (xx + yy)), 0.0f },
+			{ translate.x, translate.y, translate.z, 1.0f },
+		} });
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Vector3.h"
+
+/// <summary>
+/// 回転を表すクォータニオン (x, y, zが虚部、wが実部)
+/// </summary>
+struct Quaternion final
+{
+	Quaternion() = default;
+	// 4成分すべてを指定させる。集成体のままだと{ x, y, z }でも初期化できてしまい、
+	// Normalize({ x, y, z })やDotの呼び出しがVector3版とあいまいになる
+	constexpr Quaternion(float imaginaryX, float imaginaryY, float imaginaryZ, float real) : x(imaginaryX), y(imaginaryY), z(imaginaryZ), w(real) {}
+
+	float x;	//!<虚部i
+	float y;	//!<虚部j
+	float z;	//!<虚部k
+	float w;	//!<実部
+};
+
+namespace Math
+{
+	/*----------Quaternion型の関数----------*/
+	Quaternion IdentityQuaternion();
+	// ハミルトン積 q1 * q2。回転としてはq2のあとにq1をかける(行列のMultiplyとは順番が逆)
+	Quaternion Multiply(const Quaternion& q1, const Quaternion& q2);
+	Quaternion Conjugate(const Quaternion& quaternion);
+	float Dot(const Quaternion& q1, const Quaternion& q2);
+	float Norm(const Quaternion& quaternion);
+	Quaternion Normalize(const Quaternion& quaternion);
+	Quaternion Inverse(const Quaternion& quaternion);
+
+	// axisは正規化しておくこと
+	Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle);
+	// MakeAffineMatrixと同じく、X軸 → Y軸 → Z軸の順に回転する
+	Quaternion MakeRotateEulerQuaternion(const Vector3& radian);
+
+	// 単位クォータニオンでベクトルを回転させる
+	Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion);
+
+	// 球面線形補間。tが0のときq0、1のときq1。遠回りしないように向きをそろえる
+	Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+	/*----------クォータニオンから行列を作る関数----------*/
+	// Transform(v, MakeRotateMatrix(q))とRotateVector(v, q)は同じ結果になる
+	Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion);
+	// 任意軸回転行列。axisは正規化してから使うので、長さは1でなくてもよい
+	Matrix4x4 MakeRotateAxisAngle(const Vector3& axis, float angle);
+	// 拡縮・回転・平行移動を1つの行列に直接書き込む(行列の掛け算をしない)
+	Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+}
@@ -0,0 +1,344 @@
+#include "SceneCache.h"
+#include "AABBTree.h"
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <type_traits>
+
+namespace Math
+{
+	namespace
+	{
+		// ノードはバイト列のまま書き出して、マップしたメモリからそのまま読む
+		static_assert(std::is_trivially_copyable_v<AABBTree::Node>);
+
+		// 一番成分の多いOBBに合わせる
+		const size_t kMaxComponentCount = 15;
+
+		/// <summary>
+		/// 書き出すブロック1つ分
+		/// </summary>
+		struct BlockSource final
+		{
+			SceneBlockType type;
+			size_t count = 0;
+			size_t componentCount = 0;
+			std::span<const float> components[kMaxComponentCount];
+		};
+
+		constexpr uint64_t AlignUp(uint64_t value)
+		{
+			return (value + kSceneCacheAlignment - 1) & ~static_cast<uint64_t>(kSceneCacheAlignment - 1);
+		}
+
+		size_t GetComponentCount(SceneBlockType type)
+		{
+			switch (type)
+			{
+			case SceneBlockType::Sphere: return 4;
+			case SceneBlockType::AABB: return 6;
+			case SceneBlockType::OBB: return 15;
+			case SceneBlockType::Plane: return 4;
+			case SceneBlockType::Triangle: return 9;
+			default: return 0;
+			}
+		}
+
+		// SoAの1本の配列が占めるバイト数(次の配列が境界から始まるように切り上げる)
+		uint64_t GetComponentStride(uint64_t count)
+		{
+			return AlignUp(count * sizeof(float));
+		}
+
+		uint64_t GetTreeBlockSize(uint64_t nodeCount)
+		{
+			return sizeof(SceneCacheTreeHeader) + nodeCount * sizeof(AABBTree::Node);
+		}
+
+		void AddBlock(std::vector<BlockSource>& sources, SceneBlockType type, std::initializer_list<std::span<const float>> components)
+		{
+			BlockSource source{};
+			source.type = type;
+			source.count = components.begin()->size();
+			if (source.count == 0)
+			{
+				return;
+			}
+			for (std::span<const float> component : components)
+			{
+				assert(component.size() == source.count);
+				source.components[source.componentCount++] = component;
+			}
+			assert(source.componentCount == GetComponentCount(type));
+			sources.push_back(source);
+		}
+
+		std::vector<BlockSource> GatherBlocks(const SceneCacheData& data)
+		{
+			std::vector<BlockSource> sources;
+			const SphereSoA& s = data.spheres;
+			AddBlock(sources, SceneBlockType::Sphere, { s.center[0], s.center[1], s.center[2], s.radius });
+			const AABBSoA& a = data.aabbs;
+			AddBlock(sources, SceneBlockType::AABB, { a.min[0], a.min[1], a.min[2], a.max[0], a.max[1], a.max[2] });
+			const OBBSoA& o = data.obbs;
+			AddBlock(sources, SceneBlockType::OBB, {
+				o.center[0], o.center[1], o.center[2],
+				o.orientations[0][0], o.orientations[0][1], o.orientations[0][2],
+				o.orientations[1][0], o.orientations[1][1], o.orientations[1][2],
+				o.orientations[2][0], o.orientations[2][1], o.orientations[2][2],
+				o.size[0], o.size[1], o.size[2] });
+			const PlaneSoA& p = data.planes;
+			AddBlock(sources, SceneBlockType::Plane, { p.normal[0], p.normal[1], p.normal[2], p.distance });
+			const TriangleSoA& t = data.triangles;
+			AddBlock(sources, SceneBlockType::Triangle, {
+				t.vertices[0][0], t.vertices[0][1], t.vertices[0][2],
+				t.vertices[1][0], t.vertices[1][1], t.vertices[1][2],
+				t.vertices[2][0], t.vertices[2][1], t.vertices[2][2] });
+			return sources;
+		}
+
+		// 今の位置からoffsetまで0で埋める
+		void PadTo(std::ofstream& stream, uint64_t& position, uint64_t offset)
+		{
+			static const char kZeros[kSceneCacheAlignment] = {};
+			assert(offset - position <= kSceneCacheAlignment);
+			stream.write(kZeros, static_cast<std::streamsize>(offset - position));
+			position = offset;
+		}
+
+		void WriteBytes(std::ofstream& stream, uint64_t& position, const void* data, uint64_t size)
+		{
+			stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+			position += size;
+		}
+	}
+
+	bool WriteSceneCache(const std::filesystem::path& path, const SceneCacheData& data)
+	{
+		std::vector<BlockSource> sources = GatherBlocks(data);
+		const AABBTree* tree = data.broadPhase;
+		bool hasTree = tree != nullptr && !tree->GetNodes().empty();
+
+		// 先にブロックの表を作って、それぞれの置き場所を決める
+		std::vector<SceneCacheBlock> blocks;
+		blocks.reserve(sources.size() + 1);
+		uint64_t offset = AlignUp(sizeof(SceneCacheHeader) + (sources.size() + (hasTree ? 1 : 0)) * sizeof(SceneCacheBlock));
+		for (const BlockSource& source : sources)
+		{
+			uint64_t size = source.componentCount * GetComponentStride(source.count);
+			blocks.push_back({ source.type, 0, source.count, offset, size });
+			offset = AlignUp(offset + size);
+		}
+		if (hasTree)
+		{
+			uint64_t nodeCount = tree->GetNodes().size();
+			uint64_t size = GetTreeBlockSize(nodeCount);
+			blocks.push_back({ SceneBlockType::AABBTree, 0, nodeCount, offset, size });
+			offset = AlignUp(offset + size);
+		}
+
+		SceneCacheHeader header{};
+		header.magic = kSceneCacheMagic;
+		header.version = kSceneCacheVersion;
+		header.headerSize = sizeof(SceneCacheHeader);
+		header.blockCount = static_cast<uint32_t>(blocks.size());
+		header.fileSize = offset;
+
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		if (!stream)
+		{
+			return false;
+		}
+		uint64_t position = 0;
+		WriteBytes(stream, position, &header, sizeof(header));
+		WriteBytes(stream, position, blocks.data(), blocks.size() * sizeof(SceneCacheBlock));
+
+		for (size_t i = 0; i < sources.size(); ++i)
+		{
+			const BlockSource& source = sources[i];
+			uint64_t stride = GetComponentStride(source.count);
+			for (size_t c = 0; c < source.componentCount; ++c)
+			{
+				PadTo(stream, position, blocks[i].offset + c * stride);
+				WriteBytes(stream, position, source.components[c].data(), source.count * sizeof(float));
+			}
+		}
+		if (hasTree)
+		{
+			std::span<const AABBTree::Node> nodes = tree->GetNodes();
+			SceneCacheTreeHeader treeHeader{};
+			treeHeader.root = tree->GetRoot();
+			treeHeader.freeList = tree->GetFreeList();
+			treeHeader.proxyCount = tree->GetProxyCount();
+			treeHeader.margin = tree->GetMargin();
+			treeHeader.nodeSize = sizeof(AABBTree::Node);
+			PadTo(stream, position, blocks.back().offset);
+			WriteBytes(stream, position, &treeHeader, sizeof(treeHeader));
+			WriteBytes(stream, position, nodes.data(), nodes.size_bytes());
+		}
+		PadTo(stream, position, header.fileSize);
+
+		stream.close();
+		return !stream.fail();
+	}
+
+	bool SceneCache::Open(const std::filesystem::path& path)
+	{
+		Close();
+		if (!file_.Open(path))
+		{
+			return false;
+		}
+
+		// ここで見るのはヘッダーとブロックの表だけ。中身の数値は読まない
+		auto validate = [&]()
+		{
+			std::span<const char> data = file_.GetData();
+			uint64_t fileSize = data.size();
+			if (fileSize < sizeof(SceneCacheHeader))
+			{
+				return false;
+			}
+			// マップした先頭はページ境界なので、構造体としてそのまま参照してよい
+			const SceneCacheHeader& header = *reinterpret_cast<const SceneCacheHeader*>(data.data());
+			if (header.magic != kSceneCacheMagic || header.version != kSceneCacheVersion ||
+				header.headerSize != sizeof(SceneCacheHeader) || header.fileSize != fileSize)
+			{
+				return false;
+			}
+			if (header.blockCount > (fileSize - sizeof(SceneCacheHeader)) / sizeof(SceneCacheBlock))
+			{
+				return false;
+			}
+
+			const SceneCacheBlock* blocks = reinterpret_cast<const SceneCacheBlock*>(data.data() + sizeof(SceneCacheHeader));
+			for (uint32_t i = 0; i < header.blockCount; ++i)
+			{
+				const SceneCacheBlock& block = blocks[i];
+				if (block.offset % kSceneCacheAlignment != 0 || block.offset > fileSize || block.size > fileSize - block.offset)
+				{
+					return false;
+				}
+
+				size_t typeIndex = static_cast<size_t>(block.type);
+				if (typeIndex == 0 || kBlockTypeCount <= typeIndex)
+				{
+					// 知らない種類は読み飛ばす
+					continue;
+				}
+				if (blocks_[typeIndex] != nullptr)
+				{
+					return false;
+				}
+
+				// 要素の数がブロックの大きさに収まっているか(掛け算があふれないように先に上限を見る)
+				if (block.type == SceneBlockType::AABBTree)
+				{
+					if (block.count > static_cast<uint64_t>(INT32_MAX) || block.size < GetTreeBlockSize(block.count))
+					{
+						return false;
+					}
+					const auto& treeHeader = *reinterpret_cast<const SceneCacheTreeHeader*>(data.data() + block.offset);
+					if (treeHeader.nodeSize != sizeof(AABBTree::Node))
+					{
+						return false;
+					}
+				}
+				else if (block.count > fileSize / sizeof(float) || block.size < GetComponentCount(block.type) * GetComponentStride(block.count))
+				{
+					return false;
+				}
+				blocks_[typeIndex] = &block;
+			}
+			return true;
+		};
+
+		if (!validate())
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void SceneCache::Close()
+	{
+		file_.Close();
+		std::fill(std::begin(blocks_), std::end(blocks_), nullptr);
+	}
+
+	std::span<const float> SceneCache::GetComponent(SceneBlockType type, size_t component) const
+	{
+		const SceneCacheBlock* block = blocks_[static_cast<size_t>(type)];
+		if (block == nullptr)
+		{
+			return {};
+		}
+		const char* begin = file_.GetData().data() + block->offset + component * GetComponentStride(block->count);
+		return { reinterpret_cast<const float*>(begin), static_cast<size_t>(block->count) };
+	}
+
+	SphereSoA SceneCache::GetSpheres() const
+	{
+		auto c = [&](size_t i) { return GetComponent(SceneBlockType::Sphere, i); };
+		return { { c(0), c(1), c(2) }, c(3) };
+	}
+
+	AABBSoA SceneCache::GetAABBs() const
+	{
+		auto c = [&](size_t i) { return GetComponent(SceneBlockType::AABB, i); };
+		return { { c(0), c(1), c(2) }, { c(3), c(4), c(5) } };
+	}
+
+	OBBSoA SceneCache::GetOBBs() const
+	{
+		OBBSoA view{};
+		for (size_t i = 0; i < 3; ++i)
+		{
+			view.center[i] = GetComponent(SceneBlockType::OBB, i);
+			for (size_t j = 0; j < 3; ++j)
+			{
+				view.orientations[i][j] = GetComponent(SceneBlockType::OBB, 3 + i * 3 + j);
+			}
+			view.size[i] = GetComponent(SceneBlockType::OBB, 12 + i);
+		}
+		return view;
+	}
+
+	PlaneSoA SceneCache::GetPlanes() const
+	{
+		auto c = [&](size_t i) { return GetComponent(SceneBlockType::Plane, i); };
+		return { { c(0), c(1), c(2) }, c(3) };
+	}
+
+	TriangleSoA SceneCache::GetTriangles() const
+	{
+		TriangleSoA view{};
+		for (size_t i = 0; i < 3; ++i)
+		{
+			for (size_t j = 0; j < 3; ++j)
+			{
+				view.vertices[i][j] = GetComponent(SceneBlockType::Triangle, i * 3 + j);
+			}
+		}
+		return view;
+	}
+
+	bool SceneCache::HasAABBTree() const
+	{
+		return blocks_[static_cast<size_t>(SceneBlockType::AABBTree)] != nullptr;
+	}
+
+	bool SceneCache::LoadAABBTree(AABBTree& tree) const
+	{
+		const SceneCacheBlock* block = blocks_[static_cast<size_t>(SceneBlockType::AABBTree)];
+		if (block == nullptr)
+		{
+			return false;
+		}
+		const char* begin = file_.GetData().data() + block->offset;
+		const auto& treeHeader = *reinterpret_cast<const SceneCacheTreeHeader*>(begin);
+		std::span<const AABBTree::Node> nodes(reinterpret_cast<const AABBTree::Node*>(begin + sizeof(SceneCacheTreeHeader)), static_cast<size_t>(block->count));
+		return tree.Restore(nodes, treeHeader.root, treeHeader.freeList, treeHeader.proxyCount, treeHeader.margin);
+	}
+}
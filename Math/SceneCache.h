@@ -0,0 +1,127 @@
+#pragma once
+#include "CollisionBatch.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace Math
+{
+	class AABBTree;
+
+	/*----------シーンキャッシュのファイル形式----------*/
+	// [SceneCacheHeader][SceneCacheBlock × blockCount][ブロックの中身 ...]の順に並べる
+	// ブロックの中身はどれもkSceneCacheAlignmentバイト境界から始まり、SoAの各配列もその境界に揃えて並べる
+	// マップしたメモリをそのままspanで参照するので、読み込むときに数値の変換もコピーもしない
+	// 数値はすべてリトルエンディアン(書いたマシンのまま)で、違うエンディアンのマシンではマジックが合わずに読めない
+
+	constexpr uint32_t kSceneCacheMagic = 0x4353544D;	// "MTSC"
+	constexpr uint32_t kSceneCacheVersion = 1;
+	constexpr size_t kSceneCacheAlignment = 64;			// キャッシュラインとAVXのロードに合わせる
+
+	/// <summary>
+	/// ブロックに入っているものの種類
+	/// 種類ごとの成分の数だけfloatの配列を並べる(球は中心x, y, z, 半径の順の4本など)
+	/// </summary>
+	enum class SceneBlockType : uint32_t
+	{
+		Sphere = 1,		//!< center[3], radius
+		AABB,			//!< min[3], max[3]
+		OBB,			//!< center[3], orientations[3][3], size[3]
+		Plane,			//!< normal[3], distance
+		Triangle,		//!< vertices[3][3]
+		AABBTree,		//!< SceneCacheTreeHeaderのあとにAABBTree::Nodeの配列
+	};
+
+	/// <summary>
+	/// ファイルの先頭
+	/// </summary>
+	struct SceneCacheHeader final
+	{
+		uint32_t magic;			//!< kSceneCacheMagic
+		uint32_t version;		//!< kSceneCacheVersion
+		uint32_t headerSize;	//!< sizeof(SceneCacheHeader)
+		uint32_t blockCount;	//!< 後ろに続くSceneCacheBlockの数
+		uint64_t fileSize;		//!< 書いたときのファイルの大きさ。途中で切れたファイルを見つける
+		uint8_t reserved[40];
+	};
+	static_assert(sizeof(SceneCacheHeader) == 64);
+
+	/// <summary>
+	/// ブロックの場所と大きさ
+	/// </summary>
+	struct SceneCacheBlock final
+	{
+		SceneBlockType type;
+		uint32_t reserved;
+		uint64_t count;		//!< 要素の数(AABBTreeはノードの数)
+		uint64_t offset;	//!< ファイルの先頭からのバイト数
+		uint64_t size;		//!< バイト数
+	};
+	static_assert(sizeof(SceneCacheBlock) == 32);
+
+	/// <summary>
+	/// AABBTreeブロックの先頭。ノードの配列はこの後ろのkSceneCacheAlignmentの境界から始まる
+	/// </summary>
+	struct SceneCacheTreeHeader final
+	{
+		int32_t root;
+		int32_t freeList;
+		int32_t proxyCount;
+		float margin;
+		uint32_t nodeSize;	//!< sizeof(AABBTree::Node)。構造体が変わったファイルを読まないようにする
+		uint8_t reserved[44];
+	};
+	static_assert(sizeof(SceneCacheTreeHeader) == kSceneCacheAlignment);
+
+	/// <summary>
+	/// シーンキャッシュに書き出すもの。空の配列の種類はブロックを作らない
+	/// </summary>
+	struct SceneCacheData final
+	{
+		SphereSoA spheres;
+		AABBSoA aabbs;
+		OBBSoA obbs;
+		PlaneSoA planes;
+		TriangleSoA triangles;
+		const AABBTree* broadPhase = nullptr;	//!< 作っておいたブロードフェーズの木(なくてもよい)
+	};
+
+	// SoAの各配列の長さは種類ごとに揃っていること。書き込めなかったらfalseを返す
+	bool WriteSceneCache(const std::filesystem::path& path, const SceneCacheData& data);
+
+	/// <summary>
+	/// メモリマップしたシーンキャッシュを読む
+	/// Openではヘッダーとブロックの表だけを確かめ、中身は読まないので、大きなファイルでもすぐに開ける
+	/// </summary>
+	class SceneCache final
+	{
+	public:
+		// 開けない、形式が違う、バージョンが違う、ブロックがファイルからはみ出しているときはfalseを返す
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		bool IsOpen() const { return file_.IsOpen(); }
+
+		// マップしたメモリを直接参照する。Closeするかこのオブジェクトが破棄されるまで有効
+		// ファイルにない種類は空になる
+		SphereSoA GetSpheres() const;
+		AABBSoA GetAABBs() const;
+		OBBSoA GetOBBs() const;
+		PlaneSoA GetPlanes() const;
+		TriangleSoA GetTriangles() const;
+
+		bool HasAABBTree() const;
+		// 保存した木をtreeにコピーする(組み直しはしない)。木がない、または壊れていたらfalseを返す
+		bool LoadAABBTree(AABBTree& tree) const;
+
+	private:
+		static constexpr size_t kBlockTypeCount = static_cast<size_t>(SceneBlockType::AABBTree) + 1;
+
+		// 種類ごとの成分の配列のcomponent番目
+		std::span<const float> GetComponent(SceneBlockType type, size_t component) const;
+
+		MappedFile file_;
+		const SceneCacheBlock* blocks_[kBlockTypeCount] = {};	//!< 種類ごとのブロック(ないものはnullptr)
+	};
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// SIMD命令セットはコンパイル時に選択する
+// MATH_SIMD_DISABLEを定義するとスカラー実装(リファレンス)のみを使う
+#if !defined(MATH_SIMD_DISABLE)
+#if defined(__AVX2__)
+#define MATH_SIMD_AVX2
+#endif
+#if defined(_M_X64) || defined(__SSE2__)
+#define MATH_SIMD_SSE2
+#endif
+#endif
+
+#if defined(MATH_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(MATH_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace Math::Simd
+{
+	/// <summary>
+	/// 1レーン分のスカラー実装。SIMD実装と同じ演算順で計算する
+	/// </summary>
+	struct Scalar final
+	{
+		using Float = float;
+		using Mask = bool;
+		static constexpr size_t kWidth = 1;
+
+		static Float Load(const float* p) { return *p; }
+		static void Store(float* p, Float a) { *p = a; }
+		static Float Set(float value) { return value; }
+		static Float Add(Float a, Float b) { return a + b; }
+		static Float Sub(Float a, Float b) { return a - b; }
+		static Float Mul(Float a, Float b) { return a * b; }
+		static Float Div(Float a, Float b) { return a / b; }
+		static Float Min(Float a, Float b) { return a < b ? a : b; }
+		static Float Max(Float a, Float b) { return a > b ? a : b; }
+		static Float Abs(Float a) { return std::fabs(a); }
+		static Float Sqrt(Float a) { return std::sqrt(a); }
+		static Mask CmpLe(Float a, Float b) { return a <= b; }
+		static Mask CmpLt(Float a, Float b) { return a < b; }
+		static Mask And(Mask a, Mask b) { return a && b; }
+		static Mask Or(Mask a, Mask b) { return a || b; }
+		static Float Select(Mask mask, Float a, Float b) { return mask ? a : b; }
+		static uint32_t MoveMask(Mask mask) { return mask ? 1u : 0u; }
+	};
+
+#if defined(MATH_SIMD_SSE2)
+	/// <summary>
+	/// SSE2による4レーン実装
+	/// </summary>
+	struct Sse final
+	{
+		using Float = __m128;
+		using Mask = __m128;
+		static constexpr size_t kWidth = 4;
+
+		static Float Load(const float* p) { return _mm_loadu_ps(p); }
+		static void Store(float* p, Float a) { _mm_storeu_ps(p, a); }
+		static Float Set(float value) { return _mm_set1_ps(value); }
+		static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+		static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+		static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+		static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+		static Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+		static Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+		static Float Abs(Float a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+		static Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+		static Mask CmpLe(Float a, Float b) { return _mm_cmple_ps(a, b); }
+		static Mask CmpLt(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+		static Mask And(Mask a, Mask b) { return _mm_and_ps(a, b); }
+		static Mask Or(Mask a, Mask b) { return _mm_or_ps(a, b); }
+		static Float Select(Mask mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+		static uint32_t MoveMask(Mask mask) { return static_cast<uint32_t>(_mm_movemask_ps(mask)); }
+	};
+
+	// 連続する4つのVector3(12要素)を読み、x, y, zごとに並べ替える
+	// (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3)
+	inline void LoadVector3x4(const float* p, __m128& x, __m128& y, __m128& z)
+	{
+		__m128 a = _mm_loadu_ps(p);
+		__m128 b = _mm_loadu_ps(p + 4);
+		__m128 c = _mm_loadu_ps(p + 8);
+		x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+		y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+	}
+
+	// LoadVector3x4の逆。x, y, zを4つのVector3の並びに戻して書き込む
+	inline void StoreVector3x4(float* p, __m128 x, __m128 y, __m128 z)
+	{
+		_mm_storeu_ps(p, _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(p + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(p + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+#endif
+
+#if defined(MATH_SIMD_AVX2)
+	/// <summary>
+	/// AVX2による8レーン実装
+	/// </summary>
+	struct Avx2 final
+	{
+		using Float = __m256;
+		using Mask = __m256;
+		static constexpr size_t kWidth = 8;
+
+		static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+		static void Store(float* p, Float a) { _mm256_storeu_ps(p, a); }
+		static Float Set(float value) { return _mm256_set1_ps(value); }
+		static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+		static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+		static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+		static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+		static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+		static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+		static Float Abs(Float a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+		static Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+		static Mask CmpLe(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		static Mask CmpLt(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static Mask And(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+		static Mask Or(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+		static Float Select(Mask mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+		static uint32_t MoveMask(Mask mask) { return static_cast<uint32_t>(_mm256_movemask_ps(mask)); }
+	};
+#endif
+}
@@ -0,0 +1,228 @@
+#include "SpatialHashGrid.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+
+namespace Math
+{
+	namespace
+	{
+		// 自分より「前」にある隣接セル。各組を一度だけ見つけるために半分だけ調べる
+		const int32_t kForwardNeighbors[13][3] = {
+			{ 1, 0, 0 },
+			{ -1, 1, 0 }, { 0, 1, 0 }, { 1, 1, 0 },
+			{ -1, -1, 1 }, { 0, -1, 1 }, { 1, -1, 1 },
+			{ -1, 0, 1 }, { 0, 0, 1 }, { 1, 0, 1 },
+			{ -1, 1, 1 }, { 0, 1, 1 }, { 1, 1, 1 },
+		};
+
+		// ParallelForで1回に処理する数
+		const size_t kCellGrainSize = 4096;
+		const size_t kEntryGrainSize = 1024;
+	}
+
+	void SpatialHashGrid::Update(std::span<const Ball> balls)
+	{
+		const uint32_t count = static_cast<uint32_t>(balls.size());
+
+		float maxRadius = 0.0f;
+		for (const Ball& ball : balls)
+		{
+			maxRadius = std::max(maxRadius, ball.radius);
+		}
+		bool rebuild = BeginUpdate(count, maxRadius);
+
+		// 各ボールのセルを求め、前のステップから変わったかを調べる
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const Vector3& p = balls[i].position;
+			rebuild |= AssignCell(i, p.x, p.y, p.z);
+		}
+
+		if (rebuild)
+		{
+			Rebuild(nullptr);
+		}
+	}
+
+	void SpatialHashGrid::Update(std::span<const float> positionX, std::span<const float> positionY, std::span<const float> positionZ, std::span<const float> radius, ThreadPool* threadPool)
+	{
+		const uint32_t count = static_cast<uint32_t>(radius.size());
+
+		float maxRadius = 0.0f;
+		for (float r : radius)
+		{
+			maxRadius = std::max(maxRadius, r);
+		}
+		std::atomic<bool> rebuild(BeginUpdate(count, maxRadius));
+
+		// ボールごとに独立しているので区間に分けて並列に求める
+		ParallelFor(threadPool, count, kCellGrainSize, [&](size_t begin, size_t end) {
+			bool changed = false;
+			for (size_t i = begin; i < end; ++i)
+			{
+				changed |= AssignCell(static_cast<uint32_t>(i), positionX[i], positionY[i], positionZ[i]);
+			}
+			if (changed)
+			{
+				rebuild.store(true, std::memory_order_relaxed);
+			}
+		});
+
+		if (rebuild.load(std::memory_order_relaxed))
+		{
+			Rebuild(threadPool);
+		}
+	}
+
+	bool SpatialHashGrid::BeginUpdate(uint32_t count, float maxRadius)
+	{
+		// セルの大きさは最大の直径にする
+		float cellSize = maxRadius > 0.0f ? maxRadius * 2.0f : 1.0f;
+		bool changed = cellSize != cellSize_ || count != cells_.size();
+		cellSize_ = cellSize;
+		invCellSize_ = 1.0f / cellSize;
+		cells_.resize(count);
+		return changed;
+	}
+
+	bool SpatialHashGrid::AssignCell(uint32_t i, float x, float y, float z)
+	{
+		Cell cell{
+			static_cast<int32_t>(std::floor(x * invCellSize_)),
+			static_cast<int32_t>(std::floor(y * invCellSize_)),
+			static_cast<int32_t>(std::floor(z * invCellSize_))
+		};
+		if (cell == cells_[i])
+		{
+			return false;
+		}
+		cells_[i] = cell;
+		return true;
+	}
+
+	void SpatialHashGrid::Rebuild(ThreadPool* threadPool)
+	{
+		const uint32_t count = static_cast<uint32_t>(cells_.size());
+
+		// バケット数はボール数の2倍以上の2のべき乗
+		uint32_t bucketCount = std::bit_ceil(std::max(count * 2u, 16u));
+		bucketMask_ = bucketCount - 1;
+
+		// ハッシュは並列に求めておく
+		hashes_.resize(count);
+		ParallelFor(threadPool, count, kCellGrainSize, [this](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				hashes_[i] = Hash(cells_[i]);
+			}
+		});
+
+		// 計数ソートでバケットごとに並べる
+		// スレッドごとに数えるとバケット数(ボール数の2倍以上)の配列がスレッドの数だけ要るので、ここは1スレッドで行う
+		bucketStart_.assign(bucketCount + 1, 0);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			++bucketStart_[hashes_[i] + 1];
+		}
+		for (uint32_t b = 0; b < bucketCount; ++b)
+		{
+			bucketStart_[b + 1] += bucketStart_[b];
+		}
+
+		entries_.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			// 一時的にbucketStart_[b]を書き込み位置として使い、あとで戻す
+			uint32_t& cursor = bucketStart_[hashes_[i]];
+			entries_[cursor++] = { cells_[i], i };
+		}
+		for (uint32_t b = bucketCount; b > 0; --b)
+		{
+			bucketStart_[b] = bucketStart_[b - 1];
+		}
+		bucketStart_[0] = 0;
+	}
+
+	void SpatialHashGrid::FindPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs, ThreadPool* threadPool)
+	{
+		pairs.clear();
+
+		const size_t count = entries_.size();
+		if (!threadPool || threadPool->GetThreadCount() == 1 || count <= kEntryGrainSize)
+		{
+			FindPairsInRange(0, static_cast<uint32_t>(count), pairs);
+			return;
+		}
+
+		// 区間ごとに別の配列に集め、区間の順につなげる。こうすると組の順番が単一スレッドのときと変わらない
+		chunkPairs_.resize((count + kEntryGrainSize - 1) / kEntryGrainSize);
+		for (auto& chunk : chunkPairs_)
+		{
+			chunk.clear();
+		}
+		ParallelFor(threadPool, count, kEntryGrainSize, [this](size_t begin, size_t end) {
+			FindPairsInRange(static_cast<uint32_t>(begin), static_cast<uint32_t>(end), chunkPairs_[begin / kEntryGrainSize]);
+		});
+
+		size_t pairCount = 0;
+		for (const auto& chunk : chunkPairs_)
+		{
+			pairCount += chunk.size();
+		}
+		pairs.reserve(pairCount);
+		for (const auto& chunk : chunkPairs_)
+		{
+			pairs.insert(pairs.end(), chunk.begin(), chunk.end());
+		}
+	}
+
+	void SpatialHashGrid::FindPairsInRange(uint32_t begin, uint32_t end, std::vector<std::pair<uint32_t, uint32_t>>& pairs) const
+	{
+		for (uint32_t k = begin; k < end; ++k)
+		{
+			const Entry& entry = entries_[k];
+			const Cell& cell = entry.cell;
+
+			// 同じセル(同じバケットの後ろにある要素)
+			uint32_t bucket = Hash(cell);
+			AddPairs(cell, k, bucketStart_[bucket + 1], pairs);
+
+			// 前方の隣接セル
+			for (const auto& offset : kForwardNeighbors)
+			{
+				Cell neighbor{ cell.x + offset[0], cell.y + offset[1], cell.z + offset[2] };
+				uint32_t neighborBucket = Hash(neighbor);
+				uint32_t begin = bucketStart_[neighborBucket];
+				uint32_t end = bucketStart_[neighborBucket + 1];
+				for (uint32_t n = begin; n < end; ++n)
+				{
+					if (entries_[n].cell == neighbor)
+					{
+						pairs.emplace_back(std::min(entry.index, entries_[n].index), std::max(entry.index, entries_[n].index));
+					}
+				}
+			}
+		}
+	}
+
+	uint32_t SpatialHashGrid::Hash(const Cell& cell) const
+	{
+		uint32_t h = (static_cast<uint32_t>(cell.x) * 73856093u) ^ (static_cast<uint32_t>(cell.y) * 19349663u) ^ (static_cast<uint32_t>(cell.z) * 83492791u);
+		return h & bucketMask_;
+	}
+
+	void SpatialHashGrid::AddPairs(const Cell& cell, uint32_t begin, uint32_t end, std::vector<std::pair<uint32_t, uint32_t>>& pairs) const
+	{
+		const uint32_t index = entries_[begin].index;
+		for (uint32_t n = begin + 1; n < end; ++n)
+		{
+			if (entries_[n].cell == cell)
+			{
+				pairs.emplace_back(std::min(index, entries_[n].index), std::max(index, entries_[n].index));
+			}
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "Ball.h"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Math
+{
+	class ThreadPool;
+
+	/// <summary>
+	/// 大量のボール用の一様グリッド(空間ハッシュ)
+	/// セルの大きさは最大半径の2倍にするので、ぶつかり得る相手は隣接する27セルのどれかに入っている
+	/// バッファは使い回すので、ボールの数が増えない限り毎フレームのメモリ確保は起きない
+	/// </summary>
+	class SpatialHashGrid final
+	{
+	public:
+		// ボールをセルに振り分け直す。どのボールもセルをまたいでいなければ並べ替えを省く
+		void Update(std::span<const Ball> balls);
+
+		// 位置と半径をSoA形式で渡す版
+		// threadPoolを渡すと、セルの振り分けとハッシュの計算を並列に行う
+		void Update(std::span<const float> positionX, std::span<const float> positionY, std::span<const float> positionZ, std::span<const float> radius, ThreadPool* threadPool = nullptr);
+
+		// 隣接するセルに入っているボールの組を候補として求める(first < second)
+		// 実際に当たっているかはIsCollision(const Sphere&, const Sphere&)で判定する
+		// threadPoolを渡すと要素を区間に分けて並列に探す。組の順番は単一スレッドのときと同じになる
+		void FindPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs, ThreadPool* threadPool = nullptr);
+
+		float GetCellSize() const { return cellSize_; }
+
+	private:
+		struct Cell final
+		{
+			int32_t x, y, z;
+			bool operator==(const Cell& other) const { return x == other.x && y == other.y && z == other.z; }
+		};
+
+		// セルごとに並べた要素。同じバケットの要素が連続して並ぶ
+		struct Entry final
+		{
+			Cell cell;
+			uint32_t index;
+		};
+
+		uint32_t Hash(const Cell& cell) const;
+
+		// セルの大きさを決め直す。変わったらtrueを返す
+		bool BeginUpdate(uint32_t count, float maxRadius);
+
+		// i番目のボールのセルを更新する。変わったらtrueを返す
+		bool AssignCell(uint32_t i, float x, float y, float z);
+
+		// バケットごとに並べ直す
+		void Rebuild(ThreadPool* threadPool);
+
+		// entries_[begin, end)の要素から見つかる組を追加する
+		void FindPairsInRange(uint32_t begin, uint32_t end, std::vector<std::pair<uint32_t, uint32_t>>& pairs) const;
+
+		// entries_[begin]と、同じバケット内でそれより後ろにある同じセルの要素との組を追加する
+		void AddPairs(const Cell& cell, uint32_t begin, uint32_t end, std::vector<std::pair<uint32_t, uint32_t>>& pairs) const;
+
+		float cellSize_ = 0.0f;
+		float invCellSize_ = 1.0f;
+		uint32_t bucketMask_ = 0;
+		std::vector<Cell> cells_;			// ボールごとのセル
+		std::vector<uint32_t> hashes_;		// ボールごとのバケット(Rebuildの作業用)
+		std::vector<uint32_t> bucketStart_;	// バケットごとのentries_の開始位置
+		std::vector<Entry> entries_;
+		std::vector<std::vector<std::pair<uint32_t, uint32_t>>> chunkPairs_;	// 並列のFindPairsで区間ごとに見つけた組
+	};
+}
@@ -0,0 +1,126 @@
+#include "SphereMesh.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <memory>
+
+namespace Math
+{
+	namespace
+	{
+		// スクリーン上の半径(ピクセル)がこれ未満なら、対応する分割数を使う
+		const float kLevelRadiusThresholds[] = { 6.0f, 24.0f, 64.0f };
+		static_assert(std::size(kLevelRadiusThresholds) + 1 == std::size(SphereMesh::kSubdivisionLevels));
+	}
+
+	SphereMesh::SphereMesh(uint32_t subdivision)
+		: subdivision_(subdivision)
+	{
+		const float kLatStep = (float)M_PI / subdivision_;						//緯度のステップ
+		const float kLonStep = 2.0f * (float)M_PI / subdivision_;				//経度のステップ
+
+		// 緯度・経度ごとのsin/cosを先に求めておく
+		std::vector<float> sinLat(subdivision_ + 1), cosLat(subdivision_ + 1);
+		for (uint32_t latIndex = 0; latIndex <= subdivision_; ++latIndex)
+		{
+			float lat = -0.5f * (float)M_PI + latIndex * kLatStep;
+			sinLat[latIndex] = std::sin(lat);
+			cosLat[latIndex] = std::cos(lat);
+		}
+		std::vector<float> sinLon(subdivision_), cosLon(subdivision_);
+		for (uint32_t lonIndex = 0; lonIndex < subdivision_; ++lonIndex)
+		{
+			float lon = lonIndex * kLonStep;
+			sinLon[lonIndex] = std::sin(lon);
+			cosLon[lonIndex] = std::cos(lon);
+		}
+
+		vertices_.reserve((subdivision_ + 1) * subdivision_);
+		for (uint32_t latIndex = 0; latIndex <= subdivision_; ++latIndex)
+		{
+			for (uint32_t lonIndex = 0; lonIndex < subdivision_; ++lonIndex)
+			{
+				vertices_.push_back({ cosLat[latIndex] * cosLon[lonIndex], sinLat[latIndex], cosLat[latIndex] * sinLon[lonIndex] });
+			}
+		}
+
+		// 元のDrawSphereと同じく、各セルで次の緯度への線と次の経度への線を引く
+		assert(vertices_.size() <= UINT16_MAX);
+		auto index = [this](uint32_t latIndex, uint32_t lonIndex)
+		{
+			return static_cast<uint16_t>(latIndex * subdivision_ + lonIndex % subdivision_);
+		};
+		lines_.reserve(subdivision_ * subdivision_ * 4);
+		for (uint32_t latIndex = 0; latIndex < subdivision_; ++latIndex)
+		{
+			for (uint32_t lonIndex = 0; lonIndex < subdivision_; ++lonIndex)
+			{
+				lines_.push_back(index(latIndex, lonIndex));
+				lines_.push_back(index(latIndex + 1, lonIndex));
+				lines_.push_back(index(latIndex, lonIndex));
+				lines_.push_back(index(latIndex, lonIndex + 1));
+			}
+		}
+	}
+
+	SphereMesh& SphereMesh::Get(uint32_t subdivision)
+	{
+		assert(subdivision >= 3 && subdivision <= kMaxSubdivision);
+		static std::unique_ptr<SphereMesh> meshes[kMaxSubdivision + 1];
+		std::unique_ptr<SphereMesh>& mesh = meshes[subdivision];
+		if (!mesh)
+		{
+			mesh.reset(new SphereMesh(subdivision));
+		}
+		return *mesh;
+	}
+
+	uint32_t SphereMesh::SelectSubdivision(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix)
+	{
+		float center[4];
+		TransformHomogeneous(sphere.center, viewProjectionMatrix, center);
+		if (center[3] <= 0.0f)
+		{
+			return kMaxSubdivision;
+		}
+		float centerX = center[0] / center[3];
+		float centerY = center[1] / center[3];
+
+		// 各軸方向に半径だけずらした点がスクリーン上でどれだけ離れるかで大きさを見積もる
+		float screenRadiusSquared = 0.0f;
+		const Vector3 offsets[3] = { { sphere.radius, 0.0f, 0.0f }, { 0.0f, sphere.radius, 0.0f }, { 0.0f, 0.0f, sphere.radius } };
+		for (const Vector3& offset : offsets)
+		{
+			float point[4];
+			TransformHomogeneous(Add(sphere.center, offset), viewProjectionMatrix, point);
+			if (point[3] <= 0.0f)
+			{
+				return kMaxSubdivision;
+			}
+			// 正規化デバイス座標での差を、ビューポート変換の拡大部分でピクセルにする
+			float ndcX = point[0] / point[3] - centerX;
+			float ndcY = point[1] / point[3] - centerY;
+			float dx = ndcX * viewportMatrix.m[0][0] + ndcY * viewportMatrix.m[1][0];
+			float dy = ndcX * viewportMatrix.m[0][1] + ndcY * viewportMatrix.m[1][1];
+			screenRadiusSquared = (std::max)(screenRadiusSquared, dx * dx + dy * dy);
+		}
+
+		for (size_t i = 0; i < std::size(kLevelRadiusThresholds); ++i)
+		{
+			if (screenRadiusSquared < kLevelRadiusThresholds[i] * kLevelRadiusThresholds[i])
+			{
+				return kSubdivisionLevels[i];
+			}
+		}
+		return kSubdivisionLevels[std::size(kSubdivisionLevels) - 1];
+	}
+
+	void SphereMesh::Draw(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode)
+	{
+		// 単位球 -> 拡大・平行移動 -> クリップ空間 を1つの行列にまとめる
+		Matrix4x4 localToWorld = MakeAffineMatrix({ sphere.radius, sphere.radius, sphere.radius }, { 0.0f, 0.0f, 0.0f }, sphere.center);
+		DrawClippedLines(vertices_, lines_, Multiply(localToWorld, viewProjectionMatrix), viewportMatrix, color, mode);
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "ClipSpaceLines.h"
+#include "Matrix4x4.h"
+#include "Sphereh.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <vector>
+
+namespace Math
+{
+	/// <summary>
+	/// 単位球のワイヤーフレーム
+	/// 頂点は分割数ごとに1度だけ作ってキャッシュし、描画時は拡大・平行移動を変換行列に含めてまとめて変換する
+	/// 線はクリップ空間で切り取ってからスクリーン座標にする
+	/// </summary>
+	class SphereMesh final
+	{
+	public:
+		// 用意している分割数 (細かい順ではなく粗い順)
+		static constexpr uint32_t kSubdivisionLevels[] = { 4, 8, 12, 20 };
+		static constexpr uint32_t kMaxSubdivision = 20;
+
+		// 分割数に対応するメッシュを返す。初めて使う分割数のときだけ頂点を作る
+		static SphereMesh& Get(uint32_t subdivision);
+
+		// スクリーン上の半径(ピクセル)から分割数を選ぶ
+		// 球の中心がカメラの後ろにあるときは一番細かい分割数を返す
+		static uint32_t SelectSubdivision(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix);
+
+		void Draw(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color, LineClipMode mode = LineClipMode::Near);
+
+		uint32_t GetSubdivision() const { return subdivision_; }
+		uint32_t GetLineCount() const { return static_cast<uint32_t>(lines_.size() / 2); }
+
+	private:
+		explicit SphereMesh(uint32_t subdivision);
+
+		uint32_t subdivision_;
+
+		// 単位球上の頂点。緯度(subdivision_ + 1) x 経度subdivision_
+		std::vector<Vector3> vertices_;
+		// 線の始点と終点の頂点番号を2つずつ並べたもの
+		std::vector<uint16_t> lines_;
+	};
+}
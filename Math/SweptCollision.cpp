@@ -0,0 +1,315 @@
+#include "SweptCollision.h"
+#include "MathFunction.h"
+#include <cfloat>
+
+namespace Math
+{
+	namespace
+	{
+		// 移動量の2乗がこれより小さければ止まっているとみなす
+		const float kEpsilon = 1e-12f;
+
+		// 移動する点(始点origin、移動量motion)と球の判定。当たれば最初の時刻をtに入れる
+		bool IntersectMovingPointSphere(const Vector3& origin, const Vector3& motion, const Vector3& center, float radius, float& t)
+		{
+			Vector3 offset = origin - center;
+			float a = Dot(motion, motion);
+			float b = Dot(offset, motion);
+			float c = Dot(offset, offset) - radius * radius;
+			if (a < kEpsilon || b > 0.0f)
+			{
+				return false;
+			}
+			float discriminant = b * b - a * c;
+			if (discriminant < 0.0f)
+			{
+				return false;
+			}
+			t = std::max((-b - std::sqrt(discriminant)) / a, 0.0f);
+			return t <= 1.0f;
+		}
+
+		// 移動する点とカプセル(線分start-endの周りの半径radius)の判定
+		bool IntersectMovingPointCapsule(const Vector3& origin, const Vector3& motion, const Vector3& start, const Vector3& end, float radius, float& t)
+		{
+			float bestT = FLT_MAX;
+
+			// 側面(無限に長い円柱との交点が線分の範囲にあるか)
+			Vector3 axis = end - start;
+			Vector3 offset = origin - start;
+			float axisLengthSquared = Dot(axis, axis);
+			float motionAxis = Dot(motion, axis);
+			float offsetAxis = Dot(offset, axis);
+			float a = axisLengthSquared * Dot(motion, motion) - motionAxis * motionAxis;
+			float b = axisLengthSquared * Dot(offset, motion) - motionAxis * offsetAxis;
+			float c = axisLengthSquared * (Dot(offset, offset) - radius * radius) - offsetAxis * offsetAxis;
+			if (a > kEpsilon && b < 0.0f)
+			{
+				float discriminant = b * b - a * c;
+				if (discriminant >= 0.0f)
+				{
+					float cylinderT = std::max((-b - std::sqrt(discriminant)) / a, 0.0f);
+					float s = offsetAxis + cylinderT * motionAxis;
+					if (cylinderT <= 1.0f && 0.0f <= s && s <= axisLengthSquared)
+					{
+						bestT = cylinderT;
+					}
+				}
+			}
+
+			// 両端の球
+			float sphereT;
+			if (IntersectMovingPointSphere(origin, motion, start, radius, sphereT))
+			{
+				bestT = std::min(bestT, sphereT);
+			}
+			if (IntersectMovingPointSphere(origin, motion, end, radius, sphereT))
+			{
+				bestT = std::min(bestT, sphereT);
+			}
+
+			t = bestT;
+			return bestT <= 1.0f;
+		}
+
+		Vector3 ClosestPoint(const Vector3& point, const AABB& aabb)
+		{
+			return {
+				std::clamp(point.x, aabb.min.x, aabb.max.x),
+				std::clamp(point.y, aabb.min.y, aabb.max.y),
+				std::clamp(point.z, aabb.min.z, aabb.max.z)
+			};
+		}
+
+		// 三角形上の最近接点(頂点・辺・面の領域で場合分けする)
+		Vector3 ClosestPoint(const Vector3& point, const Triangle& triangle)
+		{
+			const Vector3& a = triangle.vertices[0];
+			const Vector3& b = triangle.vertices[1];
+			const Vector3& c = triangle.vertices[2];
+			Vector3 ab = b - a;
+			Vector3 ac = c - a;
+			Vector3 ap = point - a;
+			float d1 = Dot(ab, ap);
+			float d2 = Dot(ac, ap);
+			if (d1 <= 0.0f && d2 <= 0.0f) { return a; }
+
+			Vector3 bp = point - b;
+			float d3 = Dot(ab, bp);
+			float d4 = Dot(ac, bp);
+			if (d3 >= 0.0f && d4 <= d3) { return b; }
+
+			float vc = d1 * d4 - d3 * d2;
+			if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) { return a + ab * (d1 / (d1 - d3)); }
+
+			Vector3 cp = point - c;
+			float d5 = Dot(ab, cp);
+			float d6 = Dot(ac, cp);
+			if (d6 >= 0.0f && d5 <= d6) { return c; }
+
+			float vb = d5 * d2 - d1 * d6;
+			if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) { return a + ac * (d2 / (d2 - d6)); }
+
+			float va = d3 * d6 - d5 * d4;
+			if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) { return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))); }
+
+			float denominator = 1.0f / (va + vb + vc);
+			return a + ab * (vb * denominator) + ac * (vc * denominator);
+		}
+
+		// 時刻tでの球の中心と形状上の最近接点から当たった位置と法線を求める
+		void MakeHit(const Vector3& center, const Vector3& closestPoint, const Vector3& fallbackNormal, float t, SweepHit& hit)
+		{
+			Vector3 difference = center - closestPoint;
+			float length = Length(difference);
+			hit.t = t;
+			hit.point = closestPoint;
+			hit.normal = length > 0.0f ? difference / length : fallbackNormal;
+		}
+	}
+
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const Plane& plane, SweepHit& hit)
+	{
+		// 平面の法線ベクトルと球の中心点との距離(移動前と移動後)
+		float startDistance = Dot(plane.normal, sphere.center) - plane.distance;
+		float endDistance = startDistance + Dot(plane.normal, motion);
+
+		// 球のいる側の面に向かって半径の分だけ手前で当たる
+		float side = startDistance >= 0.0f ? 1.0f : -1.0f;
+		hit.normal = plane.normal * side;
+		if (std::abs(startDistance) <= sphere.radius)
+		{
+			hit.t = 0.0f;
+			hit.point = sphere.center - plane.normal * startDistance;
+			return true;
+		}
+		if (endDistance * side > sphere.radius)
+		{
+			return false;
+		}
+
+		hit.t = (startDistance - side * sphere.radius) / (startDistance - endDistance);
+		hit.point = sphere.center + motion * hit.t - hit.normal * sphere.radius;
+		return true;
+	}
+
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const AABB& aabb, SweepHit& hit)
+	{
+		// 動き始めですでに当たっている
+		Vector3 closestPoint = ClosestPoint(sphere.center, aabb);
+		if (LengthSquared(sphere.center - closestPoint) <= sphere.radius * sphere.radius)
+		{
+			MakeHit(sphere.center, closestPoint, { 0.0f, 1.0f, 0.0f }, 0.0f, hit);
+			return true;
+		}
+
+		// 半径だけ広げたAABBに球の中心の線分が入る時刻を求める(IsCollision(const AABB&, const Segment&)と同じスラブ法)
+		Vector3 extent = { sphere.radius, sphere.radius, sphere.radius };
+		AABB expanded = { aabb.min - extent, aabb.max + extent };
+		float tEnter = 0.0f;
+		float tExit = 1.0f;
+		const float origin[3] = { sphere.center.x, sphere.center.y, sphere.center.z };
+		const float direction[3] = { motion.x, motion.y, motion.z };
+		const float minimum[3] = { expanded.min.x, expanded.min.y, expanded.min.z };
+		const float maximum[3] = { expanded.max.x, expanded.max.y, expanded.max.z };
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (std::abs(direction[axis]) < kEpsilon)
+			{
+				if (origin[axis] < minimum[axis] || origin[axis] > maximum[axis])
+				{
+					return false;
+				}
+				continue;
+			}
+			float t1 = (minimum[axis] - origin[axis]) / direction[axis];
+			float t2 = (maximum[axis] - origin[axis]) / direction[axis];
+			tEnter = std::max(tEnter, std::min(t1, t2));
+			tExit = std::min(tExit, std::max(t1, t2));
+		}
+		if (tEnter > tExit)
+		{
+			return false;
+		}
+
+		// 入った位置が面の領域(元のAABBの外にはみ出している軸が1つ以下)ならそこで当たる
+		Vector3 center = sphere.center + motion * tEnter;
+		int outsideCount =
+			(center.x < aabb.min.x || center.x > aabb.max.x ? 1 : 0) +
+			(center.y < aabb.min.y || center.y > aabb.max.y ? 1 : 0) +
+			(center.z < aabb.min.z || center.z > aabb.max.z ? 1 : 0);
+		if (outsideCount <= 1)
+		{
+			MakeHit(center, ClosestPoint(center, aabb), { 0.0f, 1.0f, 0.0f }, tEnter, hit);
+			return true;
+		}
+
+		// 辺・頂点の領域では、辺を軸にしたカプセルと判定する
+		Vector3 corners[8];
+		for (int i = 0; i < 8; ++i)
+		{
+			corners[i] = { (i & 1) ? aabb.max.x : aabb.min.x, (i & 2) ? aabb.max.y : aabb.min.y, (i & 4) ? aabb.max.z : aabb.min.z };
+		}
+		float bestT = FLT_MAX;
+		for (int i = 0; i < 8; ++i)
+		{
+			for (int bit = 1; bit < 8; bit <<= 1)
+			{
+				if (i & bit)
+				{
+					continue;
+				}
+				float t;
+				if (IntersectMovingPointCapsule(sphere.center, motion, corners[i], corners[i | bit], sphere.radius, t))
+				{
+					bestT = std::min(bestT, t);
+				}
+			}
+		}
+		if (bestT > 1.0f)
+		{
+			return false;
+		}
+
+		center = sphere.center + motion * bestT;
+		MakeHit(center, ClosestPoint(center, aabb), { 0.0f, 1.0f, 0.0f }, bestT, hit);
+		return true;
+	}
+
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const CachedOBB& obb, SweepHit& hit)
+	{
+		// OBBのローカル空間ではAABBとして判定できる。移動量は回転だけを戻す
+		Sphere localSphere = { TransformToLocal(obb, sphere.center), sphere.radius };
+		Vector3 localMotion = { Dot(motion, obb.axes[0]), Dot(motion, obb.axes[1]), Dot(motion, obb.axes[2]) };
+		if (!SweepSphere(localSphere, localMotion, AABB{ -obb.halfExtents, obb.halfExtents }, hit))
+		{
+			return false;
+		}
+
+		hit.point = obb.center + obb.axes[0] * hit.point.x + obb.axes[1] * hit.point.y + obb.axes[2] * hit.point.z;
+		hit.normal = obb.axes[0] * hit.normal.x + obb.axes[1] * hit.normal.y + obb.axes[2] * hit.normal.z;
+		return true;
+	}
+
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const OBB& obb, SweepHit& hit)
+	{
+		return SweepSphere(sphere, motion, MakeCachedOBB(obb), hit);
+	}
+
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const Triangle& triangle, SweepHit& hit)
+	{
+		Vector3 normal = Cross(triangle.vertices[1] - triangle.vertices[0], triangle.vertices[2] - triangle.vertices[0]);
+		float normalLength = Length(normal);
+		if (normalLength <= 0.0f)
+		{
+			return false;
+		}
+		normal = normal / normalLength;
+
+		// 動き始めですでに当たっている
+		Vector3 closestPoint = ClosestPoint(sphere.center, triangle);
+		if (LengthSquared(sphere.center - closestPoint) <= sphere.radius * sphere.radius)
+		{
+			MakeHit(sphere.center, closestPoint, normal, 0.0f, hit);
+			return true;
+		}
+
+		// 三角形を含む平面に当たる位置が三角形の内側なら、そこで当たる
+		SweepHit planeHit;
+		if (SweepSphere(sphere, motion, Plane{ normal, Dot(normal, triangle.vertices[0]) }, planeHit) && planeHit.t > 0.0f)
+		{
+			// 各辺に対して内側にあるか(IsCollision(const Triangle&, const Segment&)と同じ判定)
+			bool isInside = true;
+			for (int i = 0; i < 3; ++i)
+			{
+				const Vector3& start = triangle.vertices[i];
+				const Vector3& end = triangle.vertices[(i + 1) % 3];
+				isInside = isInside && Dot(Cross(end - start, planeHit.point - start), normal) >= 0.0f;
+			}
+			if (isInside)
+			{
+				hit = planeHit;
+				return true;
+			}
+		}
+
+		// 外側なら3辺のカプセルと判定する
+		float bestT = FLT_MAX;
+		for (int i = 0; i < 3; ++i)
+		{
+			float t;
+			if (IntersectMovingPointCapsule(sphere.center, motion, triangle.vertices[i], triangle.vertices[(i + 1) % 3], sphere.radius, t))
+			{
+				bestT = std::min(bestT, t);
+			}
+		}
+		if (bestT > 1.0f)
+		{
+			return false;
+		}
+
+		Vector3 center = sphere.center + motion * bestT;
+		MakeHit(center, ClosestPoint(center, triangle), normal, bestT, hit);
+		return true;
+	}
+}
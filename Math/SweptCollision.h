@@ -0,0 +1,31 @@
+#pragma once
+#include "AABB.h"
+#include "CachedOBB.h"
+#include "OBB.h"
+#include "Plane.h"
+#include "Sphereh.h"
+#include "Triangle.h"
+#include "Vector3.h"
+
+namespace Math
+{
+	/// <summary>
+	/// 移動する球が最初に当たる時刻と位置
+	/// </summary>
+	struct SweepHit final
+	{
+		float t;		//!<当たった時刻。0が移動前、1が移動後
+		Vector3 point;	//!<当たった位置(形状の表面上)
+		Vector3 normal;	//!<当たった面の法線(形状から球へ向かう向き)
+	};
+
+	/*----------移動する球の衝突判定(連続衝突判定)----------*/
+	// sphereをmotionだけ動かしたとき、途中で最初に当たる時刻を求める
+	// 動き始めですでに当たっているときはt = 0を返す
+	// 移動量の大きなボールがすり抜けないように、1ステップの移動全体を判定する
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const Plane& plane, SweepHit& hit);
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const AABB& aabb, SweepHit& hit);
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const CachedOBB& obb, SweepHit& hit);
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const OBB& obb, SweepHit& hit);
+	bool SweepSphere(const Sphere& sphere, const Vector3& motion, const Triangle& triangle, SweepHit& hit);
+}
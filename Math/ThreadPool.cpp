@@ -0,0 +1,124 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace Math
+{
+	ThreadPool::ThreadPool(uint32_t threadCount)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		// 呼び出し元も働くので、作るのは1つ少なくてよい
+		workers_.reserve(threadCount - 1);
+		for (uint32_t i = 1; i < threadCount; ++i)
+		{
+			workers_.emplace_back([this] { WorkerLoop(); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		wake_.notify_all();
+		for (std::thread& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& body)
+	{
+		grainSize = std::max<size_t>(grainSize, 1);
+		if (count == 0)
+		{
+			return;
+		}
+
+		// 1回分に収まるならスレッドを起こさない
+		if (workers_.empty() || count <= grainSize)
+		{
+			body(0, count);
+			return;
+		}
+
+		std::lock_guard<std::mutex> submitLock(submitMutex_);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			body_ = &body;
+			count_ = count;
+			grainSize_ = grainSize;
+			next_.store(0);
+			++generation_;
+		}
+		wake_.notify_all();
+
+		RunChunks(body, count, grainSize);
+
+		// 仕事を取ったワーカーがすべて抜けるまで待つ。以降はbodyに触れさせない
+		std::unique_lock<std::mutex> lock(mutex_);
+		done_.wait(lock, [this] { return active_ == 0; });
+		body_ = nullptr;
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		uint64_t seenGeneration = 0;
+		for (;;)
+		{
+			const std::function<void(size_t, size_t)>* body = nullptr;
+			size_t count = 0;
+			size_t grainSize = 1;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				wake_.wait(lock, [&] { return stop_ || (body_ != nullptr && generation_ != seenGeneration); });
+				if (stop_)
+				{
+					return;
+				}
+				seenGeneration = generation_;
+				body = body_;
+				count = count_;
+				grainSize = grainSize_;
+				++active_;
+			}
+
+			RunChunks(*body, count, grainSize);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				--active_;
+			}
+			done_.notify_all();
+		}
+	}
+
+	void ThreadPool::RunChunks(const std::function<void(size_t, size_t)>& body, size_t count, size_t grainSize)
+	{
+		for (;;)
+		{
+			size_t begin = next_.fetch_add(grainSize);
+			if (begin >= count)
+			{
+				return;
+			}
+			body(begin, std::min(begin + grainSize, count));
+		}
+	}
+
+	void ParallelFor(ThreadPool* pool, size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& body)
+	{
+		if (pool)
+		{
+			pool->ParallelFor(count, grainSize, body);
+		}
+		else if (count > 0)
+		{
+			body(0, count);
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Math
+{
+	/// <summary>
+	/// ParallelFor専用のスレッドプール
+	/// 呼び出し元のスレッドも処理に参加する
+	/// </summary>
+	class ThreadPool final
+	{
+	public:
+		/// <param name="threadCount">呼び出し元を含めたスレッド数。0ならハードウェアのスレッド数</param>
+		explicit ThreadPool(uint32_t threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// [0, count)をgrainSize個ずつに分けてbody(begin, end)を並列に呼び出し、すべて終わるまで待つ
+		void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& body);
+
+		uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()) + 1; }
+
+	private:
+		void WorkerLoop();
+		void RunChunks(const std::function<void(size_t, size_t)>& body, size_t count, size_t grainSize);
+
+		std::vector<std::thread> workers_;
+		std::mutex submitMutex_;	// ParallelForの同時呼び出しを直列にする
+
+		// 以下はmutex_で守る
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable done_;
+		const std::function<void(size_t, size_t)>* body_ = nullptr;
+		size_t count_ = 0;
+		size_t grainSize_ = 1;
+		uint64_t generation_ = 0;
+		uint32_t active_ = 0;
+		bool stop_ = false;
+
+		std::atomic<size_t> next_ = 0;
+	};
+
+	// poolがnullptrなら呼び出し元のスレッドだけで処理する
+	void ParallelFor(ThreadPool* pool, size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& body);
+}
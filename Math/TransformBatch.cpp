@@ -0,0 +1,125 @@
+#include "TransformBatch.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+#include <cassert>
+
+namespace Math
+{
+	namespace
+	{
+		static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3はfloat3つが並んでいる前提");
+
+		// これより少なければ並列化しない
+		const size_t kParallelThreshold = 1 << 15;
+		const size_t kGrainSize = 1 << 14;
+
+		// 行列の要素をレーン数分に広げたもの
+		template <class S>
+		struct BroadcastMatrix final
+		{
+			typename S::Float m[4][4];
+
+			explicit BroadcastMatrix(const Matrix4x4& matrix)
+			{
+				for (int i = 0; i < 4; ++i)
+				{
+					for (int j = 0; j < 4; ++j)
+					{
+						m[i][j] = S::Set(matrix.m[i][j]);
+					}
+				}
+			}
+		};
+
+		// Transformと同じ演算順で変換する
+		template <class S>
+		void TransformLanes(const BroadcastMatrix<S>& m, TransformMode mode, typename S::Float x, typename S::Float y, typename S::Float z,
+			typename S::Float& outX, typename S::Float& outY, typename S::Float& outZ)
+		{
+			auto column = [&](int j)
+			{
+				return S::Add(S::Add(S::Add(S::Mul(x, m.m[0][j]), S::Mul(y, m.m[1][j])), S::Mul(z, m.m[2][j])), m.m[3][j]);
+			};
+			outX = column(0);
+			outY = column(1);
+			outZ = column(2);
+			if (mode == TransformMode::Perspective)
+			{
+				typename S::Float w = column(3);
+				outX = S::Div(outX, w);
+				outY = S::Div(outY, w);
+				outZ = S::Div(outZ, w);
+			}
+		}
+
+		void TransformSoARange(const Vector3SoA& points, const Matrix4x4& matrix, const Vector3SoAOutput& result, TransformMode mode, size_t begin, size_t end)
+		{
+			size_t i = begin;
+			auto run = [&]<class S>()
+			{
+				const BroadcastMatrix<S> m(matrix);
+				for (; i + S::kWidth <= end; i += S::kWidth)
+				{
+					typename S::Float x, y, z;
+					TransformLanes<S>(m, mode, S::Load(&points.x[i]), S::Load(&points.y[i]), S::Load(&points.z[i]), x, y, z);
+					S::Store(&result.x[i], x);
+					S::Store(&result.y[i], y);
+					S::Store(&result.z[i], z);
+				}
+			};
+#if defined(MATH_SIMD_AVX2)
+			run.template operator()<Simd::Avx2>();
+#endif
+#if defined(MATH_SIMD_SSE2)
+			run.template operator()<Simd::Sse>();
+#endif
+			run.template operator()<Simd::Scalar>();
+		}
+
+		void TransformAoSRange(std::span<const Vector3> points, const Matrix4x4& matrix, std::span<Vector3> result, TransformMode mode, size_t begin, size_t end)
+		{
+			size_t i = begin;
+#if defined(MATH_SIMD_SSE2)
+			// 4点ずつx, y, zに並べ替えて変換してから戻す
+			using S = Simd::Sse;
+			const BroadcastMatrix<S> m(matrix);
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128 x, y, z;
+				Simd::LoadVector3x4(&points[i].x, x, y, z);
+				__m128 rx, ry, rz;
+				TransformLanes<S>(m, mode, x, y, z, rx, ry, rz);
+				Simd::StoreVector3x4(&result[i].x, rx, ry, rz);
+			}
+#endif
+			using Scalar = Simd::Scalar;
+			const BroadcastMatrix<Scalar> ms(matrix);
+			for (; i < end; ++i)
+			{
+				TransformLanes<Scalar>(ms, mode, points[i].x, points[i].y, points[i].z, result[i].x, result[i].y, result[i].z);
+			}
+		}
+	}
+
+	void TransformPoints(std::span<const Vector3> points, const Matrix4x4& matrix, std::span<Vector3> result, TransformMode mode, ThreadPool* threadPool)
+	{
+		assert(result.size() >= points.size());
+		if (threadPool && points.size() >= kParallelThreshold)
+		{
+			threadPool->ParallelFor(points.size(), kGrainSize, [&](size_t begin, size_t end) { TransformAoSRange(points, matrix, result, mode, begin, end); });
+			return;
+		}
+		TransformAoSRange(points, matrix, result, mode, 0, points.size());
+	}
+
+	void TransformPoints(const Vector3SoA& points, const Matrix4x4& matrix, const Vector3SoAOutput& result, TransformMode mode, ThreadPool* threadPool)
+	{
+		assert(result.x.size() >= points.Count() && result.y.size() >= points.Count() && result.z.size() >= points.Count());
+		if (threadPool && points.Count() >= kParallelThreshold)
+		{
+			threadPool->ParallelFor(points.Count(), kGrainSize, [&](size_t begin, size_t end) { TransformSoARange(points, matrix, result, mode, begin, end); });
+			return;
+		}
+		TransformSoARange(points, matrix, result, mode, 0, points.Count());
+	}
+}
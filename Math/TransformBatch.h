@@ -0,0 +1,48 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <span>
+
+namespace Math
+{
+	class ThreadPool;
+
+	/// <summary>
+	/// 点の変換方法
+	/// </summary>
+	enum class TransformMode
+	{
+		Perspective,	// wで割る (Transformと同じ)
+		Affine,			// 4列目を無視してwで割らない
+	};
+
+	/// <summary>
+	/// 点の配列をSoA形式で参照する
+	/// </summary>
+	struct Vector3SoA final
+	{
+		std::span<const float> x;
+		std::span<const float> y;
+		std::span<const float> z;
+
+		size_t Count() const { return x.size(); }
+	};
+
+	/// <summary>
+	/// 変換結果の書き込み先(SoA形式)
+	/// </summary>
+	struct Vector3SoAOutput final
+	{
+		std::span<float> x;
+		std::span<float> y;
+		std::span<float> z;
+	};
+
+	/*----------点をまとめて変換する関数----------*/
+	// resultはpointsと同じ数以上の要素を持つこと。pointsと同じ配列を渡してもよい
+	// Perspectiveの結果はTransformと一致する。w == 0のチェックはしない
+	// threadPoolを渡すと、点の数が多いときに分割して並列に変換する
+	void TransformPoints(std::span<const Vector3> points, const Matrix4x4& matrix, std::span<Vector3> result, TransformMode mode = TransformMode::Perspective, ThreadPool* threadPool = nullptr);
+	void TransformPoints(const Vector3SoA& points, const Matrix4x4& matrix, const Vector3SoAOutput& result, TransformMode mode = TransformMode::Perspective, ThreadPool* threadPool = nullptr);
+}
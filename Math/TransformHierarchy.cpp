@@ -0,0 +1,164 @@
+#include "TransformHierarchy.h"
+#include "MathFunction.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+
+namespace Math
+{
+	namespace
+	{
+		// ParallelForで1回に処理するノード数
+		const size_t kNodeGrainSize = 1024;
+	}
+
+	TransformHierarchy::TransformHierarchy(ThreadPool* threadPool)
+		: threadPool_(threadPool)
+	{
+	}
+
+	uint32_t TransformHierarchy::AddNode(uint32_t parent, const Vector3& scale, const Quaternion& rotate, const Vector3& translate)
+	{
+		uint32_t index = GetNodeCount();
+		assert(parent == kNoParent || parent < index);
+
+		scale_.push_back(scale);
+		rotate_.push_back(rotate);
+		translate_.push_back(translate);
+		parent_.push_back(parent);
+		depth_.push_back(parent == kNoParent ? 0 : depth_[parent] + 1);
+		worldMatrix_.push_back(MakeIdentity());
+		dirty_.push_back(1);
+
+		isLevelDirty_ = true;
+		hasDirty_ = true;
+		return index;
+	}
+
+	void TransformHierarchy::Reserve(size_t count)
+	{
+		scale_.reserve(count);
+		rotate_.reserve(count);
+		translate_.reserve(count);
+		parent_.reserve(count);
+		depth_.reserve(count);
+		worldMatrix_.reserve(count);
+		dirty_.reserve(count);
+	}
+
+	void TransformHierarchy::Clear()
+	{
+		scale_.clear();
+		rotate_.clear();
+		translate_.clear();
+		parent_.clear();
+		depth_.clear();
+		worldMatrix_.clear();
+		dirty_.clear();
+		order_.clear();
+		levelBegin_.clear();
+		isLevelDirty_ = false;
+		hasDirty_ = false;
+	}
+
+	void TransformHierarchy::SetLocalScale(uint32_t index, const Vector3& scale)
+	{
+		scale_[index] = scale;
+		MarkDirty(index);
+	}
+
+	void TransformHierarchy::SetLocalRotate(uint32_t index, const Quaternion& rotate)
+	{
+		rotate_[index] = rotate;
+		MarkDirty(index);
+	}
+
+	void TransformHierarchy::SetLocalTranslate(uint32_t index, const Vector3& translate)
+	{
+		translate_[index] = translate;
+		MarkDirty(index);
+	}
+
+	void TransformHierarchy::SetLocalTransform(uint32_t index, const Vector3& scale, const Quaternion& rotate, const Vector3& translate)
+	{
+		scale_[index] = scale;
+		rotate_[index] = rotate;
+		translate_[index] = translate;
+		MarkDirty(index);
+	}
+
+	void TransformHierarchy::MarkDirty(uint32_t index)
+	{
+		dirty_[index] = 1;
+		hasDirty_ = true;
+	}
+
+	void TransformHierarchy::Update()
+	{
+		// 何も変わっていなければ配列を走査もしない
+		if (!hasDirty_)
+		{
+			return;
+		}
+		if (isLevelDirty_)
+		{
+			BuildLevels();
+		}
+
+		// 深さごとに順番に処理する。親の深さが終わってから子の深さに進むので、同じ深さの中は並列にできる
+		for (size_t depth = 0; depth + 1 < levelBegin_.size(); ++depth)
+		{
+			size_t begin = levelBegin_[depth];
+			size_t count = levelBegin_[depth + 1] - begin;
+			ParallelFor(threadPool_, count, kNodeGrainSize, [this, begin](size_t first, size_t last) { UpdateRange(begin + first, begin + last); });
+		}
+
+		std::fill(dirty_.begin(), dirty_.end(), uint8_t{ 0 });
+		hasDirty_ = false;
+	}
+
+	void TransformHierarchy::BuildLevels()
+	{
+		// 深さで数え上げソートする。同じ深さの中はインデックス順のままにしてメモリアクセスを前から順にする
+		uint32_t maxDepth = depth_.empty() ? 0 : *std::max_element(depth_.begin(), depth_.end());
+		levelBegin_.assign(static_cast<size_t>(maxDepth) + 2, 0);
+		for (uint32_t depth : depth_)
+		{
+			++levelBegin_[depth + 1];
+		}
+		for (size_t i = 1; i < levelBegin_.size(); ++i)
+		{
+			levelBegin_[i] += levelBegin_[i - 1];
+		}
+
+		order_.resize(depth_.size());
+		std::vector<size_t> cursor(levelBegin_.begin(), levelBegin_.end() - 1);
+		for (uint32_t i = 0; i < GetNodeCount(); ++i)
+		{
+			order_[cursor[depth_[i]]++] = i;
+		}
+		isLevelDirty_ = false;
+	}
+
+	void TransformHierarchy::UpdateRange(size_t begin, size_t end)
+	{
+		for (size_t k = begin; k < end; ++k)
+		{
+			uint32_t i = order_[k];
+			uint32_t parent = parent_[i];
+
+			// 親が計算し直されたら子も計算し直す
+			if (parent != kNoParent && dirty_[parent])
+			{
+				dirty_[i] = 1;
+			}
+			if (!dirty_[i])
+			{
+				continue;
+			}
+
+			Matrix4x4 localMatrix = MakeAffineMatrix(scale_[i], rotate_[i], translate_[i]);
+			worldMatrix_[i] = parent == kNoParent ? localMatrix : Multiply(localMatrix, worldMatrix_[parent]);
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Math
+{
+	class ThreadPool;
+
+	/// <summary>
+	/// 親子関係のあるトランスフォームをまとめて管理する
+	/// ノードはインデックスで扱い、ローカルの拡縮・回転・平行移動とワールド行列をそれぞれ連続した配列で持つ
+	/// 親は必ず子より前に追加されるので、配列の順に計算すれば親のワールド行列が先に決まる
+	/// </summary>
+	class TransformHierarchy final
+	{
+	public:
+		// 親がいないことを表すインデックス
+		static constexpr uint32_t kNoParent = UINT32_MAX;
+
+		/// <param name="threadPool">並列化に使うスレッドプール。nullptrなら単一スレッド</param>
+		explicit TransformHierarchy(ThreadPool* threadPool = nullptr);
+
+		// parentはすでに追加したノードか、kNoParent
+		uint32_t AddNode(uint32_t parent, const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+		void Reserve(size_t count);
+		void Clear();
+
+		// ローカルの値を変えると、そのノードと子孫が次のUpdateで計算し直される
+		void SetLocalScale(uint32_t index, const Vector3& scale);
+		void SetLocalRotate(uint32_t index, const Quaternion& rotate);
+		void SetLocalTranslate(uint32_t index, const Vector3& translate);
+		void SetLocalTransform(uint32_t index, const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+
+		const Vector3& GetLocalScale(uint32_t index) const { return scale_[index]; }
+		const Quaternion& GetLocalRotate(uint32_t index) const { return rotate_[index]; }
+		const Vector3& GetLocalTranslate(uint32_t index) const { return translate_[index]; }
+		uint32_t GetParent(uint32_t index) const { return parent_[index]; }
+		uint32_t GetNodeCount() const { return static_cast<uint32_t>(parent_.size()); }
+
+		// 変更のあったノードとその子孫のワールド行列だけを計算し直す
+		void Update();
+
+		// Updateのあとの値
+		const Matrix4x4& GetWorldMatrix(uint32_t index) const { return worldMatrix_[index]; }
+		std::span<const Matrix4x4> GetWorldMatrices() const { return worldMatrix_; }
+
+	private:
+		void MarkDirty(uint32_t index);
+		// ノードを深さごとに並べ直す
+		void BuildLevels();
+		// order_の[begin, end)のノードを計算する。同じ深さのノードどうしは依存しないので並列に呼べる
+		void UpdateRange(size_t begin, size_t end);
+
+		ThreadPool* threadPool_;
+
+		std::vector<Vector3> scale_;
+		std::vector<Quaternion> rotate_;
+		std::vector<Vector3> translate_;
+		std::vector<uint32_t> parent_;
+		std::vector<uint32_t> depth_;
+		std::vector<Matrix4x4> worldMatrix_;
+		// 0か1。Updateの中で親の値を引き継ぐので、計算し直したノードが1になる
+		std::vector<uint8_t> dirty_;
+
+		std::vector<uint32_t> order_;		// 深さの浅い順に並べたノードのインデックス
+		std::vector<size_t> levelBegin_;	// 深さdのノードはorder_の[levelBegin_[d], levelBegin_[d + 1])
+		bool isLevelDirty_ = false;
+		bool hasDirty_ = false;
+	};
+}
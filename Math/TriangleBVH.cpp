@@ -0,0 +1,510 @@
+#include "TriangleBVH.h"
+#include "MathFunction.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Math
+{
+	namespace
+	{
+		// SAHで分割位置を探すときのビンの数
+		const uint32_t kBinCount = 16;
+		// この深さより下ではSAHを使わず中央で分割する(木の高さをスタックの大きさに収めるため)
+		const uint32_t kMaxSAHDepth = 32;
+		// ノードをたどるコスト(三角形1つの判定を1としたとき)
+		const float kTraversalCost = 1.0f;
+		// 行列式がこれより小さければレイと三角形が平行とみなす
+		const float kDeterminantEpsilon = 1e-12f;
+		// まとめてレイキャストするときの1回分のレイの数
+		const size_t kRayGrainSize = 256;
+
+		// レイの始点と方向をレーン数分に広げたもの
+		template <class S>
+		struct RayLanes final
+		{
+			typename S::Float origin[3];
+			typename S::Float direction[3];
+
+			explicit RayLanes(const Ray& ray)
+			{
+				origin[0] = S::Set(ray.origin.x);
+				origin[1] = S::Set(ray.origin.y);
+				origin[2] = S::Set(ray.origin.z);
+				direction[0] = S::Set(ray.diff.x);
+				direction[1] = S::Set(ray.diff.y);
+				direction[2] = S::Set(ray.diff.z);
+			}
+		};
+
+		template <class S>
+		void CrossLanes(const typename S::Float a[3], const typename S::Float b[3], typename S::Float result[3])
+		{
+			result[0] = S::Sub(S::Mul(a[1], b[2]), S::Mul(a[2], b[1]));
+			result[1] = S::Sub(S::Mul(a[2], b[0]), S::Mul(a[0], b[2]));
+			result[2] = S::Sub(S::Mul(a[0], b[1]), S::Mul(a[1], b[0]));
+		}
+
+		template <class S>
+		typename S::Float DotLanes(const typename S::Float a[3], const typename S::Float b[3])
+		{
+			return S::Add(S::Add(S::Mul(a[0], b[0]), S::Mul(a[1], b[1])), S::Mul(a[2], b[2]));
+		}
+
+		// 1本のレイとレーン数分の三角形のMoller-Trumbore判定
+		// maxTより手前で当たったレーンのマスクを返す
+		template <class S>
+		typename S::Mask IntersectLanes(const RayLanes<S>& ray, const typename S::Float vertex0[3], const typename S::Float edge1[3], const typename S::Float edge2[3],
+			typename S::Float maxT, typename S::Float& t, typename S::Float& u, typename S::Float& v)
+		{
+			const typename S::Float zero = S::Set(0.0f);
+			const typename S::Float one = S::Set(1.0f);
+
+			typename S::Float p[3];
+			CrossLanes<S>(ray.direction, edge2, p);
+			typename S::Float determinant = DotLanes<S>(edge1, p);
+			typename S::Mask valid = S::CmpLt(S::Set(kDeterminantEpsilon), S::Abs(determinant));
+			typename S::Float inverseDeterminant = S::Div(one, determinant);
+
+			typename S::Float s[3] = { S::Sub(ray.origin[0], vertex0[0]), S::Sub(ray.origin[1], vertex0[1]), S::Sub(ray.origin[2], vertex0[2]) };
+			u = S::Mul(DotLanes<S>(s, p), inverseDeterminant);
+			valid = S::And(valid, S::And(S::CmpLe(zero, u), S::CmpLe(u, one)));
+
+			typename S::Float q[3];
+			CrossLanes<S>(s, edge1, q);
+			v = S::Mul(DotLanes<S>(ray.direction, q), inverseDeterminant);
+			valid = S::And(valid, S::And(S::CmpLe(zero, v), S::CmpLe(S::Add(u, v), one)));
+
+			t = S::Mul(DotLanes<S>(edge2, q), inverseDeterminant);
+			return S::And(valid, S::And(S::CmpLe(zero, t), S::CmpLt(t, maxT)));
+		}
+
+		// 1つの軸のスラブで[tMin, tMax]を狭める。スラブと重ならないことが分かればfalseを返す
+		// 方向が0の軸では、始点がちょうど面の上にあると(min - origin) * inf = 0 * inf = NaNになり、
+		// std::min/maxがNaNを通してノードを見落とすので、始点がスラブの中にあるかだけで決める
+		bool ClipSlab(float min, float max, float origin, float inverseDirection, float& tMin, float& tMax)
+		{
+			if (std::isinf(inverseDirection))
+			{
+				return min <= origin && origin <= max;
+			}
+			float t1 = (min - origin) * inverseDirection;
+			float t2 = (max - origin) * inverseDirection;
+			tMin = std::max(tMin, std::min(t1, t2));
+			tMax = std::min(tMax, std::max(t1, t2));
+			return true;
+		}
+
+		// レイとAABBの判定(スラブ法)。当たればAABBに入る位置をtNearに入れる
+		bool IntersectAABB(const AABB& aabb, const Vector3& origin, const Vector3& inverseDirection, float maxT, float& tNear)
+		{
+			float tMin = -FLT_MAX;
+			float tMax = FLT_MAX;
+			if (!ClipSlab(aabb.min.x, aabb.max.x, origin.x, inverseDirection.x, tMin, tMax) ||
+				!ClipSlab(aabb.min.y, aabb.max.y, origin.y, inverseDirection.y, tMin, tMax) ||
+				!ClipSlab(aabb.min.z, aabb.max.z, origin.z, inverseDirection.z, tMin, tMax))
+			{
+				return false;
+			}
+
+			// 逆数の丸めでtNearは1ulpほど奥になることがあるので、今の交点と同じ距離のノードも調べる
+			tNear = std::max(tMin, 0.0f);
+			return tNear <= tMax && tNear <= maxT;
+		}
+
+		AABB MakeEmptyAABB()
+		{
+			return { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+		}
+
+		// aabbをotherを含むように広げる
+		void Grow(AABB& aabb, const AABB& other)
+		{
+			aabb.min.x = std::min(aabb.min.x, other.min.x);
+			aabb.min.y = std::min(aabb.min.y, other.min.y);
+			aabb.min.z = std::min(aabb.min.z, other.min.z);
+			aabb.max.x = std::max(aabb.max.x, other.max.x);
+			aabb.max.y = std::max(aabb.max.y, other.max.y);
+			aabb.max.z = std::max(aabb.max.z, other.max.z);
+		}
+
+		void Grow(AABB& aabb, const Vector3& point)
+		{
+			Grow(aabb, AABB{ point, point });
+		}
+
+		float GetComponent(const Vector3& v, int axis)
+		{
+			return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+		}
+	}
+
+	bool RayCast(const Ray& ray, const Triangle& triangle, RayHit& hit, float maxT)
+	{
+		using S = Simd::Scalar;
+		const RayLanes<S> lanes(ray);
+		const float vertex0[3] = { triangle.vertices[0].x, triangle.vertices[0].y, triangle.vertices[0].z };
+		const float edge1[3] = { triangle.vertices[1].x - vertex0[0], triangle.vertices[1].y - vertex0[1], triangle.vertices[1].z - vertex0[2] };
+		const float edge2[3] = { triangle.vertices[2].x - vertex0[0], triangle.vertices[2].y - vertex0[1], triangle.vertices[2].z - vertex0[2] };
+
+		float t, u, v;
+		if (!IntersectLanes<S>(lanes, vertex0, edge1, edge2, std::min(maxT, hit.t), t, u, v))
+		{
+			return false;
+		}
+		hit.t = t;
+		hit.u = u;
+		hit.v = v;
+		hit.triangleIndex = 0;
+		return true;
+	}
+
+	void TriangleBVH::Build(std::span<const Triangle> triangles)
+	{
+		Clear();
+		if (triangles.empty())
+		{
+			return;
+		}
+		assert(triangles.size() < UINT32_MAX);
+
+		std::vector<BuildItem> items(triangles.size());
+		for (size_t i = 0; i < triangles.size(); ++i)
+		{
+			items[i].aabb = MakeAABB(triangles[i]);
+			items[i].centroid = (items[i].aabb.min + items[i].aabb.max) * 0.5f;
+			items[i].index = static_cast<uint32_t>(i);
+		}
+
+		// 二分木なのでノードは三角形の2倍より少ない
+		nodes_.reserve(triangles.size() * 2);
+		triangleIndices_.reserve(triangles.size());
+		BuildNode(items, 0, static_cast<uint32_t>(items.size()), 0);
+
+		// 葉の順に三角形を並べ替えてSoA形式にする
+		for (int c = 0; c < 3; ++c)
+		{
+			vertex0_[c].resize(triangleIndices_.size());
+			edge1_[c].resize(triangleIndices_.size());
+			edge2_[c].resize(triangleIndices_.size());
+		}
+		for (size_t i = 0; i < triangleIndices_.size(); ++i)
+		{
+			const Triangle& triangle = triangles[triangleIndices_[i]];
+			Vector3 edge1 = triangle.vertices[1] - triangle.vertices[0];
+			Vector3 edge2 = triangle.vertices[2] - triangle.vertices[0];
+			for (int c = 0; c < 3; ++c)
+			{
+				vertex0_[c][i] = GetComponent(triangle.vertices[0], c);
+				edge1_[c][i] = GetComponent(edge1, c);
+				edge2_[c][i] = GetComponent(edge2, c);
+			}
+		}
+	}
+
+	void TriangleBVH::Clear()
+	{
+		nodes_.clear();
+		triangleIndices_.clear();
+		for (int c = 0; c < 3; ++c)
+		{
+			vertex0_[c].clear();
+			edge1_[c].clear();
+			edge2_[c].clear();
+		}
+	}
+
+	const AABB& TriangleBVH::GetBounds() const
+	{
+		assert(!nodes_.empty());
+		return nodes_[0].aabb;
+	}
+
+	uint32_t TriangleBVH::BuildNode(std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t depth)
+	{
+		uint32_t nodeIndex = static_cast<uint32_t>(nodes_.size());
+		nodes_.push_back({});
+
+		AABB aabb = MakeEmptyAABB();
+		AABB centroidBounds = MakeEmptyAABB();
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			Grow(aabb, items[i].aabb);
+			Grow(centroidBounds, items[i].centroid);
+		}
+		nodes_[nodeIndex].aabb = aabb;
+
+		auto makeLeaf = [&]()
+		{
+			nodes_[nodeIndex].offset = static_cast<uint32_t>(triangleIndices_.size());
+			nodes_[nodeIndex].count = end - begin;
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				triangleIndices_.push_back(items[i].index);
+			}
+			return nodeIndex;
+		};
+
+		uint32_t count = end - begin;
+		if (count == 1)
+		{
+			return makeLeaf();
+		}
+
+		// ビンに分けて、各軸の各境界で分割したときのSAHコストを比べる
+		int bestAxis = -1;
+		uint32_t bestSplit = 0;
+		float bestCost = FLT_MAX;
+		Vector3 extent = centroidBounds.max - centroidBounds.min;
+		if (depth < kMaxSAHDepth)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				float axisMin = GetComponent(centroidBounds.min, axis);
+				float axisExtent = GetComponent(extent, axis);
+				if (axisExtent <= 0.0f)
+				{
+					continue;
+				}
+
+				AABB binAABB[kBinCount];
+				uint32_t binCount[kBinCount] = {};
+				std::fill(std::begin(binAABB), std::end(binAABB), MakeEmptyAABB());
+				float scale = static_cast<float>(kBinCount) / axisExtent;
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					uint32_t bin = std::min(kBinCount - 1, static_cast<uint32_t>((GetComponent(items[i].centroid, axis) - axisMin) * scale));
+					Grow(binAABB[bin], items[i].aabb);
+					++binCount[bin];
+				}
+
+				// 右側から累積した面積と数
+				float rightArea[kBinCount];
+				uint32_t rightCount[kBinCount];
+				AABB rightAABB = MakeEmptyAABB();
+				uint32_t rightSum = 0;
+				for (uint32_t bin = kBinCount - 1; bin > 0; --bin)
+				{
+					Grow(rightAABB, binAABB[bin]);
+					rightSum += binCount[bin];
+					rightArea[bin] = rightSum ? SurfaceArea(rightAABB) : 0.0f;
+					rightCount[bin] = rightSum;
+				}
+
+				AABB leftAABB = MakeEmptyAABB();
+				uint32_t leftSum = 0;
+				for (uint32_t split = 1; split < kBinCount; ++split)
+				{
+					Grow(leftAABB, binAABB[split - 1]);
+					leftSum += binCount[split - 1];
+					if (leftSum == 0 || rightCount[split] == 0)
+					{
+						continue;
+					}
+					float cost = SurfaceArea(leftAABB) * static_cast<float>(leftSum) + rightArea[split] * static_cast<float>(rightCount[split]);
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						bestAxis = axis;
+						bestSplit = split;
+					}
+				}
+			}
+		}
+
+		uint32_t middle = begin;
+		float parentArea = SurfaceArea(aabb);
+		if (bestAxis >= 0 && (count > kMaxLeafSize || kTraversalCost + bestCost / parentArea < static_cast<float>(count)))
+		{
+			// SAHで分割する
+			float axisMin = GetComponent(centroidBounds.min, bestAxis);
+			float scale = static_cast<float>(kBinCount) / GetComponent(extent, bestAxis);
+			BuildItem* split = std::partition(items.data() + begin, items.data() + end, [&](const BuildItem& item)
+			{
+				return std::min(kBinCount - 1, static_cast<uint32_t>((GetComponent(item.centroid, bestAxis) - axisMin) * scale)) < bestSplit;
+			});
+			middle = static_cast<uint32_t>(split - items.data());
+		}
+		else if (count > kMaxLeafSize)
+		{
+			// 重心が重なっているなどでSAHが使えないときは、一番長い軸の中央で分ける
+			int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+			middle = begin + count / 2;
+			std::nth_element(items.data() + begin, items.data() + middle, items.data() + end, [axis](const BuildItem& a, const BuildItem& b)
+			{
+				return GetComponent(a.centroid, axis) < GetComponent(b.centroid, axis);
+			});
+		}
+		else
+		{
+			return makeLeaf();
+		}
+
+		BuildNode(items, begin, middle, depth + 1);
+		uint32_t secondChild = BuildNode(items, middle, end, depth + 1);
+
+		nodes_[nodeIndex].offset = secondChild;
+		nodes_[nodeIndex].count = 0;
+		return nodeIndex;
+	}
+
+	bool TriangleBVH::IntersectLeaf(const Node& node, const Ray& ray, RayHit& hit, bool anyHit) const
+	{
+		bool isHit = false;
+		size_t i = node.offset;
+		const size_t end = static_cast<size_t>(node.offset) + node.count;
+		auto run = [&]<class S>()
+		{
+			const RayLanes<S> lanes(ray);
+			for (; i + S::kWidth <= end; i += S::kWidth)
+			{
+				const typename S::Float vertex0[3] = { S::Load(&vertex0_[0][i]), S::Load(&vertex0_[1][i]), S::Load(&vertex0_[2][i]) };
+				const typename S::Float edge1[3] = { S::Load(&edge1_[0][i]), S::Load(&edge1_[1][i]), S::Load(&edge1_[2][i]) };
+				const typename S::Float edge2[3] = { S::Load(&edge2_[0][i]), S::Load(&edge2_[1][i]), S::Load(&edge2_[2][i]) };
+
+				typename S::Float t, u, v;
+				uint32_t mask = S::MoveMask(IntersectLanes<S>(lanes, vertex0, edge1, edge2, S::Set(hit.t), t, u, v));
+				if (mask == 0)
+				{
+					continue;
+				}
+
+				// 当たったレーンの中から一番手前のものを選ぶ
+				float laneT[S::kWidth], laneU[S::kWidth], laneV[S::kWidth];
+				S::Store(laneT, t);
+				S::Store(laneU, u);
+				S::Store(laneV, v);
+				for (uint32_t lane = 0; lane < S::kWidth; ++lane)
+				{
+					if ((mask >> lane) & 1u && laneT[lane] < hit.t)
+					{
+						hit.t = laneT[lane];
+						hit.u = laneU[lane];
+						hit.v = laneV[lane];
+						hit.triangleIndex = triangleIndices_[i + lane];
+						isHit = true;
+					}
+				}
+				if (anyHit)
+				{
+					return;
+				}
+			}
+		};
+#if defined(MATH_SIMD_AVX2)
+		run.template operator()<Simd::Avx2>();
+#endif
+#if defined(MATH_SIMD_SSE2)
+		if (!(anyHit && isHit))
+		{
+			run.template operator()<Simd::Sse>();
+		}
+#endif
+		if (!(anyHit && isHit))
+		{
+			run.template operator()<Simd::Scalar>();
+		}
+		return isHit;
+	}
+
+	template <bool kAnyHit>
+	bool TriangleBVH::Traverse(const Ray& ray, RayHit& hit) const
+	{
+		if (nodes_.empty())
+		{
+			return false;
+		}
+
+		const Vector3 inverseDirection = { 1.0f / ray.diff.x, 1.0f / ray.diff.y, 1.0f / ray.diff.z };
+		float tNear;
+		if (!IntersectAABB(nodes_[0].aabb, ray.origin, inverseDirection, hit.t, tNear))
+		{
+			return false;
+		}
+
+		bool isHit = false;
+		uint32_t stack[kStackSize];
+		int32_t stackSize = 0;
+		uint32_t nodeIndex = 0;
+		while (true)
+		{
+			const Node& node = nodes_[nodeIndex];
+			if (node.IsLeaf())
+			{
+				if (IntersectLeaf(node, ray, hit, kAnyHit))
+				{
+					isHit = true;
+					if constexpr (kAnyHit)
+					{
+						return true;
+					}
+				}
+			}
+			else
+			{
+				// 手前の子から調べ、奥の子はスタックに積む
+				uint32_t child1 = nodeIndex + 1;
+				uint32_t child2 = node.offset;
+				float tNear1, tNear2;
+				bool isHit1 = IntersectAABB(nodes_[child1].aabb, ray.origin, inverseDirection, hit.t, tNear1);
+				bool isHit2 = IntersectAABB(nodes_[child2].aabb, ray.origin, inverseDirection, hit.t, tNear2);
+				if (isHit1 && isHit2)
+				{
+					if (tNear2 < tNear1)
+					{
+						std::swap(child1, child2);
+					}
+					assert(stackSize < kStackSize);
+					stack[stackSize++] = child2;
+					nodeIndex = child1;
+					continue;
+				}
+				if (isHit1 || isHit2)
+				{
+					nodeIndex = isHit1 ? child1 : child2;
+					continue;
+				}
+			}
+
+			if (stackSize == 0)
+			{
+				break;
+			}
+			nodeIndex = stack[--stackSize];
+		}
+		return isHit;
+	}
+
+	bool TriangleBVH::RayCast(const Ray& ray, RayHit& hit, float maxT) const
+	{
+		hit = RayHit{};
+		hit.t = maxT;
+		if (!Traverse<false>(ray, hit))
+		{
+			hit = RayHit{};
+			return false;
+		}
+		return true;
+	}
+
+	bool TriangleBVH::RayCastAny(const Ray& ray, float maxT) const
+	{
+		RayHit hit;
+		hit.t = maxT;
+		return Traverse<true>(ray, hit);
+	}
+
+	void TriangleBVH::RayCastBatch(std::span<const Ray> rays, std::span<RayHit> hits, float maxT, ThreadPool* threadPool) const
+	{
+		assert(hits.size() >= rays.size());
+		ParallelFor(threadPool, rays.size(), kRayGrainSize, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				RayCast(rays[i], hits[i], maxT);
+			}
+		});
+	}
+}
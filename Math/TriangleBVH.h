@@ -0,0 +1,97 @@
+#pragma once
+#include "AABB.h"
+#include "Ray.h"
+#include "Triangle.h"
+#include <cfloat>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Math
+{
+	class ThreadPool;
+
+	/// <summary>
+	/// レイと三角形の交点
+	/// 交点は ray.origin + ray.diff * t、三角形上では v0 + (v1 - v0) * u + (v2 - v0) * v
+	/// </summary>
+	struct RayHit final
+	{
+		static constexpr uint32_t kNoHit = UINT32_MAX;
+
+		float t = FLT_MAX;					//!<レイの始点からの距離(ray.diffの長さを1とする)
+		float u = 0.0f;						//!<重心座標(v1の重み)
+		float v = 0.0f;						//!<重心座標(v2の重み)
+		uint32_t triangleIndex = kNoHit;	//!<当たった三角形の番号(Buildに渡した配列での番号)
+
+		bool IsHit() const { return triangleIndex != kNoHit; }
+	};
+
+	// レイと三角形1つの交差判定(Moller-Trumbore)。maxTより手前で当たったときだけhitを書き換える
+	// hit.triangleIndexには0が入るので、必要なら呼び出し側で書き換える
+	bool RayCast(const Ray& ray, const Triangle& triangle, RayHit& hit, float maxT = FLT_MAX);
+
+	/// <summary>
+	/// 三角形の配列に対するレイキャスト用のBVH
+	/// 表面積ヒューリスティック(SAH)で分割し、葉の三角形はSIMDでまとめて判定する
+	/// 三角形が動いたらBuildし直す
+	/// </summary>
+	class TriangleBVH final
+	{
+	public:
+		static constexpr uint32_t kMaxLeafSize = 8;	// 葉に入れる三角形の最大数
+		static constexpr int32_t kStackSize = 64;	// 探索用スタックの大きさ(木の高さより十分大きい)
+
+		void Build(std::span<const Triangle> triangles);
+		void Clear();
+
+		// 一番手前の交点を求める。maxTより奥の交点は無視する
+		bool RayCast(const Ray& ray, RayHit& hit, float maxT = FLT_MAX) const;
+
+		// 当たるものがあるかだけを調べる(視線の判定用)。見つかった時点で抜ける
+		bool RayCastAny(const Ray& ray, float maxT = FLT_MAX) const;
+
+		// まとめてレイキャストする。当たらなかったレイはhits[i].IsHit()がfalseになる
+		// threadPoolを渡すと、レイの数が多いときに分割して並列に処理する
+		void RayCastBatch(std::span<const Ray> rays, std::span<RayHit> hits, float maxT = FLT_MAX, ThreadPool* threadPool = nullptr) const;
+
+		size_t GetTriangleCount() const { return triangleIndices_.size(); }
+		size_t GetNodeCount() const { return nodes_.size(); }
+		const AABB& GetBounds() const;
+
+	private:
+		struct Node final
+		{
+			AABB aabb;
+			uint32_t offset;	// 葉なら最初の三角形、内部ノードなら2つ目の子(1つ目の子は直後に並ぶ)
+			uint32_t count;		// 葉の三角形の数。内部ノードは0
+
+			bool IsLeaf() const { return count != 0; }
+		};
+
+		// ビルド中の三角形の情報
+		struct BuildItem final
+		{
+			AABB aabb;
+			Vector3 centroid;
+			uint32_t index;
+		};
+
+		// [begin, end)の三角形からノードを作り、その番号を返す
+		uint32_t BuildNode(std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t depth);
+
+		// 葉の三角形とレイの交差判定。anyHitなら最初に見つかった時点で抜ける
+		bool IntersectLeaf(const Node& node, const Ray& ray, RayHit& hit, bool anyHit) const;
+
+		template <bool kAnyHit>
+		bool Traverse(const Ray& ray, RayHit& hit) const;
+
+		std::vector<Node> nodes_;
+		// 葉の順に並べた三角形の元の番号
+		std::vector<uint32_t> triangleIndices_;
+		// 葉の順に並べた三角形(SoA形式)。v0と2辺を持つ
+		std::vector<float> vertex0_[3];
+		std::vector<float> edge1_[3];
+		std::vector<float> edge2_[3];
+	};
+}
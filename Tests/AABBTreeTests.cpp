@@ -0,0 +1,174 @@
+#include "AABBTree.h"
+#include "TestHarness.h"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// AABBTree::Restoreが壊れた木を読み込まないこと、高い木でも探索できることを確かめる
+
+using namespace Math;
+
+namespace
+{
+	using Node = AABBTree::Node;
+	constexpr int32_t kNull = AABBTree::kNullNode;
+
+	AABB MakeBox(float x)
+	{
+		return { { x, 0.0f, 0.0f }, { x + 1.0f, 1.0f, 1.0f } };
+	}
+
+	Node MakeLeaf(int32_t parent, float x)
+	{
+		Node node;
+		node.aabb = MakeBox(x);
+		node.parent = parent;
+		node.height = 0;
+		return node;
+	}
+
+	Node MakeInternal(int32_t parent, int32_t child1, int32_t child2, int32_t height)
+	{
+		Node node;
+		node.aabb = { { -1000.0f, -1000.0f, -1000.0f }, { 1000.0f, 1000.0f, 1000.0f } };
+		node.parent = parent;
+		node.child1 = child1;
+		node.child2 = child2;
+		node.height = height;
+		return node;
+	}
+
+	Node MakeFree(int32_t next)
+	{
+		Node node;
+		node.parent = next;
+		return node;
+	}
+
+	// 根(0)の下に葉が2つ(1, 2)、空きノードが1つ(3)
+	std::vector<Node> MakeSmallTree()
+	{
+		return { MakeInternal(kNull, 1, 2, 1), MakeLeaf(0, 0.0f), MakeLeaf(0, 0.5f), MakeFree(kNull) };
+	}
+
+	void AABBTree_RestoreRoundTrip()
+	{
+		AABBTree tree(0.1f);
+		std::vector<int32_t> proxies;
+		for (int i = 0; i < 64; ++i) {
+			proxies.push_back(tree.CreateProxy(MakeBox(static_cast<float>(i) * 0.5f), static_cast<uint32_t>(i)));
+		}
+		// 空きリストもできるように一部を消す
+		for (int i = 0; i < 64; i += 3) {
+			tree.DestroyProxy(proxies[i]);
+		}
+
+		AABBTree restored;
+		TEST_CHECK(restored.Restore(tree.GetNodes(), tree.GetRoot(), tree.GetFreeList(), tree.GetProxyCount(), tree.GetMargin()));
+
+		std::vector<std::pair<int32_t, int32_t>> expected;
+		std::vector<std::pair<int32_t, int32_t>> actual;
+		tree.QueryPairs(expected);
+		restored.QueryPairs(actual);
+		std::sort(expected.begin(), expected.end());
+		std::sort(actual.begin(), actual.end());
+		TEST_CHECK(!expected.empty() && actual == expected);
+
+		// 空の木も復元できる
+		AABBTree empty;
+		TEST_CHECK(restored.Restore(empty.GetNodes(), empty.GetRoot(), empty.GetFreeList(), empty.GetProxyCount(), empty.GetMargin()));
+		TEST_CHECK(restored.GetProxyCount() == 0);
+	}
+	TEST(AABBTree_RestoreRoundTrip);
+
+	void AABBTree_RestoreRejectsBrokenTrees()
+	{
+		AABBTree tree;
+		std::vector<Node> nodes = MakeSmallTree();
+		TEST_CHECK(tree.Restore(nodes, 0, 3, 2, 0.1f));
+
+		// 子が自分自身を指す(循環)
+		nodes = MakeSmallTree();
+		nodes[0].child1 = 0;
+		TEST_CHECK(!tree.Restore(nodes, 0, 3, 2, 0.1f));
+
+		// 同じ葉を2回指す
+		nodes = MakeSmallTree();
+		nodes[0].child2 = 1;
+		TEST_CHECK(!tree.Restore(nodes, 0, 3, 2, 0.1f));
+
+		// 子の親が合わない
+		nodes = MakeSmallTree();
+		nodes[2].parent = 1;
+		TEST_CHECK(!tree.Restore(nodes, 0, 3, 2, 0.1f));
+
+		// 高さが子と合わない
+		nodes = MakeSmallTree();
+		nodes[0].height = 5;
+		TEST_CHECK(!tree.Restore(nodes, 0, 3, 2, 0.1f));
+
+		// 根に親がある
+		nodes = MakeSmallTree();
+		nodes[0].parent = 3;
+		TEST_CHECK(!tree.Restore(nodes, 0, 3, 2, 0.1f));
+
+		// 空きリストが循環する
+		nodes = MakeSmallTree();
+		nodes[3].parent = 3;
+		TEST_CHECK(!tree.Restore(nodes, 0, 3, 2, 0.1f));
+
+		// 空きリストが木の中のノードを指す
+		nodes = MakeSmallTree();
+		nodes[3].parent = 1;
+		TEST_CHECK(!tree.Restore(nodes, 0, 3, 2, 0.1f));
+
+		// どこからもたどれないノードがある(QueryPairsが葉として扱ってしまう)
+		nodes = MakeSmallTree();
+		TEST_CHECK(!tree.Restore(nodes, 0, kNull, 2, 0.1f));
+
+		// 葉の数が合わない
+		nodes = MakeSmallTree();
+		TEST_CHECK(!tree.Restore(nodes, 0, 3, 3, 0.1f));
+
+		// 番号が範囲外
+		nodes = MakeSmallTree();
+		nodes[0].child2 = 100;
+		TEST_CHECK(!tree.Restore(nodes, 0, 3, 2, 0.1f));
+		TEST_CHECK(!tree.Restore(MakeSmallTree(), 4, 3, 2, 0.1f));
+
+		// 失敗しても前に読み込んだ木はそのまま
+		TEST_CHECK(tree.GetProxyCount() == 2 && tree.GetRoot() == 0);
+	}
+	TEST(AABBTree_RestoreRejectsBrokenTrees);
+
+	void AABBTree_QueryDeepTree()
+	{
+		// 片側にだけ伸びた、高さがkStackSizeを超える木を作る
+		// 内部ノードiの子は葉(leafCount + i)と次の内部ノードなので、探索中のスタックに葉が溜まっていく
+		const int32_t leafCount = AABBTree::kStackSize + 64;
+		const int32_t internalCount = leafCount - 1;
+		std::vector<Node> nodes(internalCount + leafCount);
+		for (int32_t i = 0; i < internalCount; ++i) {
+			int32_t next = i + 1 < internalCount ? i + 1 : internalCount + leafCount - 1;
+			int32_t parent = i == 0 ? kNull : i - 1;
+			nodes[i] = MakeInternal(parent, internalCount + i, next, internalCount - i);
+			nodes[internalCount + i] = MakeLeaf(i, static_cast<float>(i));
+		}
+		nodes[internalCount + leafCount - 1] = MakeLeaf(internalCount - 1, static_cast<float>(leafCount - 1));
+
+		AABBTree tree;
+		TEST_CHECK(tree.Restore(nodes, 0, kNull, leafCount, 0.1f));
+		TEST_CHECK(tree.GetHeight() > AABBTree::kStackSize);
+
+		std::vector<int32_t> result;
+		tree.Query({ { -1.0f, -1.0f, -1.0f }, { static_cast<float>(leafCount) + 1.0f, 2.0f, 2.0f } }, result);
+		TEST_CHECK(static_cast<int32_t>(result.size()) == leafCount);
+
+		// 隣り合う葉だけが接している
+		std::vector<std::pair<int32_t, int32_t>> pairs;
+		tree.QueryPairs(pairs);
+		TEST_CHECK(static_cast<int32_t>(pairs.size()) == leafCount - 1);
+	}
+	TEST(AABBTree_QueryDeepTree);
+}
@@ -0,0 +1,130 @@
+#include "ClipSpaceLines.h"
+#include "DebugDraw.h"
+#include "MathFunction.h"
+#include "TestHarness.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <string>
+#include <vector>
+
+// DrawClippedLinesが近平面・視錐台で線を切り取った結果を、手で求めたスクリーン座標と比べる
+// 内側の端点はそのまま残り、切り取られた端点は面の上に来て、すべて外側の線(カメラの後ろなど)は消えることを確かめる
+
+using namespace Math;
+
+namespace
+{
+	// 画角90度、縦横比1なので、ビュー空間の(x, y, z)はスクリーンの(50 + 50x/z, 50 - 50y/z)に写る
+	constexpr float kNear = 0.1f;
+	constexpr float kFar = 100.0f;
+	constexpr float kScreenSize = 100.0f;
+	// 同じ線を何回か並べて、命令セットの幅(最大8本)ずつ処理する部分と残りの部分を両方通す
+	constexpr int kRepeatCount = 4;
+
+	struct ScreenLine final
+	{
+		float x0, y0, x1, y1;
+	};
+
+	bool IsNear(float a, float b)
+	{
+		return std::abs(a - b) <= 1e-3f * std::max(1.0f, std::abs(b));
+	}
+
+	bool IsSame(const DebugLineVertex& start, const DebugLineVertex& end, const ScreenLine& line)
+	{
+		return IsNear(start.x, line.x0) && IsNear(start.y, line.y0) && IsNear(end.x, line.x1) && IsNear(end.y, line.y1);
+	}
+
+	std::string ToString(const ScreenLine& line)
+	{
+		return "(" + std::to_string(line.x0) + ", " + std::to_string(line.y0) + ") - (" + std::to_string(line.x1) + ", " + std::to_string(line.y1) + ")";
+	}
+
+	// 線をDebugDrawに追加してFlushし、expectedの線がすべて(順番によらず)1回ずつ出てくるかを確かめる
+	template <class Draw>
+	void CheckLines(const std::string& name, const Draw& draw, const std::vector<ScreenLine>& expected)
+	{
+		HeadlessDebugDrawBackend backend;
+		DebugDraw::SetBackend(&backend);
+		size_t lineCount = draw();
+		DebugDraw::Flush();
+		DebugDraw::SetBackend(nullptr);
+
+		const std::vector<DebugLineVertex>& vertices = backend.GetVertices();
+		TEST_CHECK_MESSAGE(lineCount == expected.size() && backend.GetLineCount() == expected.size(),
+			name + ": " + std::to_string(lineCount) + " lines (expected " + std::to_string(expected.size()) + ")");
+		std::vector<bool> isUsed(backend.GetLineCount(), false);
+		for (const ScreenLine& line : expected) {
+			bool isFound = false;
+			for (size_t k = 0; k < isUsed.size() && !isFound; ++k) {
+				if (!isUsed[k] && IsSame(vertices[k * 2], vertices[k * 2 + 1], line)) {
+					isUsed[k] = isFound = true;
+				}
+			}
+			TEST_CHECK_MESSAGE(isFound, name + ": missing " + ToString(line));
+		}
+	}
+
+	void CheckClipping(LineClipMode mode, const std::string& name, const std::vector<Vector3>& lines, const std::vector<ScreenLine>& expected)
+	{
+		const Matrix4x4 worldToClip = MakePerspectiveFovMatrix(std::numbers::pi_v<float> / 2.0f, 1.0f, kNear, kFar);
+		const Matrix4x4 viewport = MakeViewportMatrix(0.0f, 0.0f, kScreenSize, kScreenSize, 0.0f, 1.0f);
+		std::vector<Vector3> lineVertices;
+		std::vector<ScreenLine> expectedLines;
+		for (int i = 0; i < kRepeatCount; ++i) {
+			lineVertices.insert(lineVertices.end(), lines.begin(), lines.end());
+			expectedLines.insert(expectedLines.end(), expected.begin(), expected.end());
+		}
+		CheckLines(name, [&] { return DrawClippedLines(lineVertices, worldToClip, viewport, 0xFFFFFFFF, mode); }, expectedLines);
+
+		// 頂点番号で指定しても同じ線になる
+		std::vector<uint16_t> indices;
+		for (size_t i = 0; i < lineVertices.size(); ++i) {
+			indices.push_back(static_cast<uint16_t>(i));
+		}
+		CheckLines(name + " indexed", [&] { return DrawClippedLines(lineVertices, indices, worldToClip, viewport, 0xFFFFFFFF, mode); }, expectedLines);
+
+		// クリップ空間に変換しておいた線を切り取っても同じになる
+		ClipLineBuffer buffer;
+		AppendLines(lineVertices, worldToClip, buffer);
+		CheckLines(name + " submit", [&] { return SubmitLines(buffer, viewport, 0xFFFFFFFF, mode); }, expectedLines);
+	}
+
+	// 各モードで使う線。カメラは原点から+z方向を向いている
+	const std::vector<Vector3> kLines = {
+		{ -1.0f, -1.0f, 5.0f }, { 1.0f, 1.0f, 5.0f },		// 画面の中
+		{ 0.0f, 2.0f, 10.0f }, { 0.0f, 2.0f, -10.0f },		// 近平面をまたぐ
+		{ 0.0f, 0.0f, -5.0f }, { 1.0f, 1.0f, -1.0f },		// すべてカメラの後ろ
+		{ -20.0f, 0.0f, 10.0f }, { 20.0f, 0.0f, 10.0f },	// 左右の面をまたぐ
+		{ 30.0f, 0.0f, 10.0f }, { 30.0f, 5.0f, 10.0f },		// すべて右の面の外
+		{ 1.0f, 0.0f, 50.0f }, { 1.0f, 0.0f, 200.0f },		// 遠平面をまたぐ
+	};
+
+	void ClipSpaceLines_NearPlane()
+	{
+		// 近平面をまたぐ線の終点は近平面(z = kNear)の上に来る。後ろの線は消える
+		CheckClipping(LineClipMode::Near, "near", kLines, {
+			{ 40.0f, 60.0f, 60.0f, 40.0f },
+			{ 50.0f, 40.0f, 50.0f, 50.0f - 50.0f * 2.0f / kNear },
+			{ -50.0f, 50.0f, 150.0f, 50.0f },
+			{ 200.0f, 50.0f, 200.0f, 25.0f },
+			{ 51.0f, 50.0f, 50.25f, 50.0f },
+		});
+	}
+	TEST(ClipSpaceLines_NearPlane);
+
+	void ClipSpaceLines_Frustum()
+	{
+		// 近平面をまたぐ線は先に上の面(y = z)で切られて画面の上端で終わる
+		// 左右の面をまたぐ線は画面の端で切られ、遠平面をまたぐ線はz = kFarで切られる。右の面の外の線も消える
+		CheckClipping(LineClipMode::Frustum, "frustum", kLines, {
+			{ 40.0f, 60.0f, 60.0f, 40.0f },
+			{ 50.0f, 40.0f, 50.0f, 0.0f },
+			{ 0.0f, 50.0f, 100.0f, 50.0f },
+			{ 51.0f, 50.0f, 50.0f + 50.0f / kFar, 50.0f },
+		});
+	}
+	TEST(ClipSpaceLines_Frustum);
+}
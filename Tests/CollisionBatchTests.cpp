@@ -0,0 +1,392 @@
+#include "CollisionBatch.h"
+#include "Frustum.h"
+#include "MathFunction.h"
+#include "RandomPrimitives.h"
+#include "TestHarness.h"
+#include <cmath>
+#include <span>
+#include <string>
+#include <vector>
+
+// IsCollisionBatchの結果が、要素ごとにIsCollisionを呼んだ結果とビット単位で一致するかを確かめる
+// ランダムな配置に加えて、ちょうど接するように作った配置(丸め方の違いが結果に出やすい)でも比べる
+
+using namespace Math;
+
+namespace
+{
+	constexpr uint32_t kSeed = 2024;
+	// AVX2(8)、SSE2(4)のどちらでも割り切れない数にして、端のスカラー処理も通す
+	constexpr size_t kCount = 4096 + 7;
+
+	float& At(Vector3& v, int axis)
+	{
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+
+	float At(const Vector3& v, int axis)
+	{
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+
+	// hitMaskのi番目とscalar(i)をすべて比べ、違った数と最初の番号を報告する
+	template <class Scalar>
+	void CheckHitMask(const std::string& name, std::span<const uint32_t> hitMask, size_t count, Scalar scalar)
+	{
+		size_t mismatchCount = 0;
+		size_t firstMismatch = 0;
+		size_t hitCount = 0;
+		for (size_t i = 0; i < count; ++i) {
+			bool expected = scalar(i);
+			hitCount += expected ? 1 : 0;
+			if (TestHitMask(hitMask, i) != expected) {
+				firstMismatch = mismatchCount == 0 ? i : firstMismatch;
+				++mismatchCount;
+			}
+		}
+		TEST_CHECK_MESSAGE(mismatchCount == 0, name + ": " + std::to_string(mismatchCount) + " of " + std::to_string(count) +
+			" differ (first at " + std::to_string(firstMismatch) + ")");
+		// 当たりと外れの両方がないと比べた意味がない
+		TEST_CHECK_MESSAGE(0 < hitCount && hitCount < count, name + ": " + std::to_string(hitCount) + " hits");
+	}
+
+	/*----------接する配置を作る----------*/
+
+	// 中心をcenterからdirectionへ半径の合計だけ離した球
+	Sphere MakeTouchingSphere(Bench::RandomPrimitives& random, const Sphere& sphere)
+	{
+		float radius = random.Range(0.5f, 2.0f);
+		return { sphere.center + random.Direction() * (sphere.radius + radius), radius };
+	}
+
+	// AABBの表面の点(面の上か角)
+	Vector3 PointOnSurface(Bench::RandomPrimitives& random, const AABB& aabb, Vector3& outward)
+	{
+		Vector3 point{};
+		outward = { 0.0f, 0.0f, 0.0f };
+		bool isCorner = random.Range(0.0f, 1.0f) < 0.25f;
+		int faceAxis = static_cast<int>(random.Range(0.0f, 2.999f));
+		for (int axis = 0; axis < 3; ++axis) {
+			bool isMax = random.Range(0.0f, 1.0f) < 0.5f;
+			if (isCorner || axis == faceAxis) {
+				At(point, axis) = isMax ? At(aabb.max, axis) : At(aabb.min, axis);
+				At(outward, axis) = isMax ? 1.0f : -1.0f;
+			} else {
+				At(point, axis) = random.Range(At(aabb.min, axis), At(aabb.max, axis));
+			}
+		}
+		outward = Normalize(outward);
+		return point;
+	}
+
+	// 表面から外向きに半径だけ離れた球
+	Sphere MakeSphereTouching(Bench::RandomPrimitives& random, const AABB& aabb)
+	{
+		Vector3 outward;
+		Vector3 point = PointOnSurface(random, aabb, outward);
+		float radius = random.Range(0.5f, 2.0f);
+		return { point + outward * radius, radius };
+	}
+
+	// 1つの軸の面で接し、ほかの軸は重なるか辺で接するAABB
+	AABB MakeTouchingAABB(Bench::RandomPrimitives& random, const AABB& aabb)
+	{
+		int faceAxis = static_cast<int>(random.Range(0.0f, 2.999f));
+		AABB result{};
+		for (int axis = 0; axis < 3; ++axis) {
+			float halfSize = random.Range(0.5f, 2.0f);
+			if (axis == faceAxis) {
+				bool isMax = random.Range(0.0f, 1.0f) < 0.5f;
+				At(result.min, axis) = isMax ? At(aabb.max, axis) : At(aabb.min, axis) - 2.0f * halfSize;
+				At(result.max, axis) = isMax ? At(aabb.max, axis) + 2.0f * halfSize : At(aabb.min, axis);
+			} else {
+				float center = random.Range(At(aabb.min, axis) - halfSize, At(aabb.max, axis) + halfSize);
+				At(result.min, axis) = center - halfSize;
+				At(result.max, axis) = center + halfSize;
+			}
+		}
+		return result;
+	}
+
+	// OBBの面から外向きに半径だけ離れた球
+	Sphere MakeSphereTouching(Bench::RandomPrimitives& random, const OBB& obb)
+	{
+		int faceAxis = static_cast<int>(random.Range(0.0f, 2.999f));
+		float radius = random.Range(0.5f, 2.0f);
+		Vector3 center = obb.center;
+		for (int axis = 0; axis < 3; ++axis) {
+			float halfSize = 0.5f * At(obb.size, axis);
+			float offset = axis == faceAxis
+				? (random.Range(0.0f, 1.0f) < 0.5f ? halfSize + radius : -halfSize - radius)
+				: random.Range(-halfSize, halfSize);
+			center = center + obb.orientations[axis] * offset;
+		}
+		return { center, radius };
+	}
+
+	// 別の向きに回したOBBを、分離軸判定の15本の軸のどれかの上でちょうど接する位置に置く
+	// 接する距離は分離軸判定と同じ式(|回転| + 1e-6で広げた半径)で求めるので、判定はその軸の境界での比較で決まる
+	OBB MakeTouchingOBB(Bench::RandomPrimitives& random, const OBB& obb)
+	{
+		// IsCollision(const CachedOBB&, const CachedOBB&)で、平行に近い辺の軸のために足す値
+		const float kEpsilon = 1e-6f;
+
+		OBB result = random.MakeOBB(0.5f, 2.0f);
+		const Vector3 extent1 = obb.size * 0.5f;
+		const Vector3 extent2 = result.size * 0.5f;
+		float absRotation[3][3];
+		for (int i = 0; i < 3; ++i) {
+			for (int j = 0; j < 3; ++j) {
+				absRotation[i][j] = std::abs(Dot(obb.orientations[i], result.orientations[j])) + kEpsilon;
+			}
+		}
+
+		Vector3 axis{};
+		float radius = 0.0f;
+		do {
+			int axisIndex = static_cast<int>(random.Range(0.0f, 14.999f));
+			if (axisIndex < 3) {
+				int i = axisIndex;
+				axis = obb.orientations[i];
+				radius = At(extent1, i) + extent2.x * absRotation[i][0] + extent2.y * absRotation[i][1] + extent2.z * absRotation[i][2];
+			} else if (axisIndex < 6) {
+				int j = axisIndex - 3;
+				axis = result.orientations[j];
+				radius = extent1.x * absRotation[0][j] + extent1.y * absRotation[1][j] + extent1.z * absRotation[2][j] + At(extent2, j);
+			} else {
+				// 辺同士の軸。長さを1にしない外積の上での半径
+				int i = (axisIndex - 6) / 3;
+				int j = (axisIndex - 6) % 3;
+				int i1 = (i + 1) % 3, i2 = (i + 2) % 3, j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+				axis = Cross(obb.orientations[i], result.orientations[j]);
+				radius = At(extent1, i1) * absRotation[i2][j] + At(extent1, i2) * absRotation[i1][j] +
+					At(extent2, j1) * absRotation[i][j2] + At(extent2, j2) * absRotation[i][j1];
+			}
+		} while (LengthSquared(axis) < 0.01f);
+		if (random.Range(0.0f, 1.0f) < 0.5f) {
+			axis = axis * -1.0f;
+		}
+		// 中心の差をaxisと平行にし、axisへの射影がちょうどradiusになるようにする
+		result.center = obb.center + axis * (radius / LengthSquared(axis));
+		return result;
+	}
+
+	// 視錐台の平面の1枚の上の点(他の平面の内側とは限らない)
+	Vector3 PointOnPlane(Bench::RandomPrimitives& random, const Plane& plane)
+	{
+		Vector3 point = random.Point();
+		return point - plane.normal * (Dot(plane.normal, point) - plane.distance);
+	}
+
+	Frustum MakeTestFrustum()
+	{
+		Matrix4x4 cameraMatrix = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.7f, 0.0f }, { 1.0f, 2.0f, -10.0f });
+		Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.8f, 16.0f / 9.0f, 0.5f, 40.0f);
+		return MakeFrustum(Multiply(Inverse(cameraMatrix), projectionMatrix));
+	}
+
+	/*----------形状と形状の配列----------*/
+
+	void CollisionBatch_SphereSpheres()
+	{
+		Bench::RandomPrimitives random(kSeed, 4.0f);
+		Sphere sphere = { { 0.5f, -0.25f, 0.125f }, 1.5f };
+		std::vector<Sphere> spheres;
+		for (size_t i = 0; i < kCount; ++i) {
+			spheres.push_back(i % 2 == 0 ? random.MakeSphere() : MakeTouchingSphere(random, sphere));
+		}
+		SphereBuffer buffer;
+		buffer.Assign(spheres);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(sphere, buffer.View(), hitMask);
+		CheckHitMask("Sphere x Spheres", hitMask, kCount, [&](size_t i) { return IsCollision(sphere, spheres[i]); });
+	}
+	TEST(CollisionBatch_SphereSpheres);
+
+	void CollisionBatch_AABBAABBs()
+	{
+		Bench::RandomPrimitives random(kSeed, 4.0f);
+		AABB aabb = { { -1.0f, -0.5f, -2.0f }, { 1.5f, 0.75f, 0.25f } };
+		std::vector<AABB> aabbs;
+		for (size_t i = 0; i < kCount; ++i) {
+			aabbs.push_back(i % 2 == 0 ? random.MakeAABB() : MakeTouchingAABB(random, aabb));
+		}
+		AABBBuffer buffer;
+		buffer.Assign(aabbs);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(aabb, buffer.View(), hitMask);
+		CheckHitMask("AABB x AABBs", hitMask, kCount, [&](size_t i) { return IsCollision(aabb, aabbs[i]); });
+	}
+	TEST(CollisionBatch_AABBAABBs);
+
+	void CollisionBatch_AABBSpheres()
+	{
+		Bench::RandomPrimitives random(kSeed, 4.0f);
+		AABB aabb = { { -1.0f, -0.5f, -2.0f }, { 1.5f, 0.75f, 0.25f } };
+		std::vector<Sphere> spheres;
+		for (size_t i = 0; i < kCount; ++i) {
+			spheres.push_back(i % 2 == 0 ? random.MakeSphere() : MakeSphereTouching(random, aabb));
+		}
+		SphereBuffer buffer;
+		buffer.Assign(spheres);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(aabb, buffer.View(), hitMask);
+		CheckHitMask("AABB x Spheres", hitMask, kCount, [&](size_t i) { return IsCollision(aabb, spheres[i]); });
+	}
+	TEST(CollisionBatch_AABBSpheres);
+
+	void CollisionBatch_AABBsSphere()
+	{
+		Bench::RandomPrimitives random(kSeed, 4.0f);
+		Sphere sphere = { { 0.5f, -0.25f, 0.125f }, 1.5f };
+		std::vector<AABB> aabbs;
+		for (size_t i = 0; i < kCount; ++i) {
+			if (i % 2 == 0) {
+				aabbs.push_back(random.MakeAABB());
+				continue;
+			}
+			// 球に接するAABBは、AABBに接する球を作ってから全体を球の位置までずらして作る
+			AABB aabb = random.MakeAABB();
+			Sphere touching = MakeSphereTouching(random, aabb);
+			touching.radius = sphere.radius;
+			Vector3 offset = sphere.center - touching.center;
+			aabbs.push_back({ aabb.min + offset, aabb.max + offset });
+		}
+		AABBBuffer buffer;
+		buffer.Assign(aabbs);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(buffer.View(), sphere, hitMask);
+		CheckHitMask("AABBs x Sphere", hitMask, kCount, [&](size_t i) { return IsCollision(aabbs[i], sphere); });
+	}
+	TEST(CollisionBatch_AABBsSphere);
+
+	void CollisionBatch_OBBsSphere()
+	{
+		Bench::RandomPrimitives random(kSeed, 4.0f);
+		Sphere sphere = { { 0.5f, -0.25f, 0.125f }, 1.5f };
+		std::vector<OBB> obbs;
+		for (size_t i = 0; i < kCount; ++i) {
+			OBB obb = random.MakeOBB();
+			if (i % 2 != 0) {
+				// 球に接するOBBは、OBBに接する球を作ってからOBBをずらして作る
+				Sphere touching = MakeSphereTouching(random, obb);
+				obb.center = obb.center + (sphere.center - touching.center);
+			}
+			obbs.push_back(obb);
+		}
+		OBBBuffer buffer;
+		buffer.Assign(obbs);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(buffer.View(), sphere, hitMask);
+		CheckHitMask("OBBs x Sphere", hitMask, kCount, [&](size_t i) { return IsCollision(obbs[i], sphere); });
+	}
+	TEST(CollisionBatch_OBBsSphere);
+
+	void CollisionBatch_OBBSpheres()
+	{
+		Bench::RandomPrimitives random(kSeed, 4.0f);
+		OBB obb = random.MakeOBB(1.0f, 3.0f);
+		obb.center = { 0.25f, 0.5f, -0.75f };
+		std::vector<Sphere> spheres;
+		for (size_t i = 0; i < kCount; ++i) {
+			spheres.push_back(i % 2 == 0 ? random.MakeSphere() : MakeSphereTouching(random, obb));
+		}
+		SphereBuffer buffer;
+		buffer.Assign(spheres);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(obb, buffer.View(), hitMask);
+		CheckHitMask("OBB x Spheres", hitMask, kCount, [&](size_t i) { return IsCollision(obb, spheres[i]); });
+	}
+	TEST(CollisionBatch_OBBSpheres);
+
+	void CollisionBatch_OBBOBBs()
+	{
+		Bench::RandomPrimitives random(kSeed, 4.0f);
+		OBB obb = random.MakeOBB(1.0f, 3.0f);
+		obb.center = { 0.25f, 0.5f, -0.75f };
+		std::vector<OBB> obbs;
+		for (size_t i = 0; i < kCount; ++i) {
+			obbs.push_back(i % 2 == 0 ? random.MakeOBB() : MakeTouchingOBB(random, obb));
+		}
+		OBBBuffer buffer;
+		buffer.Assign(obbs);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(obb, buffer.View(), hitMask);
+		CheckHitMask("OBB x OBBs", hitMask, kCount, [&](size_t i) { return IsCollision(obb, obbs[i]); });
+	}
+	TEST(CollisionBatch_OBBOBBs);
+
+	/*----------視錐台----------*/
+
+	void CollisionBatch_FrustumSpheres()
+	{
+		Bench::RandomPrimitives random(kSeed, 20.0f);
+		Frustum frustum = MakeTestFrustum();
+		std::vector<Sphere> spheres;
+		for (size_t i = 0; i < kCount; ++i) {
+			Sphere sphere = random.MakeSphere();
+			if (i % 2 != 0) {
+				// 平面の外側から半径だけ離れたところに置く
+				const Plane& plane = frustum.planes[i / 2 % 6];
+				sphere.center = PointOnPlane(random, plane) - plane.normal * sphere.radius;
+			}
+			spheres.push_back(sphere);
+		}
+		SphereBuffer buffer;
+		buffer.Assign(spheres);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(frustum, buffer.View(), hitMask);
+		CheckHitMask("Frustum x Spheres", hitMask, kCount, [&](size_t i) { return IsCollision(frustum, spheres[i]); });
+	}
+	TEST(CollisionBatch_FrustumSpheres);
+
+	void CollisionBatch_FrustumAABBs()
+	{
+		Bench::RandomPrimitives random(kSeed, 20.0f);
+		Frustum frustum = MakeTestFrustum();
+		std::vector<AABB> aabbs;
+		for (size_t i = 0; i < kCount; ++i) {
+			AABB aabb = random.MakeAABB();
+			if (i % 2 != 0) {
+				// 平面の法線方向への広がりだけ外側に置く
+				const Plane& plane = frustum.planes[i / 2 % 6];
+				Vector3 extent = (aabb.max - aabb.min) * 0.5f;
+				float projectedRadius = std::abs(plane.normal.x) * extent.x + std::abs(plane.normal.y) * extent.y + std::abs(plane.normal.z) * extent.z;
+				Vector3 center = PointOnPlane(random, plane) - plane.normal * projectedRadius;
+				aabb = { center - extent, center + extent };
+			}
+			aabbs.push_back(aabb);
+		}
+		AABBBuffer buffer;
+		buffer.Assign(aabbs);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(frustum, buffer.View(), hitMask);
+		CheckHitMask("Frustum x AABBs", hitMask, kCount, [&](size_t i) { return IsCollision(frustum, aabbs[i]); });
+	}
+	TEST(CollisionBatch_FrustumAABBs);
+
+	void CollisionBatch_FrustumOBBs()
+	{
+		Bench::RandomPrimitives random(kSeed, 20.0f);
+		Frustum frustum = MakeTestFrustum();
+		std::vector<OBB> obbs;
+		for (size_t i = 0; i < kCount; ++i) {
+			OBB obb = random.MakeOBB();
+			if (i % 2 != 0) {
+				const Plane& plane = frustum.planes[i / 2 % 6];
+				float projectedRadius = 0.0f;
+				for (int axis = 0; axis < 3; ++axis) {
+					projectedRadius += std::abs(Dot(plane.normal, obb.orientations[axis])) * 0.5f * At(obb.size, axis);
+				}
+				obb.center = PointOnPlane(random, plane) - plane.normal * projectedRadius;
+			}
+			obbs.push_back(obb);
+		}
+		OBBBuffer buffer;
+		buffer.Assign(obbs);
+		std::vector<uint32_t> hitMask(HitMaskWordCount(kCount));
+		IsCollisionBatch(frustum, buffer.View(), hitMask);
+		CheckHitMask("Frustum x OBBs", hitMask, kCount, [&](size_t i) { return IsCollision(frustum, obbs[i]); });
+	}
+	TEST(CollisionBatch_FrustumOBBs);
+}
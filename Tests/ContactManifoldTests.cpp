@@ -0,0 +1,266 @@
+#include "MathFunction.h"
+#include "TestHarness.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+// 接触情報を返すIsCollisionの各オーバーロードについて、答えが分かっている配置で
+// 法線の向き(1つ目の形状から2つ目へ)、めり込みの深さ、接触点を確かめる
+// OBB同士のめり込み(OBBPenetration)も、面の軸と辺同士の軸で軸の番号、向き、深さを確かめる
+
+using namespace Math;
+
+namespace
+{
+	// OBB同士の分離軸判定は|回転| + 1e-6で半径を広げるので、その分だけ許す
+	constexpr float kTolerance = 1e-5f;
+
+	bool IsNear(float a, float b)
+	{
+		return std::abs(a - b) <= kTolerance;
+	}
+
+	bool IsNear(const Vector3& a, const Vector3& b)
+	{
+		return IsNear(a.x, b.x) && IsNear(a.y, b.y) && IsNear(a.z, b.z);
+	}
+
+	std::string ToString(const Vector3& v)
+	{
+		return "(" + std::to_string(v.x) + ", " + std::to_string(v.y) + ", " + std::to_string(v.z) + ")";
+	}
+
+	// 接触点がexpectedと(順番によらず)一致するか
+	bool HasPoints(const ContactManifold& manifold, const std::vector<Vector3>& expected)
+	{
+		if (manifold.pointCount != expected.size()) {
+			return false;
+		}
+		for (const Vector3& point : expected) {
+			bool isFound = false;
+			for (uint32_t i = 0; i < manifold.pointCount; ++i) {
+				isFound = isFound || IsNear(manifold.points[i], point);
+			}
+			if (!isFound) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void CheckContact(const char* name, const ContactManifold& manifold, const Vector3& normal, float depth, const std::vector<Vector3>& points)
+	{
+		TEST_CHECK_MESSAGE(IsNear(manifold.normal, normal), std::string(name) + ": normal " + ToString(manifold.normal));
+		TEST_CHECK_MESSAGE(IsNear(manifold.depth, depth), std::string(name) + ": depth " + std::to_string(manifold.depth));
+		TEST_CHECK_MESSAGE(HasPoints(manifold, points), std::string(name) + ": " + std::to_string(manifold.pointCount) + " points, first " + ToString(manifold.points[0]));
+	}
+
+	// z軸まわりに90度回したOBB(ローカルのx軸がワールドのy軸を向く)
+	OBB MakeRotatedOBB()
+	{
+		OBB obb{};
+		obb.center = { 1.0f, 0.0f, 0.0f };
+		obb.orientations[0] = { 0.0f, 1.0f, 0.0f };
+		obb.orientations[1] = { -1.0f, 0.0f, 0.0f };
+		obb.orientations[2] = { 0.0f, 0.0f, 1.0f };
+		obb.size = { 4.0f, 2.0f, 2.0f };
+		return obb;
+	}
+
+	OBB MakeAxisAlignedOBB(const Vector3& center, const Vector3& size)
+	{
+		return { center, { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, size };
+	}
+
+	void ContactManifold_SphereSphere()
+	{
+		ContactManifold manifold{};
+		TEST_CHECK(IsCollision(Sphere{ { 0.0f, 0.0f, 0.0f }, 1.0f }, Sphere{ { 1.5f, 0.0f, 0.0f }, 1.0f }, manifold));
+		// 接触点はめり込んだ範囲の真ん中
+		CheckContact("overlap", manifold, { 1.0f, 0.0f, 0.0f }, 0.5f, { { 0.75f, 0.0f, 0.0f } });
+
+		TEST_CHECK(IsCollision(Sphere{ { 1.5f, 0.0f, 0.0f }, 1.0f }, Sphere{ { 0.0f, 0.0f, 0.0f }, 1.0f }, manifold));
+		CheckContact("reversed", manifold, { -1.0f, 0.0f, 0.0f }, 0.5f, { { 0.75f, 0.0f, 0.0f } });
+
+		// 中心が同じときは上向きに押し出す
+		TEST_CHECK(IsCollision(Sphere{ { 0.0f, 0.0f, 0.0f }, 1.0f }, Sphere{ { 0.0f, 0.0f, 0.0f }, 0.5f }, manifold));
+		CheckContact("same center", manifold, { 0.0f, 1.0f, 0.0f }, 1.5f, { { 0.0f, 0.25f, 0.0f } });
+
+		TEST_CHECK(!IsCollision(Sphere{ { 0.0f, 0.0f, 0.0f }, 1.0f }, Sphere{ { 2.5f, 0.0f, 0.0f }, 1.0f }, manifold));
+	}
+	TEST(ContactManifold_SphereSphere);
+
+	void ContactManifold_SpherePlane()
+	{
+		const Plane plane = { { 0.0f, 1.0f, 0.0f }, 0.0f };
+		ContactManifold manifold{};
+
+		// 表側: 法線は球から平面へ(平面の法線と逆)
+		TEST_CHECK(IsCollision(Sphere{ { 1.0f, 0.25f, 2.0f }, 1.0f }, plane, manifold));
+		CheckContact("front", manifold, { 0.0f, -1.0f, 0.0f }, 0.75f, { { 1.0f, 0.0f, 2.0f } });
+
+		// 裏側: 法線は平面の法線と同じ向き
+		TEST_CHECK(IsCollision(Sphere{ { 1.0f, -0.5f, 2.0f }, 1.0f }, plane, manifold));
+		CheckContact("back", manifold, { 0.0f, 1.0f, 0.0f }, 0.5f, { { 1.0f, 0.0f, 2.0f } });
+
+		TEST_CHECK(!IsCollision(Sphere{ { 1.0f, 2.0f, 2.0f }, 1.0f }, plane, manifold));
+	}
+	TEST(ContactManifold_SpherePlane);
+
+	void ContactManifold_AABBSphere()
+	{
+		const AABB aabb = { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } };
+		ContactManifold manifold{};
+
+		// 面の外から
+		TEST_CHECK(IsCollision(aabb, Sphere{ { 1.5f, 0.0f, 0.0f }, 1.0f }, manifold));
+		CheckContact("face", manifold, { 1.0f, 0.0f, 0.0f }, 0.5f, { { 1.0f, 0.0f, 0.0f } });
+
+		// 辺の外から: 法線は辺から球の中心へ
+		const float diagonal = std::sqrt(2.0f) * 0.5f;
+		TEST_CHECK(IsCollision(aabb, Sphere{ { -1.5f, -1.5f, 0.0f }, 1.0f }, manifold));
+		CheckContact("edge", manifold, { -diagonal, -diagonal, 0.0f }, 1.0f - diagonal, { { -1.0f, -1.0f, 0.0f } });
+
+		// 中心が箱の中: 一番近い面(+y)から押し出す
+		TEST_CHECK(IsCollision(aabb, Sphere{ { 0.0f, 0.75f, 0.0f }, 0.5f }, manifold));
+		CheckContact("inside", manifold, { 0.0f, 1.0f, 0.0f }, 0.75f, { { 0.0f, 1.0f, 0.0f } });
+
+		TEST_CHECK(!IsCollision(aabb, Sphere{ { 2.5f, 0.0f, 0.0f }, 1.0f }, manifold));
+	}
+	TEST(ContactManifold_AABBSphere);
+
+	void ContactManifold_AABBAABB()
+	{
+		// x軸だけ浅く重なる
+		const AABB aabb1 = { { 0.0f, 0.0f, 0.0f }, { 2.0f, 2.0f, 2.0f } };
+		const AABB aabb2 = { { 1.5f, 0.5f, 0.5f }, { 3.0f, 1.5f, 1.5f } };
+		// 接触点は重なった範囲の、x軸に垂直な断面の4隅
+		const std::vector<Vector3> points = {
+			{ 1.75f, 0.5f, 0.5f }, { 1.75f, 1.5f, 0.5f }, { 1.75f, 0.5f, 1.5f }, { 1.75f, 1.5f, 1.5f }
+		};
+		ContactManifold manifold{};
+		TEST_CHECK(IsCollision(aabb1, aabb2, manifold));
+		CheckContact("x axis", manifold, { 1.0f, 0.0f, 0.0f }, 0.5f, points);
+
+		TEST_CHECK(IsCollision(aabb2, aabb1, manifold));
+		CheckContact("x axis reversed", manifold, { -1.0f, 0.0f, 0.0f }, 0.5f, points);
+
+		TEST_CHECK(!IsCollision(aabb1, AABB{ { 2.5f, 0.0f, 0.0f }, { 3.0f, 1.0f, 1.0f } }, manifold));
+	}
+	TEST(ContactManifold_AABBAABB);
+
+	void ContactManifold_OBBSphere()
+	{
+		// ローカルのx軸(ワールドのy軸)の面の外から
+		const OBB obb = MakeRotatedOBB();
+		const Sphere sphere = { { 1.0f, 2.5f, 0.0f }, 1.0f };
+		ContactManifold manifold{};
+		TEST_CHECK(IsCollision(obb, sphere, manifold));
+		CheckContact("OBB", manifold, { 0.0f, 1.0f, 0.0f }, 0.5f, { { 1.0f, 2.0f, 0.0f } });
+
+		TEST_CHECK(IsCollision(MakeCachedOBB(obb), sphere, manifold));
+		CheckContact("CachedOBB", manifold, { 0.0f, 1.0f, 0.0f }, 0.5f, { { 1.0f, 2.0f, 0.0f } });
+
+		// 中心が箱の中: ローカルの-y(ワールドの+x)の面が一番近い
+		TEST_CHECK(IsCollision(obb, Sphere{ { 1.75f, 0.0f, 0.0f }, 0.5f }, manifold));
+		CheckContact("inside", manifold, { 1.0f, 0.0f, 0.0f }, 0.75f, { { 2.0f, 0.0f, 0.0f } });
+
+		TEST_CHECK(!IsCollision(obb, Sphere{ { 1.0f, 3.5f, 0.0f }, 1.0f }, manifold));
+	}
+	TEST(ContactManifold_OBBSphere);
+
+	void ContactManifold_OBBOBBFace()
+	{
+		// obb1のx軸の面に、obb2の-x側の面が0.25だけめり込む
+		const OBB obb1 = MakeAxisAlignedOBB({ 0.0f, 0.0f, 0.0f }, { 2.0f, 2.0f, 2.0f });
+		const OBB obb2 = MakeAxisAlignedOBB({ 1.75f, 0.0f, 0.0f }, { 2.0f, 1.0f, 1.0f });
+		// obb2の面の4隅を、obb1の面との中間に置いたもの
+		const std::vector<Vector3> points = {
+			{ 0.875f, -0.5f, -0.5f }, { 0.875f, 0.5f, -0.5f }, { 0.875f, -0.5f, 0.5f }, { 0.875f, 0.5f, 0.5f }
+		};
+		ContactManifold manifold{};
+		TEST_CHECK(IsCollision(obb1, obb2, manifold));
+		CheckContact("OBB", manifold, { 1.0f, 0.0f, 0.0f }, 0.25f, points);
+
+		TEST_CHECK(IsCollision(MakeCachedOBB(obb2), MakeCachedOBB(obb1), manifold));
+		CheckContact("CachedOBB reversed", manifold, { -1.0f, 0.0f, 0.0f }, 0.25f, points);
+
+		TEST_CHECK(!IsCollision(obb1, MakeAxisAlignedOBB({ 2.5f, 0.0f, 0.0f }, { 2.0f, 1.0f, 1.0f }), manifold));
+	}
+	TEST(ContactManifold_OBBOBBFace);
+
+	void ContactManifold_OBBOBBEdge()
+	{
+		// z軸まわりに45度回した立方体の+x側の辺(z軸向き)と、y軸まわりに45度回した立方体の-x側の辺(y軸向き)が
+		// x軸の上で交わり、x方向に0.1だけめり込む。面の軸ではもっと深いので、辺同士の軸が選ばれる
+		const float c = std::cos(0.785398163f);
+		const float s = std::sin(0.785398163f);
+		const float halfDiagonal = std::sqrt(2.0f);
+		const float center2 = 2.0f * halfDiagonal - 0.1f;
+		const OBB obb1 = { { 0.0f, 0.0f, 0.0f }, { { c, s, 0.0f }, { -s, c, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { 2.0f, 2.0f, 2.0f } };
+		const OBB obb2 = { { center2, 0.0f, 0.0f }, { { c, 0.0f, -s }, { 0.0f, 1.0f, 0.0f }, { s, 0.0f, c } }, { 2.0f, 2.0f, 2.0f } };
+
+		// 接触点は2つの辺の最近接点の中点
+		ContactManifold manifold{};
+		TEST_CHECK(IsCollision(obb1, obb2, manifold));
+		CheckContact("edge", manifold, { 1.0f, 0.0f, 0.0f }, 0.1f, { { center2 * 0.5f, 0.0f, 0.0f } });
+	}
+	TEST(ContactManifold_OBBOBBEdge);
+
+	/*----------OBB同士のめり込み----------*/
+
+	// z軸まわりにradianだけ回した立方体(半分の大きさ1)
+	CachedOBB MakeRotatedCube(const Vector3& center, float radian)
+	{
+		const float c = std::cos(radian);
+		const float s = std::sin(radian);
+		return MakeCachedOBB({ center, { { c, s, 0.0f }, { -s, c, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { 2.0f, 2.0f, 2.0f } });
+	}
+
+	void OBBPenetration_FaceAxis()
+	{
+		// 30度回した立方体のx方向への広がりはcos30 + sin30。obb1のx軸の面でだけ浅くめり込む
+		const float radian = 0.523598776f;
+		const float depth = 1.0f + std::cos(radian) + std::sin(radian) - 2.2f;
+		const CachedOBB cube = MakeRotatedCube({ 0.0f, 0.0f, 0.0f }, 0.0f);
+		OBBPenetration penetration{};
+
+		TEST_CHECK(IsCollision(cube, MakeRotatedCube({ 2.2f, 0.0f, 0.0f }, radian), penetration));
+		TEST_CHECK_MESSAGE(penetration.axisIndex == 0, "axis index " + std::to_string(penetration.axisIndex));
+		TEST_CHECK_MESSAGE(IsNear(penetration.axis, { 1.0f, 0.0f, 0.0f }), "axis " + ToString(penetration.axis));
+		TEST_CHECK_MESSAGE(IsNear(penetration.depth, depth), "depth " + std::to_string(penetration.depth));
+
+		// 2つ目が-x側にあれば軸も-xを向く
+		TEST_CHECK(IsCollision(cube, MakeRotatedCube({ -2.2f, 0.0f, 0.0f }, radian), penetration));
+		TEST_CHECK_MESSAGE(penetration.axisIndex == 0, "axis index " + std::to_string(penetration.axisIndex));
+		TEST_CHECK_MESSAGE(IsNear(penetration.axis, { -1.0f, 0.0f, 0.0f }), "axis " + ToString(penetration.axis));
+		TEST_CHECK_MESSAGE(IsNear(penetration.depth, depth), "depth " + std::to_string(penetration.depth));
+
+		// 入れ替えると2つ目(軸に揃った立方体)の面の軸になり、向きは1つ目から2つ目へ
+		TEST_CHECK(IsCollision(MakeRotatedCube({ -2.2f, 0.0f, 0.0f }, radian), cube, penetration));
+		TEST_CHECK_MESSAGE(penetration.axisIndex == 3, "axis index " + std::to_string(penetration.axisIndex));
+		TEST_CHECK_MESSAGE(IsNear(penetration.axis, { 1.0f, 0.0f, 0.0f }), "axis " + ToString(penetration.axis));
+		TEST_CHECK_MESSAGE(IsNear(penetration.depth, depth), "depth " + std::to_string(penetration.depth));
+
+		TEST_CHECK(!IsCollision(cube, MakeRotatedCube({ 2.5f, 0.0f, 0.0f }, radian), penetration));
+	}
+	TEST(OBBPenetration_FaceAxis);
+
+	void OBBPenetration_EdgeAxis()
+	{
+		// ContactManifold_OBBOBBEdgeと同じ配置。obb1のz軸とobb2のy軸の外積(-x)を、1つ目から2つ目へ向けた+xになる
+		const float c = std::cos(0.785398163f);
+		const float s = std::sin(0.785398163f);
+		const float halfDiagonal = std::sqrt(2.0f);
+		const CachedOBB obb1 = MakeRotatedCube({ 0.0f, 0.0f, 0.0f }, 0.785398163f);
+		for (float direction : { 1.0f, -1.0f }) {
+			const OBB obb2 = { { direction * (2.0f * halfDiagonal - 0.1f), 0.0f, 0.0f }, { { c, 0.0f, -s }, { 0.0f, 1.0f, 0.0f }, { s, 0.0f, c } }, { 2.0f, 2.0f, 2.0f } };
+			OBBPenetration penetration{};
+			TEST_CHECK(IsCollision(obb1, MakeCachedOBB(obb2), penetration));
+			TEST_CHECK_MESSAGE(penetration.axisIndex == 6 + 2 * 3 + 1, "axis index " + std::to_string(penetration.axisIndex));
+			TEST_CHECK_MESSAGE(IsNear(penetration.axis, { direction, 0.0f, 0.0f }), "axis " + ToString(penetration.axis));
+			TEST_CHECK_MESSAGE(IsNear(penetration.depth, 0.1f), "depth " + std::to_string(penetration.depth));
+		}
+	}
+	TEST(OBBPenetration_EdgeAxis);
+}
@@ -0,0 +1,194 @@
+#include "MathFunction.h"
+#include "MatrixSimd.h"
+#include "RandomPrimitives.h"
+#include "TestHarness.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+// MatrixSimdの結果を、元のスカラー実装(MatrixSimd::Reference)と比べる
+// 乗算と転置はビット単位で一致すること、逆行列は誤差が小さいことを確かめる
+
+using namespace Math;
+
+namespace
+{
+	constexpr uint32_t kSeed = 2024;
+	constexpr int kMatrixCount = 2000;
+
+	// 2つのfloatの間にいくつfloatがあるか(符号をまたいでも数えられるように、順序を保つ整数にする)
+	int64_t UlpDistance(float a, float b)
+	{
+		auto toOrdered = [](float value) {
+			int32_t bits = std::bit_cast<int32_t>(value);
+			return bits < 0 ? static_cast<int64_t>(INT32_MIN) - bits : static_cast<int64_t>(bits);
+		};
+		int64_t distance = toOrdered(a) - toOrdered(b);
+		return distance < 0 ? -distance : distance;
+	}
+
+	int64_t MaxUlpDistance(const Matrix4x4& a, const Matrix4x4& b)
+	{
+		int64_t result = 0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				result = std::max(result, UlpDistance(a.m[row][column], b.m[row][column]));
+			}
+		}
+		return result;
+	}
+
+	// 要素の差の最大値を、比べる相手の要素の大きさの最大値で割ったもの
+	float MaxRelativeError(const Matrix4x4& actual, const Matrix4x4& expected)
+	{
+		float maxError = 0.0f;
+		float maxValue = 0.0f;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				maxError = std::max(maxError, std::abs(actual.m[row][column] - expected.m[row][column]));
+				maxValue = std::max(maxValue, std::abs(expected.m[row][column]));
+			}
+		}
+		return maxError / maxValue;
+	}
+
+	// |m * inverse - I| の要素の最大値
+	float InverseResidual(const Matrix4x4& m, const Matrix4x4& inverse)
+	{
+		return MaxRelativeError(MatrixSimd::Reference::Multiply(m, inverse), MakeIdentity());
+	}
+
+	// 要素が-1～1の行列に対角成分を足して、条件数が大きくなりすぎないようにする
+	Matrix4x4 MakeGeneralMatrix(Bench::RandomPrimitives& random)
+	{
+		Matrix4x4 m{};
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				m.m[row][column] = random.Range(-1.0f, 1.0f) + (row == column ? 3.0f : 0.0f);
+			}
+		}
+		return m;
+	}
+
+	// ビュー・プロジェクション行列(逆行列をよく使う、4列目が(0, 0, 0, 1)でない行列)
+	Matrix4x4 MakeViewProjectionMatrix(Bench::RandomPrimitives& random)
+	{
+		Matrix4x4 cameraMatrix = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, random.Rotation(), random.Point());
+		Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(random.Range(0.3f, 1.5f), random.Range(1.0f, 2.0f), 0.1f, 100.0f);
+		return MatrixSimd::Reference::Multiply(MatrixSimd::Reference::Inverse(cameraMatrix), projectionMatrix);
+	}
+
+	std::string Describe(const char* name, int index, double value)
+	{
+		return std::string(name) + " at matrix " + std::to_string(index) + ": " + std::to_string(value);
+	}
+
+	void MatrixSimd_MultiplyMatchesReference()
+	{
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		int64_t maxUlp = 0;
+		int worstIndex = 0;
+		for (int i = 0; i < kMatrixCount; ++i) {
+			Matrix4x4 a = i % 2 == 0 ? random.MakeAffineMatrix() : MakeGeneralMatrix(random);
+			Matrix4x4 b = i % 3 == 0 ? MakeViewProjectionMatrix(random) : MakeGeneralMatrix(random);
+			Matrix4x4 expected = MatrixSimd::Reference::Multiply(a, b);
+			int64_t ulp = std::max(MaxUlpDistance(MatrixSimd::Multiply(a, b), expected), MaxUlpDistance(Multiply(a, b), expected));
+
+			// operator*=もMatrixSimd::Multiplyを通る
+			Matrix4x4 product = a;
+			product *= b;
+			ulp = std::max(ulp, MaxUlpDistance(product, expected));
+			if (maxUlp < ulp) {
+				maxUlp = ulp;
+				worstIndex = i;
+			}
+		}
+		TEST_CHECK_MESSAGE(maxUlp == 0, Describe("max ulp", worstIndex, static_cast<double>(maxUlp)));
+	}
+	TEST(MatrixSimd_MultiplyMatchesReference);
+
+	void MatrixSimd_TransposeMatchesReference()
+	{
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		for (int i = 0; i < kMatrixCount; ++i) {
+			Matrix4x4 m = MakeGeneralMatrix(random);
+			int64_t ulp = std::max(MaxUlpDistance(MatrixSimd::Transpose(m), MatrixSimd::Reference::Transpose(m)), MaxUlpDistance(Transpose(m), MatrixSimd::Reference::Transpose(m)));
+			TEST_CHECK_MESSAGE(ulp == 0, Describe("max ulp", i, static_cast<double>(ulp)));
+			if (ulp != 0) {
+				break;
+			}
+		}
+	}
+	TEST(MatrixSimd_TransposeMatchesReference);
+
+	void MatrixSimd_InverseAccuracy()
+	{
+		// SSE2の逆行列はブロックに分けて求めるので、元の余因子展開とは丸め方が違い、ビット単位では一致しない
+		const float kMaxResidual = 1e-5f;
+		const float kMaxDifference = 1e-5f;
+
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		float maxResidual = 0.0f;
+		float maxDifference = 0.0f;
+		for (int i = 0; i < kMatrixCount; ++i) {
+			Matrix4x4 m = MakeGeneralMatrix(random);
+			Matrix4x4 inverse = MatrixSimd::Inverse(m);
+			maxResidual = std::max(maxResidual, InverseResidual(m, inverse));
+			maxDifference = std::max(maxDifference, MaxRelativeError(inverse, MatrixSimd::Reference::Inverse(m)));
+		}
+		TEST_CHECK_MESSAGE(maxResidual <= kMaxResidual, "residual " + std::to_string(maxResidual));
+		TEST_CHECK_MESSAGE(maxDifference <= kMaxDifference, "difference from reference " + std::to_string(maxDifference));
+	}
+	TEST(MatrixSimd_InverseAccuracy);
+
+	void MatrixSimd_InverseViewProjectionAccuracy()
+	{
+		// ビュー・プロジェクション行列は近クリップ面が近いほど条件数が大きく、元の実装でも残差が1e-4程度になる
+		// 行列ごとの残差は丸め方の違いで大きくばらつくので、全体の平均と最大を元の実装と比べる
+		const float kResidualRatio = 1.5f;
+
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		double residualSum = 0.0;
+		double referenceResidualSum = 0.0;
+		float maxResidual = 0.0f;
+		float maxReferenceResidual = 0.0f;
+		for (int i = 0; i < kMatrixCount; ++i) {
+			Matrix4x4 m = MakeViewProjectionMatrix(random);
+			float residual = InverseResidual(m, MatrixSimd::Inverse(m));
+			float referenceResidual = InverseResidual(m, MatrixSimd::Reference::Inverse(m));
+			residualSum += residual;
+			referenceResidualSum += referenceResidual;
+			maxResidual = std::max(maxResidual, residual);
+			maxReferenceResidual = std::max(maxReferenceResidual, referenceResidual);
+		}
+		TEST_CHECK_MESSAGE(residualSum <= kResidualRatio * referenceResidualSum,
+			"mean residual " + std::to_string(residualSum / kMatrixCount) + " (reference " + std::to_string(referenceResidualSum / kMatrixCount) + ")");
+		TEST_CHECK_MESSAGE(maxResidual <= kResidualRatio * maxReferenceResidual,
+			"max residual " + std::to_string(maxResidual) + " (reference " + std::to_string(maxReferenceResidual) + ")");
+	}
+	TEST(MatrixSimd_InverseViewProjectionAccuracy);
+
+	void MatrixSimd_InverseAffineAccuracy()
+	{
+		const float kMaxResidual = 1e-5f;
+		const float kMaxDifference = 1e-5f;
+
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		float maxResidual = 0.0f;
+		float maxDifference = 0.0f;
+		for (int i = 0; i < kMatrixCount; ++i) {
+			Matrix4x4 m = random.MakeAffineMatrix();
+			Matrix4x4 inverse = MatrixSimd::InverseAffine(m);
+			maxResidual = std::max(maxResidual, InverseResidual(m, inverse));
+			maxDifference = std::max(maxDifference, MaxRelativeError(inverse, MatrixSimd::Reference::Inverse(m)));
+
+			// 4列目はそのまま(0, 0, 0, 1)になる
+			TEST_CHECK(inverse.m[0][3] == 0.0f && inverse.m[1][3] == 0.0f && inverse.m[2][3] == 0.0f && inverse.m[3][3] == 1.0f);
+		}
+		TEST_CHECK_MESSAGE(maxResidual <= kMaxResidual, "residual " + std::to_string(maxResidual));
+		TEST_CHECK_MESSAGE(maxDifference <= kMaxDifference, "difference from reference " + std::to_string(maxDifference));
+	}
+	TEST(MatrixSimd_InverseAffineAccuracy);
+}
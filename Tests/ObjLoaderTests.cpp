@@ -0,0 +1,49 @@
+#include "ObjLoader.h"
+#include "TestHarness.h"
+#include <string>
+#include <vector>
+
+// OBJの解析で、正しくない面の番号を読み込み失敗にできているかを確かめる
+
+using namespace Math;
+
+namespace
+{
+	const char* const kTriangleVertices = "v 0 0 0\nv 1 0 0\nv 0 1 0\n";
+
+	bool Parse(const std::string& faces, ObjMesh& mesh)
+	{
+		return ParseObj(std::string(kTriangleVertices) + faces, mesh);
+	}
+
+	void ObjLoader_AcceptsValidIndices()
+	{
+		ObjMesh mesh;
+		TEST_CHECK(Parse("f 1 2 3\n", mesh) && mesh.GetTriangleCount() == 1);
+		TEST_CHECK(Parse("f -3 -2 -1\n", mesh) && mesh.indices == std::vector<uint32_t>({ 0, 1, 2 }));
+		TEST_CHECK(Parse("f 1/1/1 2/2/2 3/3/3\n", mesh) && mesh.GetTriangleCount() == 1);
+
+		// 4MBずつのチャンクに分けて読むので、前のチャンクの頂点を相対の番号で指す面も読めること
+		std::string padding;
+		while (padding.size() < (5u << 20)) {
+			padding += "# padding to move the face into the next chunk\n";
+		}
+		TEST_CHECK(Parse(padding + "f -3 -2 -1\n", mesh) && mesh.indices == std::vector<uint32_t>({ 0, 1, 2 }));
+	}
+	TEST(ObjLoader_AcceptsValidIndices);
+
+	void ObjLoader_RejectsOutOfRangeIndices()
+	{
+		ObjMesh mesh;
+		TEST_CHECK(!Parse("f 1 2 4\n", mesh) && mesh.positions.empty());
+		TEST_CHECK(!Parse("f -4 -2 -1\n", mesh) && mesh.positions.empty());
+		// 32ビットにすると一周して1や2になる番号
+		TEST_CHECK(!Parse("f 4294967297 2 3\n", mesh) && mesh.positions.empty());
+		TEST_CHECK(!Parse("f 1 4294967298 3\n", mesh) && mesh.positions.empty());
+		TEST_CHECK(!Parse("f -4294967299 -2 -1\n", mesh) && mesh.positions.empty());
+		// 一周させると、あとで定義される頂点(4番目)を指してしまう相対の番号
+		TEST_CHECK(!ParseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nf -4294967295 -2 -1\nv 5 5 5\nv 6 6 6\n", mesh) && mesh.positions.empty());
+		TEST_CHECK(!Parse("f 1 2 99999999999999999999\n", mesh) && mesh.positions.empty());
+	}
+	TEST(ObjLoader_RejectsOutOfRangeIndices);
+}
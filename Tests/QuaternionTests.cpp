@@ -0,0 +1,169 @@
+#include "MathFunction.h"
+#include "Quaternion.h"
+#include "RandomPrimitives.h"
+#include "TestHarness.h"
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <string>
+
+// Quaternion型の関数を加えても、Vector3型の関数の呼び出し方が変わらないことを確かめる
+// クォータニオンから作った回転が、行列の関数(オイラー角、行列の掛け算で作った拡縮・回転・平行移動)と一致することも確かめる
+
+using namespace Math;
+
+namespace
+{
+	constexpr uint32_t kSeed = 2024;
+	constexpr int kSampleCount = 1000;
+	// sin/cosと掛け算の丸めの差。行列の要素は拡縮(最大2倍)を含めても数程度なので、絶対誤差で比べる
+	constexpr float kTolerance = 1e-5f;
+
+	bool IsNear(const Matrix4x4& a, const Matrix4x4& b)
+	{
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				if (std::abs(a.m[i][j] - b.m[i][j]) > kTolerance) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool IsNear(const Vector3& a, const Vector3& b)
+	{
+		return std::abs(a.x - b.x) <= kTolerance && std::abs(a.y - b.y) <= kTolerance && std::abs(a.z - b.z) <= kTolerance;
+	}
+
+	// qと-qは同じ回転なので、どちらかに近ければよい
+	bool IsSameRotation(const Quaternion& a, const Quaternion& b)
+	{
+		return std::abs(std::abs(Dot(a, b)) - 1.0f) <= kTolerance;
+	}
+
+	Quaternion RandomQuaternion(Bench::RandomPrimitives& random)
+	{
+		return Normalize(Quaternion{ random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f) });
+	}
+
+	Vector3 RandomScale(Bench::RandomPrimitives& random)
+	{
+		return { random.Range(0.5f, 2.0f), random.Range(0.5f, 2.0f), random.Range(0.5f, 2.0f) };
+	}
+
+	void Quaternion_BracedVector3CallsStayUnambiguous()
+	{
+		// { x, y, z }はVector3だけに当てはまる(Quaternionは4成分すべてが必要)
+		Vector3 normal = Normalize({ 3.0f, 0.0f, 4.0f });
+		TEST_CHECK(normal.x == 0.6f && normal.y == 0.0f && normal.z == 0.8f);
+		TEST_CHECK(Dot({ 1.0f, 2.0f, 3.0f }, { 4.0f, 5.0f, 6.0f }) == 32.0f);
+
+		Quaternion quaternion = Normalize(Quaternion{ 0.0f, 0.0f, 3.0f, 4.0f });
+		TEST_CHECK(std::abs(quaternion.z - 0.6f) < 1e-6f && std::abs(quaternion.w - 0.8f) < 1e-6f);
+	}
+	TEST(Quaternion_BracedVector3CallsStayUnambiguous);
+
+	void Quaternion_SlerpEndPoints()
+	{
+		Bench::RandomPrimitives random(kSeed);
+		for (int i = 0; i < kSampleCount; ++i) {
+			Quaternion q0 = RandomQuaternion(random);
+			Quaternion q1 = RandomQuaternion(random);
+			TEST_CHECK_MESSAGE(IsSameRotation(Slerp(q0, q1, 0.0f), q0), "t = 0 at sample " + std::to_string(i));
+			TEST_CHECK_MESSAGE(IsSameRotation(Slerp(q0, q1, 1.0f), q1), "t = 1 at sample " + std::to_string(i));
+			// 補間の途中も単位クォータニオンのまま
+			TEST_CHECK_MESSAGE(std::abs(Norm(Slerp(q0, q1, 0.3f)) - 1.0f) <= kTolerance, "norm at sample " + std::to_string(i));
+		}
+
+		// 同じ軸まわりの回転なら角度を補間する。-qを渡しても近い方を通る
+		const Vector3 axis = Normalize(Vector3{ 1.0f, 2.0f, 3.0f });
+		const float kPi = std::numbers::pi_v<float>;
+		Quaternion start = MakeRotateAxisAngleQuaternion(axis, 0.2f);
+		Quaternion end = MakeRotateAxisAngleQuaternion(axis, 0.2f + kPi / 2.0f);
+		Quaternion expected = MakeRotateAxisAngleQuaternion(axis, 0.2f + kPi / 8.0f);
+		TEST_CHECK(IsSameRotation(Slerp(start, end, 0.25f), expected));
+		TEST_CHECK(IsSameRotation(Slerp(start, Quaternion{ -end.x, -end.y, -end.z, -end.w }, 0.25f), expected));
+		// ほとんど同じ向きのときの線形補間
+		Quaternion near = MakeRotateAxisAngleQuaternion(axis, 0.2f + 1e-3f);
+		TEST_CHECK(IsSameRotation(Slerp(start, near, 0.5f), MakeRotateAxisAngleQuaternion(axis, 0.2f + 5e-4f)));
+	}
+	TEST(Quaternion_SlerpEndPoints);
+
+	void Quaternion_EulerMatchesAffineMatrix()
+	{
+		Bench::RandomPrimitives random(kSeed);
+		for (int i = 0; i < kSampleCount; ++i) {
+			Vector3 radian = random.Rotation();
+			Matrix4x4 expected = MakeAffineMatrix(Vector3{ 1.0f, 1.0f, 1.0f }, radian, Vector3{ 0.0f, 0.0f, 0.0f });
+			TEST_CHECK_MESSAGE(IsNear(MakeRotateMatrix(MakeRotateEulerQuaternion(radian)), expected), "sample " + std::to_string(i));
+		}
+	}
+	TEST(Quaternion_EulerMatchesAffineMatrix);
+
+	void Quaternion_RotateVectorMatchesMatrix()
+	{
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		for (int i = 0; i < kSampleCount; ++i) {
+			Quaternion quaternion = RandomQuaternion(random);
+			Vector3 vector = random.Point();
+			// 長さ10程度のベクトルなので、許す誤差もその分広げる
+			Vector3 expected = Transform(vector, MakeRotateMatrix(quaternion)) * 0.1f;
+			TEST_CHECK_MESSAGE(IsNear(RotateVector(vector, quaternion) * 0.1f, expected), "sample " + std::to_string(i));
+		}
+	}
+	TEST(Quaternion_RotateVectorMatchesMatrix);
+
+	void Quaternion_AffineMatrixMatchesChainedProduct()
+	{
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		for (int i = 0; i < kSampleCount; ++i) {
+			Vector3 scale = RandomScale(random);
+			Vector3 radian = random.Rotation();
+			Vector3 translate = random.Point();
+
+			// 拡縮 * X回転 * Y回転 * Z回転 * 平行移動 を掛け算で作ったもの(展開する前のMakeAffineMatrix)
+			Matrix4x4 rotate = Multiply(MakeRotateXMatrix(radian.x), Multiply(MakeRotateYMatrix(radian.y), MakeRotateZMatrix(radian.z)));
+			Matrix4x4 expected = Multiply(MakeScaleMatrix(scale), Multiply(rotate, MakeTranslateMatrix(translate)));
+			Matrix4x4 actual = MakeAffineMatrix(scale, radian, translate);
+			TEST_CHECK_MESSAGE(IsNear(actual, expected), "euler sample " + std::to_string(i));
+
+			// クォータニオン版も、回転行列を掛けたものと一致する
+			Quaternion quaternion = RandomQuaternion(random);
+			expected = Multiply(MakeScaleMatrix(scale), Multiply(MakeRotateMatrix(quaternion), MakeTranslateMatrix(translate)));
+			TEST_CHECK_MESSAGE(IsNear(MakeAffineMatrix(scale, quaternion, translate), expected), "quaternion sample " + std::to_string(i));
+		}
+	}
+	TEST(Quaternion_AffineMatrixMatchesChainedProduct);
+
+	void Quaternion_RotateAxisAngleNormalizesAxis()
+	{
+		// ロドリゲスの回転公式(行ベクトル形式)。軸は正規化してから使う
+		auto rodrigues = [](const Vector3& axis, float angle) {
+			Vector3 n = Normalize(axis);
+			float c = std::cos(angle);
+			float s = std::sin(angle);
+			float t = 1.0f - c;
+			Matrix4x4 result = MakeIdentity();
+			result.m[0][0] = c + n.x * n.x * t;
+			result.m[0][1] = n.x * n.y * t + n.z * s;
+			result.m[0][2] = n.x * n.z * t - n.y * s;
+			result.m[1][0] = n.x * n.y * t - n.z * s;
+			result.m[1][1] = c + n.y * n.y * t;
+			result.m[1][2] = n.y * n.z * t + n.x * s;
+			result.m[2][0] = n.x * n.z * t + n.y * s;
+			result.m[2][1] = n.y * n.z * t - n.x * s;
+			result.m[2][2] = c + n.z * n.z * t;
+			return result;
+		};
+
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		for (int i = 0; i < kSampleCount; ++i) {
+			// 長さが1でない軸をそのまま渡す
+			Vector3 axis = random.Point();
+			float angle = random.Range(-std::numbers::pi_v<float>, std::numbers::pi_v<float>);
+			TEST_CHECK_MESSAGE(IsNear(MakeRotateAxisAngle(axis, angle), rodrigues(axis, angle)), "sample " + std::to_string(i));
+		}
+	}
+	TEST(Quaternion_RotateAxisAngleNormalizesAxis);
+}
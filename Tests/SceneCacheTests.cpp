@@ -0,0 +1,227 @@
+#include "AABBTree.h"
+#include "RandomPrimitives.h"
+#include "SceneCache.h"
+#include "TestHarness.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+
+// WriteSceneCacheで書いたファイルをSceneCache::Openで読み戻せること、
+// 壊れたファイル(途中で切れている、ヘッダーやブロックの表がおかしい)はOpenが読み込まないことを確かめる
+
+using namespace Math;
+
+namespace
+{
+	constexpr uint32_t kSeed = 2024;
+	// AVXの幅でも割り切れない数にして、配列の間の詰め物も通す
+	constexpr int kCount = 37;
+
+	// ctestが命令セットごとの実行ファイルを同時に動かしてもぶつからないように、時刻を名前に入れる
+	std::filesystem::path MakeTempPath(const std::string& name)
+	{
+		static const std::string suffix = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+		return std::filesystem::temp_directory_path() / ("MathTests_" + name + "_" + suffix + ".scenecache");
+	}
+
+	std::vector<char> ReadFile(const std::filesystem::path& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		return { std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+	}
+
+	void WriteFile(const std::filesystem::path& path, const std::vector<char>& bytes)
+	{
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	bool IsSame(std::span<const float> actual, std::span<const float> expected)
+	{
+		return actual.size() == expected.size() && std::memcmp(actual.data(), expected.data(), expected.size_bytes()) == 0;
+	}
+
+	/// <summary>
+	/// すべての種類のブロックと木を持つシーン
+	/// </summary>
+	struct TestScene final
+	{
+		SphereBuffer spheres;
+		AABBBuffer aabbs;
+		OBBBuffer obbs;
+		PlaneBuffer planes;
+		TriangleBuffer triangles;
+		AABBTree tree;
+
+		TestScene()
+		{
+			Bench::RandomPrimitives random(kSeed, 20.0f);
+			std::vector<Sphere> sphereList;
+			std::vector<AABB> aabbList;
+			std::vector<OBB> obbList;
+			std::vector<Plane> planeList;
+			std::vector<Triangle> triangleList;
+			for (int i = 0; i < kCount; ++i) {
+				sphereList.push_back(random.MakeSphere());
+				aabbList.push_back(random.MakeAABB());
+				obbList.push_back(random.MakeOBB());
+				planeList.push_back(random.MakePlane());
+				triangleList.push_back(random.MakeTriangle());
+			}
+			spheres.Assign(sphereList);
+			aabbs.Assign(aabbList);
+			obbs.Assign(obbList);
+			planes.Assign(planeList);
+			triangles.Assign(triangleList);
+
+			// 空きリストもできるように一部を消す
+			std::vector<int32_t> proxies;
+			for (int i = 0; i < kCount; ++i) {
+				proxies.push_back(tree.CreateProxy(aabbList[i], static_cast<uint32_t>(i)));
+			}
+			for (int i = 0; i < kCount; i += 4) {
+				tree.DestroyProxy(proxies[i]);
+			}
+		}
+
+		bool Write(const std::filesystem::path& path) const
+		{
+			SceneCacheData data;
+			data.spheres = spheres.View();
+			data.aabbs = aabbs.View();
+			data.obbs = obbs.View();
+			data.planes = planes.View();
+			data.triangles = triangles.View();
+			data.broadPhase = &tree;
+			return WriteSceneCache(path, data);
+		}
+	};
+
+	void SceneCache_RoundTrip()
+	{
+		TestScene scene;
+		std::filesystem::path path = MakeTempPath("RoundTrip");
+		TEST_CHECK(scene.Write(path));
+
+		SceneCache cache;
+		TEST_CHECK(cache.Open(path));
+
+		SphereSoA spheres = cache.GetSpheres();
+		SphereSoA expectedSpheres = scene.spheres.View();
+		TEST_CHECK(IsSame(spheres.radius, expectedSpheres.radius));
+		AABBSoA aabbs = cache.GetAABBs();
+		AABBSoA expectedAABBs = scene.aabbs.View();
+		OBBSoA obbs = cache.GetOBBs();
+		OBBSoA expectedOBBs = scene.obbs.View();
+		PlaneSoA planes = cache.GetPlanes();
+		PlaneSoA expectedPlanes = scene.planes.View();
+		TEST_CHECK(IsSame(planes.distance, expectedPlanes.distance));
+		TriangleSoA triangles = cache.GetTriangles();
+		TriangleSoA expectedTriangles = scene.triangles.View();
+		for (int c = 0; c < 3; ++c) {
+			TEST_CHECK(IsSame(spheres.center[c], expectedSpheres.center[c]));
+			TEST_CHECK(IsSame(aabbs.min[c], expectedAABBs.min[c]) && IsSame(aabbs.max[c], expectedAABBs.max[c]));
+			TEST_CHECK(IsSame(obbs.center[c], expectedOBBs.center[c]) && IsSame(obbs.size[c], expectedOBBs.size[c]));
+			TEST_CHECK(IsSame(planes.normal[c], expectedPlanes.normal[c]));
+			for (int k = 0; k < 3; ++k) {
+				TEST_CHECK(IsSame(obbs.orientations[c][k], expectedOBBs.orientations[c][k]));
+				TEST_CHECK(IsSame(triangles.vertices[c][k], expectedTriangles.vertices[c][k]));
+			}
+		}
+
+		// 配列はキャッシュラインの境界から始まる
+		TEST_CHECK(reinterpret_cast<uintptr_t>(obbs.size[2].data()) % kSceneCacheAlignment == 0);
+
+		TEST_CHECK(cache.HasAABBTree());
+		AABBTree tree;
+		TEST_CHECK(cache.LoadAABBTree(tree));
+		TEST_CHECK(tree.GetRoot() == scene.tree.GetRoot() && tree.GetFreeList() == scene.tree.GetFreeList());
+		TEST_CHECK(tree.GetProxyCount() == scene.tree.GetProxyCount() && tree.GetMargin() == scene.tree.GetMargin());
+		TEST_CHECK(tree.GetNodes().size() == scene.tree.GetNodes().size() &&
+			std::memcmp(tree.GetNodes().data(), scene.tree.GetNodes().data(), scene.tree.GetNodes().size_bytes()) == 0);
+
+		cache.Close();
+		std::filesystem::remove(path);
+	}
+	TEST(SceneCache_RoundTrip);
+
+	void SceneCache_RejectsBrokenFiles()
+	{
+		TestScene scene;
+		std::filesystem::path validPath = MakeTempPath("Valid");
+		std::filesystem::path brokenPath = MakeTempPath("Broken");
+		TEST_CHECK(scene.Write(validPath));
+		const std::vector<char> valid = ReadFile(validPath);
+		TEST_CHECK(valid.size() > sizeof(SceneCacheHeader) + 6 * sizeof(SceneCacheBlock));
+
+		// validのコピーをbreakで壊して書き出し、Openが失敗するかを見る
+		auto isRejected = [&](const std::function<void(std::vector<char>&, SceneCacheHeader&, SceneCacheBlock*)>& breakFile)
+		{
+			std::vector<char> bytes = valid;
+			SceneCacheHeader header;
+			std::memcpy(&header, bytes.data(), sizeof(header));
+			std::vector<SceneCacheBlock> blocks(header.blockCount);
+			std::memcpy(blocks.data(), bytes.data() + sizeof(header), blocks.size() * sizeof(SceneCacheBlock));
+			breakFile(bytes, header, blocks.data());
+			if (bytes.size() >= sizeof(header) + blocks.size() * sizeof(SceneCacheBlock)) {
+				std::memcpy(bytes.data(), &header, sizeof(header));
+				std::memcpy(bytes.data() + sizeof(header), blocks.data(), blocks.size() * sizeof(SceneCacheBlock));
+			}
+			WriteFile(brokenPath, bytes);
+			SceneCache cache;
+			bool isOpened = cache.Open(brokenPath);
+			return !isOpened && !cache.IsOpen();
+		};
+
+		// 壊していなければ読める
+		TEST_CHECK(!isRejected([](std::vector<char>&, SceneCacheHeader&, SceneCacheBlock*) {}));
+
+		// 途中で切れている(ヘッダーの途中、ブロックの表の途中、中身の途中)
+		TEST_CHECK(isRejected([](std::vector<char>& bytes, SceneCacheHeader&, SceneCacheBlock*) { bytes.resize(sizeof(SceneCacheHeader) / 2); }));
+		TEST_CHECK(isRejected([](std::vector<char>& bytes, SceneCacheHeader&, SceneCacheBlock*) { bytes.resize(sizeof(SceneCacheHeader) + sizeof(SceneCacheBlock)); }));
+		TEST_CHECK(isRejected([](std::vector<char>& bytes, SceneCacheHeader&, SceneCacheBlock*) { bytes.resize(bytes.size() - kSceneCacheAlignment); }));
+		// 書いたときの大きさと合っていても、ブロックがはみ出していれば読まない
+		TEST_CHECK(isRejected([](std::vector<char>& bytes, SceneCacheHeader& header, SceneCacheBlock*) {
+			bytes.resize(bytes.size() - kSceneCacheAlignment);
+			header.fileSize = bytes.size();
+		}));
+
+		// マジック、バージョン、ヘッダーの大きさ
+		TEST_CHECK(isRejected([](std::vector<char>&, SceneCacheHeader& header, SceneCacheBlock*) { header.magic = 0x4D545343; }));
+		TEST_CHECK(isRejected([](std::vector<char>&, SceneCacheHeader& header, SceneCacheBlock*) { header.version = kSceneCacheVersion + 1; }));
+		TEST_CHECK(isRejected([](std::vector<char>&, SceneCacheHeader& header, SceneCacheBlock*) { header.headerSize = 0; }));
+		// ブロックの表がファイルに収まらない
+		TEST_CHECK(isRejected([](std::vector<char>&, SceneCacheHeader& header, SceneCacheBlock*) { header.blockCount = UINT32_MAX; }));
+
+		// 境界に揃っていない場所
+		TEST_CHECK(isRejected([](std::vector<char>&, SceneCacheHeader&, SceneCacheBlock* blocks) { blocks[1].offset += sizeof(float); }));
+
+		// 同じ種類のブロックが2つある
+		TEST_CHECK(isRejected([](std::vector<char>&, SceneCacheHeader&, SceneCacheBlock* blocks) { blocks[1].type = blocks[0].type; }));
+
+		// 要素の数や大きさがファイルからはみ出す
+		for (int i = 0; i < 6; ++i) {
+			TEST_CHECK_MESSAGE(isRejected([i](std::vector<char>&, SceneCacheHeader&, SceneCacheBlock* blocks) { blocks[i].count += 64; }), "count of block " + std::to_string(i));
+			TEST_CHECK_MESSAGE(isRejected([i](std::vector<char>&, SceneCacheHeader&, SceneCacheBlock* blocks) { blocks[i].count = UINT64_MAX / 2; }), "huge count of block " + std::to_string(i));
+			TEST_CHECK_MESSAGE(isRejected([i](std::vector<char>& bytes, SceneCacheHeader&, SceneCacheBlock* blocks) { blocks[i].size = bytes.size(); }), "size of block " + std::to_string(i));
+			TEST_CHECK_MESSAGE(isRejected([i](std::vector<char>& bytes, SceneCacheHeader&, SceneCacheBlock* blocks) { blocks[i].offset = bytes.size() + kSceneCacheAlignment; }), "offset of block " + std::to_string(i));
+		}
+
+		// 木のノードの構造体の大きさが違う
+		TEST_CHECK(isRejected([](std::vector<char>& bytes, SceneCacheHeader&, SceneCacheBlock* blocks) {
+			auto* treeHeader = reinterpret_cast<SceneCacheTreeHeader*>(bytes.data() + blocks[5].offset);
+			treeHeader->nodeSize += 4;
+		}));
+
+		std::filesystem::remove(validPath);
+		std::filesystem::remove(brokenPath);
+	}
+	TEST(SceneCache_RejectsBrokenFiles);
+}
@@ -0,0 +1,92 @@
+#include "BallWorld.h"
+#include "RandomPrimitives.h"
+#include "SpatialHashGrid.h"
+#include "TestHarness.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// スレッドプールを使ったグリッドの更新と組の検索が、単一スレッドのときと同じ結果になるかを確かめる
+// この環境のコア数によらず並列に分けるように、スレッド数は固定する
+
+using namespace Math;
+
+namespace
+{
+	constexpr uint32_t kSeed = 2024;
+	constexpr int kBallCount = 20000;
+	constexpr uint32_t kThreadCount = 4;
+
+	// ボールがほどよく重なる広さ
+	constexpr float kWorldHalfWidth = 20.0f;
+
+	void SpatialHashGrid_ParallelMatchesSerial()
+	{
+		Bench::RandomPrimitives random(kSeed, kWorldHalfWidth);
+		std::vector<float> positionX, positionY, positionZ, radius;
+		for (int i = 0; i < kBallCount; ++i) {
+			Vector3 p = random.Point();
+			positionX.push_back(p.x);
+			positionY.push_back(p.y);
+			positionZ.push_back(p.z);
+			radius.push_back(random.Range(0.2f, 0.5f));
+		}
+
+		ThreadPool threadPool(kThreadCount);
+		SpatialHashGrid serialGrid;
+		SpatialHashGrid parallelGrid;
+		std::vector<std::pair<uint32_t, uint32_t>> serialPairs;
+		std::vector<std::pair<uint32_t, uint32_t>> parallelPairs;
+		for (int frame = 0; frame < 3; ++frame) {
+			// 2フレーム目からはセルをまたぐボールがあり、並べ直しも通る
+			for (float& x : positionX) {
+				x += 0.3f;
+			}
+			serialGrid.Update(positionX, positionY, positionZ, radius);
+			parallelGrid.Update(positionX, positionY, positionZ, radius, &threadPool);
+			serialGrid.FindPairs(serialPairs);
+			parallelGrid.FindPairs(parallelPairs, &threadPool);
+			TEST_CHECK_MESSAGE(!serialPairs.empty() && parallelPairs == serialPairs,
+				"frame " + std::to_string(frame) + ": " + std::to_string(parallelPairs.size()) + " pairs (serial " + std::to_string(serialPairs.size()) + ")");
+		}
+	}
+	TEST(SpatialHashGrid_ParallelMatchesSerial);
+
+	void BallWorld_ParallelStepMatchesSerial()
+	{
+		ThreadPool threadPool(kThreadCount);
+		BallWorld serialWorld;
+		BallWorld parallelWorld(1.0f / 60.0f, &threadPool);
+		Bench::RandomPrimitives random(kSeed, kWorldHalfWidth);
+		for (BallWorld* world : { &serialWorld, &parallelWorld }) {
+			world->AddPlane({ { 0.0f, 1.0f, 0.0f }, -kWorldHalfWidth });
+		}
+		for (int i = 0; i < kBallCount; ++i) {
+			Ball ball{};
+			ball.position = random.Point();
+			ball.velocity = random.Direction() * random.Range(0.0f, 10.0f);
+			ball.mass = 1.0f;
+			ball.radius = random.Range(0.2f, 0.5f);
+			serialWorld.AddBall(ball);
+			parallelWorld.AddBall(ball);
+		}
+
+		for (int step = 0; step < 10; ++step) {
+			serialWorld.Step();
+			parallelWorld.Step();
+		}
+
+		// 組の順番が同じなら応答を足す順番も同じなので、ビット単位で一致する
+		int mismatchCount = 0;
+		for (uint32_t i = 0; i < serialWorld.GetBallCount(); ++i) {
+			bool isSame = serialWorld.GetPositionX()[i] == parallelWorld.GetPositionX()[i] &&
+				serialWorld.GetPositionY()[i] == parallelWorld.GetPositionY()[i] &&
+				serialWorld.GetPositionZ()[i] == parallelWorld.GetPositionZ()[i];
+			mismatchCount += isSame ? 0 : 1;
+		}
+		TEST_CHECK_MESSAGE(mismatchCount == 0, std::to_string(mismatchCount) + " balls differ");
+	}
+	TEST(BallWorld_ParallelStepMatchesSerial);
+}
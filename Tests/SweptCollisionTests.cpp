@@ -0,0 +1,197 @@
+#include "BallWorld.h"
+#include "MathFunction.h"
+#include "SweptCollision.h"
+#include "TestHarness.h"
+#include <cmath>
+#include <string>
+
+// SweepSphereの各オーバーロードについて、答えが分かっている配置で当たる時刻と法線を確かめる
+// 正面から当たる、辺や頂点をかすめる、動き始めから当たっている、面に平行に動く、外れる、の場合を調べる
+// BallWorldでは、1ステップで薄い箱を飛び越える速さのボールが箱で止まること、
+// 平面に対してはステップ開始時にいた側に押し戻されることを確かめる
+
+using namespace Math;
+
+namespace
+{
+	constexpr float kTolerance = 1e-5f;
+
+	bool IsNear(float a, float b)
+	{
+		return std::abs(a - b) <= kTolerance;
+	}
+
+	bool IsNear(const Vector3& a, const Vector3& b)
+	{
+		return IsNear(a.x, b.x) && IsNear(a.y, b.y) && IsNear(a.z, b.z);
+	}
+
+	std::string ToString(const Vector3& v)
+	{
+		return "(" + std::to_string(v.x) + ", " + std::to_string(v.y) + ", " + std::to_string(v.z) + ")";
+	}
+
+	template<typename Shape>
+	void CheckHit(const char* name, const Sphere& sphere, const Vector3& motion, const Shape& shape, float t, const Vector3& normal)
+	{
+		SweepHit hit{};
+		bool isHit = SweepSphere(sphere, motion, shape, hit);
+		TEST_CHECK_MESSAGE(isHit, std::string(name) + ": no hit");
+		if (!isHit) {
+			return;
+		}
+		TEST_CHECK_MESSAGE(IsNear(hit.t, t), std::string(name) + ": t " + std::to_string(hit.t));
+		TEST_CHECK_MESSAGE(IsNear(hit.normal, normal), std::string(name) + ": normal " + ToString(hit.normal));
+		// 当たった時刻の球の表面に当たった位置がある
+		Vector3 center = sphere.center + motion * hit.t;
+		TEST_CHECK_MESSAGE(IsNear(hit.point, center - normal * sphere.radius) || hit.t == 0.0f, std::string(name) + ": point " + ToString(hit.point));
+	}
+
+	template<typename Shape>
+	void CheckMiss(const char* name, const Sphere& sphere, const Vector3& motion, const Shape& shape)
+	{
+		SweepHit hit{};
+		TEST_CHECK_MESSAGE(!SweepSphere(sphere, motion, shape, hit), std::string(name) + ": hit at t " + std::to_string(hit.t));
+	}
+
+	void SweptCollision_Plane()
+	{
+		const Plane plane = { { 0.0f, 1.0f, 0.0f }, 0.0f };
+		CheckHit("head-on", Sphere{ { 0.0f, 5.0f, 0.0f }, 1.0f }, { 0.0f, -8.0f, 0.0f }, plane, 0.5f, { 0.0f, 1.0f, 0.0f });
+		// 裏側から来れば裏側の面で当たる
+		CheckHit("from behind", Sphere{ { 0.0f, -5.0f, 0.0f }, 1.0f }, { 0.0f, 8.0f, 0.0f }, plane, 0.5f, { 0.0f, -1.0f, 0.0f });
+		CheckHit("starting inside", Sphere{ { 0.0f, 0.5f, 0.0f }, 1.0f }, { 3.0f, 0.0f, 0.0f }, plane, 0.0f, { 0.0f, 1.0f, 0.0f });
+		CheckMiss("parallel", Sphere{ { 0.0f, 5.0f, 0.0f }, 1.0f }, { 8.0f, 0.0f, 0.0f }, plane);
+		CheckMiss("short", Sphere{ { 0.0f, 5.0f, 0.0f }, 1.0f }, { 0.0f, -3.0f, 0.0f }, plane);
+		CheckMiss("moving away", Sphere{ { 0.0f, 5.0f, 0.0f }, 1.0f }, { 0.0f, 8.0f, 0.0f }, plane);
+	}
+	TEST(SweptCollision_Plane);
+
+	void SweptCollision_AABB()
+	{
+		const AABB aabb = { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } };
+		const Vector3 down = { 0.0f, -8.0f, 0.0f };
+		CheckHit("head-on", Sphere{ { 0.0f, 5.0f, 0.0f }, 1.0f }, down, aabb, 0.375f, { 0.0f, 1.0f, 0.0f });
+
+		// 広げたAABBには0.375で入るが、辺の外側なので辺のカプセルで当たる(辺からの距離が(0.6, 0.8)になる時刻)
+		CheckHit("edge", Sphere{ { 1.6f, 5.0f, 0.0f }, 1.0f }, down, aabb, 0.4f, { 0.6f, 0.8f, 0.0f });
+		const float cornerHeight = std::sqrt(1.0f - 2.0f * 0.6f * 0.6f);
+		CheckHit("corner", Sphere{ { 1.6f, 5.0f, 1.6f }, 1.0f }, down, aabb, (4.0f - cornerHeight) / 8.0f, { 0.6f, cornerHeight, 0.6f });
+
+		// 面に平行に動いて側面に当たる(y方向の移動が0のスラブ)
+		CheckHit("parallel", Sphere{ { -5.0f, 0.5f, 0.0f }, 1.0f }, { 10.0f, 0.0f, 0.0f }, aabb, 0.3f, { -1.0f, 0.0f, 0.0f });
+		// 上面より高いところを平行に動くと、上の辺をかすめる
+		const float edgeDistance = std::sqrt(1.0f - 0.5f * 0.5f);
+		CheckHit("parallel edge", Sphere{ { -5.0f, 1.5f, 0.0f }, 1.0f }, { 10.0f, 0.0f, 0.0f }, aabb, (4.0f - edgeDistance) / 10.0f, { -edgeDistance, 0.5f, 0.0f });
+		CheckMiss("parallel above", Sphere{ { -5.0f, 2.5f, 0.0f }, 1.0f }, { 10.0f, 0.0f, 0.0f }, aabb);
+
+		CheckHit("starting inside", Sphere{ { 0.0f, 1.5f, 0.0f }, 1.0f }, down, aabb, 0.0f, { 0.0f, 1.0f, 0.0f });
+		CheckHit("center inside", Sphere{ { 0.0f, 0.0f, 0.0f }, 1.0f }, down, aabb, 0.0f, { 0.0f, 1.0f, 0.0f });
+
+		CheckMiss("beside", Sphere{ { 2.1f, 5.0f, 0.0f }, 1.0f }, down, aabb);
+		// 広げたAABBの角には入るが、元の角からは半径より遠い
+		CheckMiss("past corner", Sphere{ { 1.9f, 5.0f, 1.9f }, 1.0f }, down, aabb);
+		CheckMiss("short", Sphere{ { 0.0f, 5.0f, 0.0f }, 1.0f }, { 0.0f, -2.0f, 0.0f }, aabb);
+	}
+	TEST(SweptCollision_AABB);
+
+	void SweptCollision_OBB()
+	{
+		// z軸まわりに45度回した立方体。上の辺(z軸に平行)が高さ√2にある
+		const float c = std::sqrt(0.5f);
+		const OBB obb = { { 10.0f, 0.0f, 0.0f }, { { c, c, 0.0f }, { -c, c, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { 2.0f, 2.0f, 2.0f } };
+		const Vector3 down = { 0.0f, -8.0f, 0.0f };
+		const float edgeT = (5.0f - std::sqrt(2.0f) - 1.0f) / 8.0f;
+		CheckHit("edge", Sphere{ { 10.0f, 5.0f, 0.0f }, 1.0f }, down, obb, edgeT, { 0.0f, 1.0f, 0.0f });
+		CheckHit("cached edge", Sphere{ { 10.0f, 5.0f, 0.0f }, 1.0f }, down, MakeCachedOBB(obb), edgeT, { 0.0f, 1.0f, 0.0f });
+
+		// 斜めの面に法線の向きから当たる。面は中心から1の距離にある
+		const Vector3 faceNormal = { c, c, 0.0f };
+		const Vector3 start = obb.center + faceNormal * 6.0f;
+		CheckHit("face", Sphere{ start, 1.0f }, faceNormal * -8.0f, obb, 0.5f, faceNormal);
+
+		CheckHit("starting inside", Sphere{ obb.center + faceNormal * 1.5f, 1.0f }, down, obb, 0.0f, faceNormal);
+		CheckMiss("beside", Sphere{ { 10.0f + std::sqrt(2.0f) + 1.1f, 5.0f, 0.0f }, 1.0f }, down, obb);
+	}
+	TEST(SweptCollision_OBB);
+
+	void SweptCollision_Triangle()
+	{
+		// y = 0の平面上で、法線が+yを向く三角形
+		const Triangle triangle = { { { -1.0f, 0.0f, -1.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, -1.0f } } };
+		const Vector3 down = { 0.0f, -8.0f, 0.0f };
+		CheckHit("head-on", Sphere{ { 0.0f, 5.0f, 0.0f }, 1.0f }, down, triangle, 0.5f, { 0.0f, 1.0f, 0.0f });
+		CheckHit("from behind", Sphere{ { 0.0f, -5.0f, 0.0f }, 1.0f }, { 0.0f, 8.0f, 0.0f }, triangle, 0.5f, { 0.0f, -1.0f, 0.0f });
+
+		// 平面に当たる位置は三角形の外なので、辺と頂点で当たる
+		CheckHit("edge", Sphere{ { 0.0f, 5.0f, -1.6f }, 1.0f }, down, triangle, 0.525f, { 0.0f, 0.8f, -0.6f });
+		CheckHit("vertex", Sphere{ { 0.0f, 5.0f, 1.6f }, 1.0f }, down, triangle, 0.525f, { 0.0f, 0.8f, 0.6f });
+
+		// 平面に平行に動き、辺の延長上から頂点に当たる
+		const float vertexDistance = std::sqrt(1.0f - 0.5f * 0.5f);
+		CheckHit("parallel", Sphere{ { -5.0f, 0.5f, -1.0f }, 1.0f }, { 10.0f, 0.0f, 0.0f }, triangle,
+			(4.0f - vertexDistance) / 10.0f, { -vertexDistance, 0.5f, 0.0f });
+		CheckMiss("parallel above", Sphere{ { -5.0f, 1.5f, 0.0f }, 1.0f }, { 10.0f, 0.0f, 0.0f }, triangle);
+
+		CheckHit("starting inside", Sphere{ { 0.0f, 0.5f, 0.0f }, 1.0f }, down, triangle, 0.0f, { 0.0f, 1.0f, 0.0f });
+		CheckMiss("beside", Sphere{ { 0.0f, 5.0f, -2.1f }, 1.0f }, down, triangle);
+		CheckMiss("short", Sphere{ { 0.0f, 5.0f, 0.0f }, 1.0f }, { 0.0f, -3.0f, 0.0f }, triangle);
+
+		// 面積のない三角形には当たらない
+		const Triangle degenerate = { { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f } } };
+		CheckMiss("degenerate", Sphere{ { 1.0f, 5.0f, 0.0f }, 1.0f }, down, degenerate);
+	}
+	TEST(SweptCollision_Triangle);
+
+	void BallWorld_FastBallDoesNotTunnelThroughBox()
+	{
+		// 厚さ0.1の板に、1ステップで2進むボールを落とす。移動後の位置だけで判定すると板の下に抜ける
+		BallWorld world(1.0f / 60.0f);
+		world.SetGravity({ 0.0f, 0.0f, 0.0f });
+		world.AddBox({ { 0.0f, 0.0f, 0.0f }, { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { 10.0f, 0.1f, 10.0f } });
+		Ball ball{};
+		ball.position = { 0.0f, 1.0f, 0.0f };
+		ball.velocity = { 0.0f, -120.0f, 0.0f };
+		ball.mass = 1.0f;
+		ball.radius = 0.1f;
+		world.AddBall(ball);
+
+		world.Step();
+		Ball result = world.GetBall(0);
+		// 板の上面(0.05)に接する位置で止まり、反発係数の分だけ跳ね返る
+		TEST_CHECK_MESSAGE(IsNear(result.position.y, 0.15f), "y " + std::to_string(result.position.y));
+		TEST_CHECK_MESSAGE(IsNear(result.velocity.y, 96.0f), "velocity " + std::to_string(result.velocity.y));
+	}
+	TEST(BallWorld_FastBallDoesNotTunnelThroughBox);
+
+	void BallWorld_PlaneKeepsBallOnItsSide()
+	{
+		BallWorld world(1.0f / 60.0f);
+		world.SetGravity({ 0.0f, 0.0f, 0.0f });
+		world.AddPlane({ { 0.0f, 1.0f, 0.0f }, 0.0f });
+		Ball ball{};
+		ball.mass = 1.0f;
+		ball.radius = 0.5f;
+		// 平面の裏側から1ステップに1ずつ近づくボール
+		ball.position = { 0.0f, -5.0f, 0.0f };
+		ball.velocity = { 0.0f, 60.0f, 0.0f };
+		world.AddBall(ball);
+		// 表側から1ステップで平面を飛び越えるボール
+		ball.position = { 10.0f, 1.0f, 0.0f };
+		ball.velocity = { 0.0f, -180.0f, 0.0f };
+		world.AddBall(ball);
+
+		world.Step();
+		TEST_CHECK_MESSAGE(IsNear(world.GetBall(0).position.y, -4.0f), "behind: y " + std::to_string(world.GetBall(0).position.y));
+		TEST_CHECK_MESSAGE(IsNear(world.GetBall(1).position.y, 0.5f), "through: y " + std::to_string(world.GetBall(1).position.y));
+		TEST_CHECK(world.GetBall(1).velocity.y > 0.0f);
+
+		// 裏側のボールは裏面で跳ね返り、表側には出ない
+		for (int step = 0; step < 10; ++step) {
+			world.Step();
+			TEST_CHECK_MESSAGE(world.GetBall(0).position.y <= -0.5f, "behind at step " + std::to_string(step) + ": y " + std::to_string(world.GetBall(0).position.y));
+		}
+		TEST_CHECK(world.GetBall(0).velocity.y < 0.0f);
+	}
+	TEST(BallWorld_PlaneKeepsBallOnItsSide);
+}
@@ -0,0 +1,57 @@
+#include "TestHarness.h"
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace Test
+{
+	namespace
+	{
+		struct RegisteredTest final
+		{
+			std::string name;
+			Function function;
+		};
+
+		std::vector<RegisteredTest>& GetTests()
+		{
+			// 静的変数の初期化順に依存しないように関数の中に置く
+			static std::vector<RegisteredTest> tests;
+			return tests;
+		}
+
+		int failureCount = 0;
+	}
+
+	bool RegisterTest(const std::string& name, Function function)
+	{
+		GetTests().push_back({ name, std::move(function) });
+		return true;
+	}
+
+	void ReportFailure(const char* file, int line, const std::string& message)
+	{
+		std::printf("%s:%d: FAILED %s\n", file, line, message.c_str());
+		++failureCount;
+	}
+
+	int RunAllTests(int argc, char** argv)
+	{
+		std::string filter = argc > 1 ? argv[1] : "";
+		int runCount = 0;
+		int failedTestCount = 0;
+		for (const RegisteredTest& test : GetTests()) {
+			if (test.name.find(filter) == std::string::npos) {
+				continue;
+			}
+			int failuresBefore = failureCount;
+			test.function();
+			++runCount;
+			bool isPassed = failureCount == failuresBefore;
+			failedTestCount += isPassed ? 0 : 1;
+			std::printf("[%s] %s\n", isPassed ? "  OK  " : "FAILED", test.name.c_str());
+		}
+		std::printf("%d tests, %d failed\n", runCount, failedTestCount);
+		return failedTestCount == 0 ? 0 : 1;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <functional>
+#include <string>
+
+// 外部ライブラリなしでビルドできる小さなテストハーネス
+// BenchmarkHarness.hと同じく、関数をマクロで登録してmainからまとめて実行する
+namespace Test
+{
+	using Function = std::function<void()>;
+
+	// テストを登録する。戻り値は登録できたかどうか(静的変数の初期化に使う)
+	bool RegisterTest(const std::string& name, Function function);
+
+	// 失敗を記録する。テストは止めずに続け、最後にまとめて報告する
+	void ReportFailure(const char* file, int line, const std::string& message);
+
+	// 登録されたテストをすべて実行し、失敗がなければ0を返す
+	// 引数に文字列を渡すと、名前にその文字列を含むテストだけを実行する
+	int RunAllTests(int argc, char** argv);
+}
+
+#define TEST_CONCAT_IMPL(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_IMPL(a, b)
+
+// 関数をテストとして登録する。TEST(CollisionBatch_SphereSphere); のように関数の定義のあとに書く
+#define TEST(function) \
+	[[maybe_unused]] static const bool TEST_CONCAT(testRegistration_, __LINE__) = ::Test::RegisterTest(#function, function)
+
+// 条件がfalseなら失敗を記録する。messageはstd::stringにできるもの
+#define TEST_CHECK_MESSAGE(condition, message) \
+	do { \
+		if (!(condition)) { \
+			::Test::ReportFailure(__FILE__, __LINE__, std::string(#condition) + ": " + (message)); \
+		} \
+	} while (false)
+
+#define TEST_CHECK(condition) TEST_CHECK_MESSAGE(condition, "")
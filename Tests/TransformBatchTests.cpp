@@ -0,0 +1,120 @@
+#include "MathFunction.h"
+#include "RandomPrimitives.h"
+#include "TestHarness.h"
+#include "ThreadPool.h"
+#include "TransformBatch.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// TransformPointsの結果が、1点ずつTransform(Perspective)やTransformHomogeneous(Affine)で変換した結果とビット単位で一致するかを確かめる
+// AoSの4点ずつの並べ替えとSoAの命令セットの幅ずつの処理の両方について、
+// 幅で割り切れない数、結果をpointsと同じ配列に書く場合、スレッドプールで分割する場合を調べる
+
+using namespace Math;
+
+namespace
+{
+	constexpr uint32_t kSeed = 2024;
+	// 4でも8でも割り切れない数を含める。最後はスレッドプールで分割される数(kParallelThreshold以上)
+	constexpr size_t kCounts[] = { 0, 1, 3, 4, 7, 8, 13, 37, 40003 };
+
+	const char* ToString(TransformMode mode)
+	{
+		return mode == TransformMode::Perspective ? "perspective" : "affine";
+	}
+
+	// 透視投影を含む行列。点はカメラの前後に散らばるが、wがちょうど0になることはない
+	Matrix4x4 MakeMatrix(Bench::RandomPrimitives& random, TransformMode mode)
+	{
+		Matrix4x4 matrix = random.MakeAffineMatrix();
+		if (mode == TransformMode::Perspective) {
+			matrix = Multiply(matrix, MakePerspectiveFovMatrix(0.45f, 1.5f, 0.1f, 100.0f));
+		}
+		return matrix;
+	}
+
+	Vector3 TransformExpected(const Vector3& point, const Matrix4x4& matrix, TransformMode mode)
+	{
+		if (mode == TransformMode::Perspective) {
+			return Transform(point, matrix);
+		}
+		float result[4];
+		TransformHomogeneous(point, matrix, result);
+		return { result[0], result[1], result[2] };
+	}
+
+	bool IsSame(const Vector3& a, const Vector3& b)
+	{
+		return std::memcmp(&a, &b, sizeof(Vector3)) == 0;
+	}
+
+	// 一致しなかった点の数と最初の番号を報告する
+	void CheckPoints(const std::string& name, const std::vector<Vector3>& actual, const std::vector<Vector3>& expected)
+	{
+		int mismatchCount = 0;
+		size_t firstMismatch = 0;
+		for (size_t i = 0; i < expected.size(); ++i) {
+			if (!IsSame(actual[i], expected[i])) {
+				firstMismatch = mismatchCount == 0 ? i : firstMismatch;
+				++mismatchCount;
+			}
+		}
+		TEST_CHECK_MESSAGE(mismatchCount == 0, name + ": " + std::to_string(mismatchCount) + " of " + std::to_string(expected.size()) +
+			" points differ (first at " + std::to_string(firstMismatch) + ")");
+	}
+
+	void TransformBatch_MatchesTransform()
+	{
+		Bench::RandomPrimitives random(kSeed, 20.0f);
+		ThreadPool threadPool(4);
+		for (TransformMode mode : { TransformMode::Perspective, TransformMode::Affine }) {
+			const Matrix4x4 matrix = MakeMatrix(random, mode);
+			for (size_t count : kCounts) {
+				const std::string name = std::string(ToString(mode)) + " " + std::to_string(count);
+				std::vector<Vector3> points(count);
+				std::vector<Vector3> expected(count);
+				for (size_t i = 0; i < count; ++i) {
+					points[i] = random.Point();
+					expected[i] = TransformExpected(points[i], matrix, mode);
+				}
+
+				// AoS。結果の配列は点より長くてもよく、後ろは書き換えない
+				const Vector3 sentinel = { 1234.0f, 5678.0f, 9012.0f };
+				std::vector<Vector3> result(count + 1, sentinel);
+				TransformPoints(points, matrix, result, mode, &threadPool);
+				CheckPoints(name + " AoS", result, expected);
+				TEST_CHECK_MESSAGE(IsSame(result[count], sentinel), name + " AoS wrote past the end");
+
+				// AoSで同じ配列に書く
+				std::vector<Vector3> inPlace = points;
+				TransformPoints(inPlace, matrix, inPlace, mode, &threadPool);
+				CheckPoints(name + " AoS in place", inPlace, expected);
+
+				// SoA
+				std::vector<float> x(count), y(count), z(count);
+				for (size_t i = 0; i < count; ++i) {
+					x[i] = points[i].x;
+					y[i] = points[i].y;
+					z[i] = points[i].z;
+				}
+				std::vector<float> outX(count), outY(count), outZ(count);
+				TransformPoints(Vector3SoA{ x, y, z }, matrix, Vector3SoAOutput{ outX, outY, outZ }, mode, &threadPool);
+				std::vector<Vector3> soaResult(count);
+				for (size_t i = 0; i < count; ++i) {
+					soaResult[i] = { outX[i], outY[i], outZ[i] };
+				}
+				CheckPoints(name + " SoA", soaResult, expected);
+
+				// SoAで同じ配列に書く
+				TransformPoints(Vector3SoA{ x, y, z }, matrix, Vector3SoAOutput{ x, y, z }, mode, &threadPool);
+				for (size_t i = 0; i < count; ++i) {
+					soaResult[i] = { x[i], y[i], z[i] };
+				}
+				CheckPoints(name + " SoA in place", soaResult, expected);
+			}
+		}
+	}
+	TEST(TransformBatch_MatchesTransform);
+}
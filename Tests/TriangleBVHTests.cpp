@@ -0,0 +1,119 @@
+#include "RandomPrimitives.h"
+#include "TestHarness.h"
+#include "ThreadPool.h"
+#include "TriangleBVH.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// TriangleBVHのレイキャストが、すべての三角形をRayCast(const Ray&, const Triangle&, ...)で調べた結果と一致するかを確かめる
+// 格子に並んだ三角形と軸に平行なレイでは、始点がノードのAABBの面にちょうど乗る
+
+using namespace Math;
+
+namespace
+{
+	constexpr uint32_t kSeed = 2024;
+
+	// すべての三角形を調べて一番手前の交点を求める
+	RayHit BruteForceRayCast(const std::vector<Triangle>& triangles, const Ray& ray)
+	{
+		RayHit hit;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(triangles.size()); ++i) {
+			if (RayCast(ray, triangles[i], hit)) {
+				hit.triangleIndex = i;
+			}
+		}
+		return hit;
+	}
+
+	// RayCast、RayCastAny、RayCastBatchの結果をそれぞれ総当たりと比べ、違ったレイの数を報告する
+	// 同じ距離で当たる三角形が複数あるとどれを返すかは決まらないので、番号は距離が一致するかで確かめる
+	void CheckRayCasts(const std::string& name, const std::vector<Triangle>& triangles, const std::vector<Ray>& rays)
+	{
+		TriangleBVH bvh;
+		bvh.Build(triangles);
+		ThreadPool threadPool(4);
+		std::vector<RayHit> batchHits(rays.size());
+		bvh.RayCastBatch(rays, batchHits, FLT_MAX, &threadPool);
+
+		int mismatchCount = 0;
+		int firstMismatch = -1;
+		int hitCount = 0;
+		for (size_t i = 0; i < rays.size(); ++i) {
+			RayHit expected = BruteForceRayCast(triangles, rays[i]);
+			hitCount += expected.IsHit() ? 1 : 0;
+
+			RayHit hit;
+			bool isHit = bvh.RayCast(rays[i], hit);
+			bool isSame = isHit == expected.IsHit() && bvh.RayCastAny(rays[i]) == expected.IsHit();
+			for (const RayHit& actual : { hit, batchHits[i] }) {
+				if (actual.IsHit() != expected.IsHit()) {
+					isSame = false;
+				} else if (actual.IsHit()) {
+					RayHit check;
+					isSame = isSame && actual.t == expected.t && RayCast(rays[i], triangles[actual.triangleIndex], check) && check.t == actual.t;
+				}
+			}
+			if (!isSame) {
+				firstMismatch = mismatchCount == 0 ? static_cast<int>(i) : firstMismatch;
+				++mismatchCount;
+			}
+		}
+		TEST_CHECK_MESSAGE(mismatchCount == 0, name + ": " + std::to_string(mismatchCount) + " of " + std::to_string(rays.size()) +
+			" rays differ (first at " + std::to_string(firstMismatch) + ")");
+		TEST_CHECK_MESSAGE(0 < hitCount && hitCount < static_cast<int>(rays.size()), name + ": " + std::to_string(hitCount) + " hits");
+	}
+
+	void TriangleBVH_RandomTrianglesMatchBruteForce()
+	{
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		std::vector<Triangle> triangles;
+		for (int i = 0; i < 2000; ++i) {
+			triangles.push_back(random.MakeTriangle(2.0f));
+		}
+		std::vector<Ray> rays;
+		for (int i = 0; i < 2000; ++i) {
+			rays.push_back(random.MakeRay(30.0f));
+		}
+		CheckRayCasts("random", triangles, rays);
+	}
+	TEST(TriangleBVH_RandomTrianglesMatchBruteForce);
+
+	void TriangleBVH_AxisAlignedRaysOnGridMatchBruteForce()
+	{
+		// 整数の格子点に頂点を置いた高さマップ。高さも整数にして、水平なレイもAABBの面に乗るようにする
+		const int kGridSize = 24;
+		Bench::RandomPrimitives random(kSeed, 10.0f);
+		std::vector<float> heights((kGridSize + 1) * (kGridSize + 1));
+		for (float& height : heights) {
+			height = static_cast<float>(static_cast<int>(random.Range(0.0f, 3.999f)));
+		}
+		auto vertex = [&](int x, int z) { return Vector3{ static_cast<float>(x), heights[z * (kGridSize + 1) + x], static_cast<float>(z) }; };
+		std::vector<Triangle> triangles;
+		for (int z = 0; z < kGridSize; ++z) {
+			for (int x = 0; x < kGridSize; ++x) {
+				triangles.push_back({ { vertex(x, z), vertex(x + 1, z), vertex(x + 1, z + 1) } });
+				triangles.push_back({ { vertex(x, z), vertex(x + 1, z + 1), vertex(x, z + 1) } });
+			}
+		}
+
+		std::vector<Ray> rays;
+		for (int z = -1; z <= kGridSize + 1; ++z) {
+			for (int x = -1; x <= kGridSize + 1; ++x) {
+				// 格子の線の上と、セルの中を真下に向かうレイ
+				rays.push_back({ { static_cast<float>(x), 10.0f, static_cast<float>(z) }, { 0.0f, -20.0f, 0.0f } });
+				rays.push_back({ { x + 0.25f, 10.0f, z + 0.5f }, { 0.0f, -20.0f, 0.0f } });
+			}
+		}
+		for (int y = 0; y <= 3; ++y) {
+			for (int z = 0; z <= kGridSize; ++z) {
+				// 整数の高さでx軸、z軸に沿って進むレイ
+				rays.push_back({ { -1.0f, static_cast<float>(y), static_cast<float>(z) }, { static_cast<float>(kGridSize) + 2.0f, 0.0f, 0.0f } });
+				rays.push_back({ { static_cast<float>(z), static_cast<float>(y), -1.0f }, { 0.0f, 0.0f, static_cast<float>(kGridSize) + 2.0f } });
+			}
+		}
+		CheckRayCasts("grid", triangles, rays);
+	}
+	TEST(TriangleBVH_AxisAlignedRaysOnGridMatchBruteForce);
+}
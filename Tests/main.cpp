@@ -0,0 +1,20 @@
+#include "Simd.h"
+#include "TestHarness.h"
+#include <cstdio>
+
+// Mathライブラリのテスト
+// SIMDの実装はコンパイル時に選ぶので、命令セットごとに別の実行ファイルになる(Tests/CMakeLists.txt)
+// 使い方の例:
+//   MathTestsNative CollisionBatch
+int main(int argc, char** argv)
+{
+#if defined(MATH_SIMD_AVX2)
+	std::printf("math_simd: avx2\n");
+#elif defined(MATH_SIMD_SSE2)
+	std::printf("math_simd: sse2\n");
+#else
+	std::printf("math_simd: scalar\n");
+#endif
+
+	return Test::RunAllTests(argc, argv);
+}